@@ -0,0 +1,369 @@
+/*
+	Author: Tobias Wallner
+	tobias.wallner1@gmx.net
+
+	Exhaustive accuracy harness for the fix32 functions of fixmath and the conversions of fix32.
+	Sweeps all 2^32 inputs of every function on all cores and compares each result with a long double
+	reference. Build with CMAKE_BUILD_TYPE=Release.
+
+	Usage:
+		accuracy_fixmath [--format 8|16|24|28|all] [--function name] [--step k] [--threads n]
+
+		--format	the fractional bits of the fix32 format, default 16
+		--function	only sweeps the functions whose name contains name
+		--step		only checks every k-th input, for a quick run
+		--threads	the number of threads, default all cores
+
+	For every function it reports:
+		inputs		the number of checked inputs
+		skipped		inputs, whose exact result is not finite or not representable by the format
+		max ulp		the maximum error in units of the last place 2^-N of the result
+		mean ulp	the mean error
+		monotonic	the number of times the result decreases for an increasing input, for functions that
+					are monotonic, or '-'
+		M/s			checked inputs per second, including the reference
+		ns/call		time per call of the fixed-point function, including an indirect call
+	followed by the inputs with the largest errors of every function.
+
+	The harness is built with DISABLE_FIXPOINT_ASSERTIONS, so inputs, for which an intermediate result
+	overflows, show up as errors instead of exceptions.
+*/
+
+#define DISABLE_FIXPOINT_ASSERTIONS
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include "fix32.hpp"
+#include "fixmath.hpp"
+
+// ---------------- functions ----------------
+
+enum class monotonicity{none, increasing};
+
+struct function_entry{
+	std::string name;
+	size_t fractional_bits;
+	int32_t (*fixed)(int32_t raw);				// the fixed-point function on raw values
+	long double (*reference)(long double x);	// the exact result
+	monotonicity order;
+};
+
+template<size_t N, fix32<N> (*Function)(fix32<N>)>
+int32_t raw_call(int32_t raw){
+	return Function(fix32<N>::reinterpret(raw)).reinterpret_as_int32();
+}
+
+// conversions, that should return the input
+template<size_t N> fix32<N> via_float(fix32<N> x){return fix32<N>(static_cast<float>(x));}
+template<size_t N> fix32<N> via_double(fix32<N> x){return fix32<N>(static_cast<double>(x));}
+template<size_t N> fix32<N> via_chars(fix32<N> x){
+	char buffer[64];
+	const fix_to_chars_result written = to_chars(buffer, buffer + sizeof(buffer), x);
+	fix32<N> result = fix32<N>::reinterpret(0);
+	from_chars(buffer, written.ptr, result);
+	return result;
+}
+
+inline long double identity(long double x){return x;}
+inline long double exact_exp2(long double x){return std::exp2(x);}
+inline long double exact_exp(long double x){return std::exp(x);}
+inline long double exact_exp10(long double x){return std::pow(10.0L, x);}
+inline long double exact_expm1(long double x){return std::expm1(x);}
+inline long double exact_log2(long double x){return (x > 0) ? std::log2(x) : NAN;}
+inline long double exact_atan(long double x){return std::atan(x);}
+inline long double exact_tanh(long double x){return std::tanh(x);}
+inline long double exact_sigmoid(long double x){return 1 / (1 + std::exp(-x));}
+inline long double exact_gelu(long double x){return x / 2 * (1 + std::erf(x / std::sqrt(2.0L)));}
+inline long double exact_relu6(long double x){return (x < 0) ? 0 : (x > 6) ? 6 : x;}
+inline long double exact_floor(long double x){return std::floor(x);}
+inline long double exact_ceil(long double x){return std::ceil(x);}
+
+template<size_t N>
+std::vector<function_entry> functions(){
+	const monotonicity up = monotonicity::increasing;
+	std::vector<function_entry> list = {
+		{"exp2", N, &raw_call<N, &::exp2<N>>, &exact_exp2, up},
+		{"exp", N, &raw_call<N, &::exp<N>>, &exact_exp, up},
+		{"exp10", N, &raw_call<N, &::exp10<N>>, &exact_exp10, up},
+		{"expm1", N, &raw_call<N, &::expm1<N>>, &exact_expm1, up},
+		{"log2", N, &raw_call<N, &::log2<N>>, &exact_log2, up},
+		{"atan", N, &raw_call<N, &::atan<N>>, &exact_atan, up},
+		{"fast::exp2", N, &raw_call<N, &fixmath::fast::exp2<N>>, &exact_exp2, up},
+		{"fast::exp", N, &raw_call<N, &fixmath::fast::exp<N>>, &exact_exp, up},
+		{"fast::exp10", N, &raw_call<N, &fixmath::fast::exp10<N>>, &exact_exp10, up},
+		{"fast::log2", N, &raw_call<N, &fixmath::fast::log2<N>>, &exact_log2, up},
+		{"fast::atan", N, &raw_call<N, &fixmath::fast::atan<N>>, &exact_atan, up},
+		{"precise::exp2", N, &raw_call<N, &fixmath::precise::exp2<N>>, &exact_exp2, up},
+		{"precise::exp", N, &raw_call<N, &fixmath::precise::exp<N>>, &exact_exp, up},
+		{"precise::exp10", N, &raw_call<N, &fixmath::precise::exp10<N>>, &exact_exp10, up},
+		{"precise::log2", N, &raw_call<N, &fixmath::precise::log2<N>>, &exact_log2, up},
+		{"precise::atan", N, &raw_call<N, &fixmath::precise::atan<N>>, &exact_atan, up},
+		{"tanh", N, &raw_call<N, &::tanh<N>>, &exact_tanh, up},
+		{"sigmoid", N, &raw_call<N, &::sigmoid<N>>, &exact_sigmoid, up},
+		{"gelu", N, &raw_call<N, &::gelu<N>>, &exact_gelu, monotonicity::none},
+		{"floor", N, &raw_call<N, &::floor<N>>, &exact_floor, up},
+		{"ceil", N, &raw_call<N, &::ceil<N>>, &exact_ceil, up},
+		{"relu6", N, &raw_call<N, &::relu6<N>>, &exact_relu6, up},
+		{"float(x)", N, &raw_call<N, &via_float<N>>, &identity, up},
+		{"double(x)", N, &raw_call<N, &via_double<N>>, &identity, up},
+		{"to_chars/from_chars", N, &raw_call<N, &via_chars<N>>, &identity, up},
+	};
+	return list;
+}
+
+// ---------------- sweep ----------------
+
+struct worst_input{
+	int32_t raw;
+	int32_t result;
+	long double exact;
+	long double ulp;
+};
+
+static const size_t worst_count = 3;
+
+// keeps the worst_count inputs with the largest errors, largest first
+static void add_worst(std::vector<worst_input>& worst, const worst_input& candidate){
+	if(worst.size() == worst_count && candidate.ulp <= worst.back().ulp){
+		return;
+	}
+	worst.push_back(candidate);
+	std::sort(worst.begin(), worst.end(), [](const worst_input& a, const worst_input& b){return a.ulp > b.ulp;});
+	if(worst.size() > worst_count){
+		worst.pop_back();
+	}
+}
+
+// the results of a contiguous range of inputs
+struct chunk_result{
+	uint64_t count = 0;
+	uint64_t skipped = 0;
+	long double sum_ulp = 0;
+	std::vector<worst_input> worst;
+	uint64_t violations = 0;
+	int32_t first_violation = 0;
+	bool has_output = false;
+	int32_t first_input = 0;		// the input of first_output
+	int32_t first_output = 0;
+	int32_t last_output = 0;
+};
+
+static chunk_result sweep(const function_entry& f, int64_t first, int64_t last, int64_t step){
+	chunk_result r;
+	const long double scale = std::ldexp(1.0L, static_cast<int>(f.fractional_bits));
+	const long double lowest = static_cast<long double>(INT32_MIN) / scale;
+	const long double highest = static_cast<long double>(INT32_MAX) / scale;
+	for(int64_t k = first; k < last; ++k){
+		const int32_t raw = static_cast<int32_t>(static_cast<int64_t>(INT32_MIN) + k * step);
+		const long double exact = f.reference(static_cast<long double>(raw) / scale);
+		if(!(exact >= lowest && exact <= highest)){
+			++r.skipped;
+			continue;
+		}
+		const int32_t result = f.fixed(raw);
+		const long double ulp = std::fabs(static_cast<long double>(result) - exact * scale);
+		++r.count;
+		r.sum_ulp += ulp;
+		if(r.worst.size() < worst_count || ulp > r.worst.back().ulp){
+			add_worst(r.worst, worst_input{raw, result, exact, ulp});
+		}
+		if(f.order == monotonicity::increasing && r.has_output && result < r.last_output){
+			r.first_violation = (r.violations == 0) ? raw : r.first_violation;
+			++r.violations;
+		}
+		r.first_input = r.has_output ? r.first_input : raw;
+		r.first_output = r.has_output ? r.first_output : result;
+		r.has_output = true;
+		r.last_output = result;
+	}
+	return r;
+}
+
+struct settings{
+	std::vector<size_t> formats = {16};
+	std::string filter;
+	int64_t step = 1;
+	unsigned threads = 0;
+};
+
+struct function_report{
+	const function_entry* function;
+	chunk_result total;
+	double seconds;
+	double ns_per_call;
+};
+
+// time per call of the fixed-point function, over a sample of the inputs, that are not skipped
+static double time_per_call(const function_entry& f){
+	const long double scale = std::ldexp(1.0L, static_cast<int>(f.fractional_bits));
+	std::vector<int32_t> inputs;
+	for(int64_t k = 0; k < (1 << 16); ++k){
+		const int32_t raw = static_cast<int32_t>(static_cast<int64_t>(INT32_MIN) + k * (static_cast<int64_t>(1) << 16));
+		const long double exact = f.reference(static_cast<long double>(raw) / scale);
+		if(exact >= static_cast<long double>(INT32_MIN) / scale && exact <= static_cast<long double>(INT32_MAX) / scale){
+			inputs.push_back(raw);
+		}
+	}
+	if(inputs.empty()){
+		return 0;
+	}
+	int32_t accumulator = 0;
+	const auto start = std::chrono::steady_clock::now();
+	for(int repeat = 0; repeat < 16; ++repeat){
+		for(int32_t raw : inputs){
+			accumulator ^= f.fixed(raw);
+		}
+	}
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	static volatile int32_t sink = 0;
+	sink = sink ^ accumulator;
+	return seconds * 1e9 / (16.0 * static_cast<double>(inputs.size()));
+}
+
+static function_report run(const function_entry& f, const settings& config){
+	const int64_t inputs = ((static_cast<int64_t>(1) << 32) + config.step - 1) / config.step;
+	const int64_t chunk_size = 1 << 16;
+	const int64_t chunks = (inputs + chunk_size - 1) / chunk_size;
+	std::vector<chunk_result> results(static_cast<size_t>(chunks));
+	std::atomic<int64_t> next(0);
+
+	const auto start = std::chrono::steady_clock::now();
+	std::vector<std::thread> workers;
+	for(unsigned t = 0; t < config.threads; ++t){
+		workers.emplace_back([&](){
+			for(int64_t c = next++; c < chunks; c = next++){
+				const int64_t first = c * chunk_size;
+				const int64_t last = std::min(first + chunk_size, inputs);
+				results[static_cast<size_t>(c)] = sweep(f, first, last, config.step);
+			}
+		});
+	}
+	for(std::thread& worker : workers){
+		worker.join();
+	}
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	// merge in the order of the inputs, so that monotonicity is checked across the chunks too
+	function_report report{&f, chunk_result(), seconds, time_per_call(f)};
+	chunk_result& total = report.total;
+	for(const chunk_result& r : results){
+		total.count += r.count;
+		total.skipped += r.skipped;
+		total.sum_ulp += r.sum_ulp;
+		for(const worst_input& w : r.worst){
+			add_worst(total.worst, w);
+		}
+		// the boundary to the previous chunk comes before the violations inside the chunk
+		if(r.has_output && f.order == monotonicity::increasing && total.has_output && r.first_output < total.last_output){
+			total.first_violation = (total.violations == 0) ? r.first_input : total.first_violation;
+			++total.violations;
+		}
+		if(r.violations > 0 && total.violations == 0){
+			total.first_violation = r.first_violation;
+		}
+		total.violations += r.violations;
+		if(r.has_output){
+			total.has_output = true;
+			total.last_output = r.last_output;
+		}
+	}
+	return report;
+}
+
+// ---------------- report ----------------
+
+static std::string format_name(size_t fractional_bits){
+	return "fix32<" + std::to_string(fractional_bits) + ">";
+}
+
+static void print_header(){
+	std::cout << std::left << std::setw(22) << "function" << std::setw(11) << "format" << std::right
+		<< std::setw(12) << "inputs" << std::setw(12) << "skipped" << std::setw(12) << "max ulp" << std::setw(12) << "mean ulp"
+		<< std::setw(11) << "monotonic" << std::setw(9) << "M/s" << std::setw(9) << "ns/call" << std::endl;
+}
+
+static void print_report(const function_report& r){
+	const chunk_result& t = r.total;
+	const double max_ulp = t.worst.empty() ? 0 : static_cast<double>(t.worst.front().ulp);
+	const double mean_ulp = (t.count == 0) ? 0 : static_cast<double>(t.sum_ulp / t.count);
+	std::cout << std::left << std::setw(22) << r.function->name << std::setw(11) << format_name(r.function->fractional_bits) << std::right
+		<< std::setw(12) << t.count << std::setw(12) << t.skipped
+		<< std::setprecision(4) << std::setw(12) << max_ulp << std::setw(12) << mean_ulp
+		<< std::setw(11) << ((r.function->order == monotonicity::none) ? std::string("-") : std::to_string(t.violations))
+		<< std::fixed << std::setprecision(1) << std::setw(9) << static_cast<double>(t.count + t.skipped) / r.seconds * 1e-6
+		<< std::setprecision(2) << std::setw(9) << r.ns_per_call << std::endl;
+}
+
+static void print_worst(const function_report& r){
+	const double scale = std::ldexp(1.0, -static_cast<int>(r.function->fractional_bits));
+	std::cout << r.function->name << " " << format_name(r.function->fractional_bits) << ":";
+	for(const worst_input& w : r.total.worst){
+		std::cout << "  x=" << std::setprecision(9) << std::defaultfloat << w.raw * scale
+			<< " result=" << w.result * scale << " exact=" << static_cast<double>(w.exact)
+			<< " ulp=" << std::setprecision(3) << static_cast<double>(w.ulp);
+	}
+	if(r.total.violations > 0){
+		std::cout << "  first monotonicity violation at x=" << std::setprecision(9) << r.total.first_violation * scale;
+	}
+	std::cout << std::endl;
+}
+
+int main(int argc, char** argv){
+	settings config;
+	config.threads = std::max(1u, std::thread::hardware_concurrency());
+	for(int i = 1; i + 1 < argc; i += 2){
+		const std::string option = argv[i];
+		const std::string value = argv[i + 1];
+		if(option == "--format"){
+			config.formats = (value == "all") ? std::vector<size_t>{8, 16, 24, 28} : std::vector<size_t>{static_cast<size_t>(std::atoi(value.c_str()))};
+		}else if(option == "--function"){
+			config.filter = value;
+		}else if(option == "--step"){
+			config.step = std::max(1LL, std::atoll(value.c_str()));
+		}else if(option == "--threads"){
+			config.threads = static_cast<unsigned>(std::max(1, std::atoi(value.c_str())));
+		}
+	}
+	if(argc % 2 == 0){
+		std::cerr << "usage: accuracy_fixmath [--format 8|16|24|28|all] [--function name] [--step k] [--threads n]" << std::endl;
+		return 1;
+	}
+
+	std::vector<function_entry> list;
+	for(size_t format : config.formats){
+		std::vector<function_entry> f = (format == 8) ? functions<8>() : (format == 16) ? functions<16>()
+			: (format == 24) ? functions<24>() : (format == 28) ? functions<28>() : std::vector<function_entry>();
+		if(f.empty()){
+			std::cerr << "unsupported format " << format << ", use 8, 16, 24 or 28" << std::endl;
+			return 1;
+		}
+		list.insert(list.end(), f.begin(), f.end());
+	}
+
+	std::cout << "accuracy of fix32 functions against long double, every " << config.step << ". input, "
+		<< config.threads << " threads" << std::endl;
+	print_header();
+	std::vector<function_report> reports;
+	for(const function_entry& f : list){
+		if(f.name.find(config.filter) == std::string::npos){
+			continue;
+		}
+		reports.push_back(run(f, config));
+		print_report(reports.back());
+	}
+
+	std::cout << std::endl << "largest errors:" << std::endl;
+	for(const function_report& r : reports){
+		print_worst(r);
+	}
+	return 0;
+}
@@ -0,0 +1,136 @@
+/*
+	Author: Tobias Wallner
+	tobias.wallner1@gmx.net
+
+	Build-time benchmark of the explicit instantiations in fixinstances.hpp.
+
+	Generates translation units, that use the operators, conversions and math functions of the common
+	formats, and compiles each of them with the compiler of the build, once including fixmath.hpp and
+	once including fixinstances.hpp. Reports the compile time per translation unit (best of the repeats)
+	and the size of the object files, without and with optimization.
+
+	Usage:
+		bench_build [--units n] [--repeat n] [--compiler path] [--directory path]
+
+		--units		the number of generated translation units, default 8
+		--repeat	the number of times each one is compiled, default 3
+		--compiler	the C++ compiler, default the one of the build
+		--directory	where the translation units are written, default the working directory
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+
+#ifndef FIXPOINT_CXX_COMPILER
+	#define FIXPOINT_CXX_COMPILER "c++"
+#endif
+#ifndef FIXPOINT_SOURCE_DIR
+	#define FIXPOINT_SOURCE_DIR "."
+#endif
+
+struct settings{
+	int units = 8;
+	int repeat = 3;
+	std::string compiler = FIXPOINT_CXX_COMPILER;
+	std::string directory = ".";
+};
+
+// a translation unit, that uses the formats the way an application does, i is part of the names
+static std::string translation_unit(const std::string& header, int i){
+	std::ostringstream s;
+	s << "#include \"" << header << "\"\n"
+		<< "#include <iostream>\n"
+		<< "using q8 = fix32<8>; using q16 = fix32<16>; using q24 = fix32<24>; using q30 = fix32<30>;\n"
+		<< "using d16 = fix64<16>; using d32 = fix64<32>; using d48 = fix64<48>; using d62 = fix64<62>;\n"
+		<< "q16 unit" << i << "_filter(const q16* x, q16* y, int n, q16 gain){\n"
+		<< "	q16 state = 0;\n"
+		<< "	for(int k = 0; k < n; ++k){state = lerp(state, x[k] * gain, q16(0.125)); y[k] = state;}\n"
+		<< "	return state;\n"
+		<< "}\n"
+		<< "q24 unit" << i << "_math(q24 x){\n"
+		<< "	return exp2(x) + log2(abs(x) + 1) + fixmath::fast::exp(x) + fixmath::precise::atan(x) + tanh(x) + sigmoid(x) + gelu(x);\n"
+		<< "}\n"
+		<< "q8 unit" << i << "_small(q8 x){return floor(exp10(x)) + ceil(atan2(x, q8(2))) + relu6(x);}\n"
+		<< "q30 unit" << i << "_unit(q30 x){return fixmath::balanced::exp2(x) - expm1(x) + min(x, q30(0.5));}\n"
+		<< "d32 unit" << i << "_wide(d32 x, d32 y){\n"
+		<< "	const polar_coordinates<d32> p = polar(x, y);\n"
+		<< "	return p.magnitude * exp(x / 4) + fixmath::precise::log2(abs(y) + 1) + mod(x, y) + static_cast<d32>(static_cast<double>(x));\n"
+		<< "}\n"
+		<< "d16 unit" << i << "_d16(d16 x){return exp2(x) + atan(x) + d16(3) / x;}\n"
+		<< "d48 unit" << i << "_d48(d48 x){return fixmath::fast::log2(x) + round_up(x) + exp10(x);}\n"
+		<< "d62 unit" << i << "_d62(d62 x){return max(exp2(x), x * x) + lerp(x, d62(0.5), d62(0.25));}\n"
+		<< "void unit" << i << "_activations(const q16* x, q16* y, int n){tanh(x, x + n, y); softmax(y, y + n, y);}\n"
+		<< "void unit" << i << "_print(std::ostream& stream, q16 a, d32 b){stream << a << ' ' << b << std::endl;}\n";
+	return s.str();
+}
+
+static double compile_seconds(const settings& config, const std::string& source, const std::string& flags, const std::string& object){
+	const std::string command = config.compiler + " -std=c++14 " + flags + " -I\"" FIXPOINT_SOURCE_DIR "\" -c \"" + source + "\" -o \"" + object + "\"";
+	const auto start = std::chrono::steady_clock::now();
+	if(std::system(command.c_str()) != 0){
+		std::cerr << "failed: " << command << std::endl;
+		std::exit(1);
+	}
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static long file_size(const std::string& path){
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	return static_cast<long>(file.tellg());
+}
+
+int main(int argc, char** argv){
+	settings config;
+	for(int i = 1; i + 1 < argc; i += 2){
+		const std::string option = argv[i];
+		const std::string value = argv[i + 1];
+		if(option == "--units"){
+			config.units = std::max(1, std::atoi(value.c_str()));
+		}else if(option == "--repeat"){
+			config.repeat = std::max(1, std::atoi(value.c_str()));
+		}else if(option == "--compiler"){
+			config.compiler = value;
+		}else if(option == "--directory"){
+			config.directory = value;
+		}
+	}
+	if(argc % 2 == 0){
+		std::cerr << "usage: bench_build [--units n] [--repeat n] [--compiler path] [--directory path]" << std::endl;
+		return 1;
+	}
+
+	const std::vector<std::string> headers = {"fixmath.hpp", "fixinstances.hpp"};
+	const std::vector<std::string> flags = {"-O0", "-O2"};
+
+	std::cout << "compile time of " << config.units << " translation units with " << config.compiler << ", best of " << config.repeat << std::endl;
+	std::cout << std::left << std::setw(20) << "header" << std::setw(8) << "flags" << std::right
+		<< std::setw(14) << "s per unit" << std::setw(14) << "s total" << std::setw(16) << "object bytes" << std::endl;
+	for(const std::string& flag : flags){
+		for(const std::string& header : headers){
+			double total = 0;
+			long bytes = 0;
+			for(int i = 0; i < config.units; ++i){
+				const std::string name = config.directory + "/bench_build_" + header.substr(0, header.find('.')) + "_" + std::to_string(i);
+				std::ofstream(name + ".cpp") << translation_unit(header, i);
+				double best = 1e30;
+				for(int r = 0; r < config.repeat; ++r){
+					best = std::min(best, compile_seconds(config, name + ".cpp", flag, name + ".o"));
+				}
+				total += best;
+				bytes += file_size(name + ".o");
+				std::remove((name + ".cpp").c_str());
+				std::remove((name + ".o").c_str());
+			}
+			std::cout << std::left << std::setw(20) << header << std::setw(8) << flag << std::right << std::fixed << std::setprecision(3)
+				<< std::setw(14) << total / config.units << std::setw(14) << total << std::setw(16) << bytes / config.units << std::endl;
+		}
+	}
+	return 0;
+}
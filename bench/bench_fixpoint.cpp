@@ -0,0 +1,587 @@
+/*
+	Author: Tobias Wallner
+	tobias.wallner1@gmx.net
+
+	Measures the latency and the throughput of the operators, conversions, text functions and
+	fixmath functions of fix32 and fix64 for several fractional bits, next to float, double and
+	integer baselines, and writes the results as JSON. Build with CMAKE_BUILD_TYPE=Release.
+
+	Usage:
+		bench_fixpoint [--quick] [--filter text] [output.json]
+
+		--quick		shorter measurements, for a smoke test
+		--filter	only runs the measurements whose group, operation or type contains text
+		output.json	writes the results to a file instead of stdout
+
+	latency_ns:		time per operation, if every operation depends on the result of the previous one.
+					The dependency costs an extra 'and' and 'or' per operation, which is measured by the
+					operation 'chain' of the group 'overhead' for every type.
+	throughput_ns:	time per operation, if the operations are independent, over an array in the L1 cache.
+*/
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <random>
+#include <limits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <streambuf>
+#include "fix32.hpp"
+#include "fix64.hpp"
+#include "fixmath.hpp"
+
+// ---------------- measurement ----------------
+
+// always 0, but unknown to the compiler, so that it cannot remove the dependency between operations
+static volatile uint64_t chain_mask = 0;
+
+// prevents the compiler from removing the benchmarked calculations
+static volatile uint64_t sink;
+
+template<class T>
+uint64_t to_bits(const T& value){
+	uint64_t bits = 0;
+	std::memcpy(&bits, &value, (sizeof(T) < sizeof(bits)) ? sizeof(T) : sizeof(bits));
+	return bits;
+}
+
+template<size_t N>
+uint64_t to_bits(const fix32<N>& value){
+	return static_cast<uint32_t>(value.reinterpret_as_int32());
+}
+
+template<size_t N>
+uint64_t to_bits(const fix64<N>& value){
+	return static_cast<uint64_t>(value.reinterpret_as_int64());
+}
+
+// ors bits into the representation of value
+template<class T>
+T with_bits(T value, uint64_t bits){
+	uint64_t raw = to_bits(value) | bits;
+	std::memcpy(&value, &raw, (sizeof(T) < sizeof(raw)) ? sizeof(T) : sizeof(raw));
+	return value;
+}
+
+template<size_t N>
+fix32<N> with_bits(fix32<N> value, uint64_t bits){
+	return fix32<N>::reinterpret(static_cast<int32_t>(static_cast<uint32_t>(to_bits(value) | bits)));
+}
+
+template<size_t N>
+fix64<N> with_bits(fix64<N> value, uint64_t bits){
+	return fix64<N>::reinterpret(static_cast<int64_t>(to_bits(value) | bits));
+}
+
+// forces the compiler to write all results to memory
+template<class T>
+void keep(const T* data){
+#if defined(__GNUC__)
+	asm volatile("" : : "g"(data) : "memory");
+#else
+	sink = to_bits(*data);
+#endif
+}
+
+struct measurement{
+	std::string group;
+	std::string operation;
+	std::string type;
+	double latency_ns;
+	double throughput_ns;
+};
+
+struct settings{
+	double sample_seconds = 2e-3;
+	std::string filter;
+};
+
+static settings config;
+static std::vector<measurement> results;
+
+// best time of 3 samples per operation in nanoseconds, run(passes) executes passes * operations operations
+template<class Run>
+double ns_per_operation(size_t operations, Run&& run){
+	using clock = std::chrono::steady_clock;
+	size_t passes = 1;
+	for(;;){
+		const auto start = clock::now();
+		run(passes);
+		const double seconds = std::chrono::duration<double>(clock::now() - start).count();
+		if(seconds >= config.sample_seconds || passes >= (static_cast<size_t>(1) << 30)){
+			break;
+		}
+		passes *= 2;
+	}
+	double best = std::numeric_limits<double>::infinity();
+	for(int sample = 0; sample < 3; ++sample){
+		const auto start = clock::now();
+		run(passes);
+		const double seconds = std::chrono::duration<double>(clock::now() - start).count();
+		best = (seconds < best) ? seconds : best;
+	}
+	return best * 1e9 / static_cast<double>(passes * operations);
+}
+
+static bool selected(const std::string& group, const std::string& operation, const std::string& type){
+	return config.filter.empty() || group.find(config.filter) != std::string::npos
+		|| operation.find(config.filter) != std::string::npos || type.find(config.filter) != std::string::npos;
+}
+
+/*
+	Measures function(a[i], b[i]) over the arrays a and b. Unary functions ignore b.
+	The latency chains the result into the next a[i], without changing its value.
+*/
+template<class A, class B, class Function>
+void bench(const std::string& group, const std::string& operation, const std::string& type, const std::vector<A>& a, const std::vector<B>& b, Function function){
+	if(!selected(group, operation, type)){
+		return;
+	}
+	using Result = decltype(function(a[0], b[0]));
+	const size_t n = a.size();
+	std::vector<Result> out(n);
+
+	const double throughput = ns_per_operation(n, [&](size_t passes){
+		for(size_t pass = 0; pass < passes; ++pass){
+			for(size_t i = 0; i < n; ++i){
+				out[i] = function(a[i], b[i]);
+			}
+			keep(out.data());
+		}
+	});
+
+	const double latency = ns_per_operation(n, [&](size_t passes){
+		const uint64_t mask = chain_mask;
+		uint64_t previous = 0;
+		for(size_t pass = 0; pass < passes; ++pass){
+			for(size_t i = 0; i < n; ++i){
+				previous = to_bits(function(with_bits(a[i], previous & mask), b[i]));
+			}
+		}
+		sink = previous;
+	});
+
+	results.push_back(measurement{group, operation, type, latency, throughput});
+	std::cerr << std::left << std::setw(12) << group << std::setw(22) << operation << std::setw(12) << type
+		<< std::right << std::fixed << std::setprecision(2) << std::setw(10) << latency << std::setw(10) << throughput << std::endl;
+}
+
+static void write_json(std::ostream& stream){
+	stream << "{\n";
+	stream << "\t\"benchmark\": \"bench_fixpoint\",\n";
+#if defined(__VERSION__)
+	stream << "\t\"compiler\": \"" << __VERSION__ << "\",\n";
+#endif
+#if defined(__OPTIMIZE__)
+	stream << "\t\"optimized\": true,\n";
+#else
+	stream << "\t\"optimized\": false,\n";
+#endif
+#if defined(DISABLE_FIXPOINT_ASSERTIONS)
+	stream << "\t\"assertions\": false,\n";
+#else
+	stream << "\t\"assertions\": true,\n";
+#endif
+	stream << "\t\"unit\": \"ns\",\n";
+	stream << "\t\"results\": [\n";
+	for(size_t i = 0; i < results.size(); ++i){
+		const measurement& m = results[i];
+		stream << "\t\t{\"group\": \"" << m.group << "\", \"operation\": \"" << m.operation << "\", \"type\": \"" << m.type
+			<< "\", \"latency_ns\": " << std::fixed << std::setprecision(3) << m.latency_ns
+			<< ", \"throughput_ns\": " << m.throughput_ns << "}" << ((i + 1 < results.size()) ? "," : "") << "\n";
+	}
+	stream << "\t]\n";
+	stream << "}\n";
+}
+
+// ---------------- types and inputs ----------------
+
+template<size_t N> std::string type_name(fix32<N>){return "fix32<" + std::to_string(N) + ">";}
+template<size_t N> std::string type_name(fix64<N>){return "fix64<" + std::to_string(N) + ">";}
+inline std::string type_name(float){return "float";}
+inline std::string type_name(double){return "double";}
+inline std::string type_name(int32_t){return "int32_t";}
+inline std::string type_name(int64_t){return "int64_t";}
+
+template<size_t N> int32_t to_integer(fix32<N> f){return f.static_cast_to_int32_t();}
+template<size_t N> int64_t to_integer(fix64<N> f){return f.static_cast_to_int64_t();}
+
+static const size_t array_size = 1024;
+
+// uniformly distributed in [low, high)
+static std::vector<double> random_values(double low, double high, unsigned seed){
+	std::mt19937_64 random(seed);
+	std::uniform_real_distribution<double> distribution(low, high);
+	std::vector<double> values(array_size);
+	for(double& v : values){
+		v = distribution(random);
+	}
+	return values;
+}
+
+// magnitudes in [0.5, 4) with random signs, so that products and quotients fit into every format
+static std::vector<double> operands(unsigned seed){
+	std::vector<double> values = random_values(0.5, 4.0, seed);
+	for(size_t i = 0; i < values.size(); ++i){
+		values[i] = ((i * 2654435761u) & 0x100) ? -values[i] : values[i];
+	}
+	return values;
+}
+
+template<class T>
+std::vector<T> convert(const std::vector<double>& values){
+	std::vector<T> result;
+	for(double v : values){
+		result.push_back(static_cast<T>(v));
+	}
+	return result;
+}
+
+template<class Fix>
+std::vector<Fix> convert_fix(const std::vector<double>& values){
+	std::vector<Fix> result;
+	for(double v : values){
+		result.push_back(Fix(v));
+	}
+	return result;
+}
+
+// fixed-width, zero terminated strings of the numbers
+class string_table{
+	static const size_t width = 32;
+	std::vector<char> storage;
+public:
+	std::vector<const char*> strings;
+
+	explicit string_table(const std::vector<double>& values) : storage(values.size() * width, '\0'){
+		for(size_t i = 0; i < values.size(); ++i){
+			std::snprintf(&storage[i * width], width, "%.6f", values[i]);
+		}
+		for(size_t i = 0; i < values.size(); ++i){
+			strings.push_back(&storage[i * width]);
+		}
+	}
+};
+
+// stream buffers on fixed memory, so that the text measurements do not allocate
+class char_sink : public std::streambuf{
+	char buffer[64];
+public:
+	char_sink(){this->reset();}
+	void reset(){this->setp(this->buffer, this->buffer + sizeof(this->buffer));}
+	size_t size() const {return static_cast<size_t>(this->pptr() - this->pbase());}
+};
+
+class char_source : public std::streambuf{
+public:
+	void set(const char* str){
+		char* first = const_cast<char*>(str);
+		this->setg(first, first, first + std::strlen(str));
+	}
+};
+
+// ---------------- operators ----------------
+
+template<class T>
+void bench_operators(const std::vector<T>& a, const std::vector<T>& b){
+	const std::string type = type_name(T());
+	bench("overhead", "chain", type, a, b, [](T x, T){return x;});
+	bench("operator", "add", type, a, b, [](T x, T y){return x + y;});
+	bench("operator", "sub", type, a, b, [](T x, T y){return x - y;});
+	bench("operator", "mul", type, a, b, [](T x, T y){return x * y;});
+	bench("operator", "div", type, a, b, [](T x, T y){return x / y;});
+	bench("operator", "neg", type, a, b, [](T x, T){return -x;});
+	bench("operator", "less", type, a, b, [](T x, T y){return static_cast<int>(x < y);});
+	bench("operator", "equal", type, a, b, [](T x, T y){return static_cast<int>(x == y);});
+}
+
+template<class Fix>
+void bench_fix_operators(){
+	const std::vector<Fix> a = convert_fix<Fix>(operands(1));
+	const std::vector<Fix> b = convert_fix<Fix>(operands(2));
+	const std::vector<int32_t> integers = convert<int32_t>(random_values(1, 8, 3));
+	const std::string type = type_name(Fix());
+	bench_operators(a, b);
+	bench("operator", "mod", type, a, b, [](Fix x, Fix y){return x % y;});
+	bench("operator", "mul_int", type, a, integers, [](Fix x, int32_t y){return x * y;});
+	bench("operator", "div_int", type, a, integers, [](Fix x, int32_t y){return x / y;});
+}
+
+template<class Float>
+void bench_float_operators(){
+	const std::vector<Float> a = convert<Float>(operands(1));
+	const std::vector<Float> b = convert<Float>(operands(2));
+	bench_operators(a, b);
+	bench("operator", "mod", type_name(Float()), a, b, [](Float x, Float y){return std::fmod(x, y);});
+}
+
+template<class Integer>
+void bench_integer_operators(){
+	// scaled like a fixed-point number with 8 fractional bits
+	const std::vector<Integer> a = convert<Integer>(random_values(-1024, 1024, 1));
+	std::vector<Integer> b = convert<Integer>(random_values(128, 1024, 2));
+	bench_operators(a, b);
+	bench("operator", "mod", type_name(Integer()), a, b, [](Integer x, Integer y){return x % y;});
+}
+
+// ---------------- conversions ----------------
+
+template<class Fix>
+void bench_fix_conversions(){
+	const std::string type = type_name(Fix());
+	const std::vector<double> values = operands(4);
+	const std::vector<int32_t> integers = convert<int32_t>(random_values(-100, 100, 5));
+	const std::vector<float> floats = convert<float>(values);
+	const std::vector<Fix> fixes = convert_fix<Fix>(values);
+	const string_table table(values);
+
+	bench("convert", "from_int", type, integers, integers, [](int32_t x, int32_t){return Fix(x);});
+	bench("convert", "from_float", type, floats, floats, [](float x, float){return Fix(x);});
+	bench("convert", "from_double", type, values, values, [](double x, double){return Fix(x);});
+	bench("convert", "from_string", type, table.strings, table.strings, [](const char* x, const char*){return Fix(x);});
+	bench("convert", "to_int", type, fixes, fixes, [](Fix x, Fix){return to_integer(x);});
+	bench("convert", "to_float", type, fixes, fixes, [](Fix x, Fix){return static_cast<float>(x);});
+	bench("convert", "to_double", type, fixes, fixes, [](Fix x, Fix){return static_cast<double>(x);});
+}
+
+template<class Float>
+void bench_float_conversions(){
+	const std::string type = type_name(Float());
+	const std::vector<double> values = operands(4);
+	const std::vector<int32_t> integers = convert<int32_t>(random_values(-100, 100, 5));
+	const std::vector<float> floats = convert<float>(values);
+	const std::vector<Float> numbers = convert<Float>(values);
+	const string_table table(values);
+
+	bench("convert", "from_int", type, integers, integers, [](int32_t x, int32_t){return static_cast<Float>(x);});
+	bench("convert", "from_float", type, floats, floats, [](float x, float){return static_cast<Float>(x);});
+	bench("convert", "from_double", type, values, values, [](double x, double){return static_cast<Float>(x);});
+	bench("convert", "from_string", type, table.strings, table.strings, [](const char* x, const char*){return static_cast<Float>(std::strtod(x, nullptr));});
+	bench("convert", "to_int", type, numbers, numbers, [](Float x, Float){return static_cast<int32_t>(x);});
+	bench("convert", "to_float", type, numbers, numbers, [](Float x, Float){return static_cast<float>(x);});
+	bench("convert", "to_double", type, numbers, numbers, [](Float x, Float){return static_cast<double>(x);});
+}
+
+// ---------------- text ----------------
+
+template<class T, class Read>
+void bench_text(const std::vector<T>& numbers, const string_table& table, Read read){
+	const std::string type = type_name(T());
+	char_sink sink_buffer;
+	std::ostream output(&sink_buffer);
+	char_source source_buffer;
+	std::istream input(&source_buffer);
+
+	bench("text", "print", type, numbers, numbers, [&](T x, T){
+		sink_buffer.reset();
+		output << x;
+		return sink_buffer.size();
+	});
+	bench("text", "operator>>", type, table.strings, table.strings, [&](const char* str, const char*){
+		source_buffer.set(str);
+		input.clear();
+		T x = T();
+		input >> x;
+		return x;
+	});
+	bench("text", "parse", type, table.strings, table.strings, read);
+}
+
+template<class Fix>
+void bench_fix_text(){
+	const std::vector<double> values = operands(6);
+	const std::vector<Fix> numbers = convert_fix<Fix>(values);
+	const string_table table(values);
+	const std::string type = type_name(Fix());
+	char buffer[64];
+
+	bench_text(numbers, table, [](const char* str, const char*){return Fix(str);});
+	bench("text", "to_chars", type, numbers, numbers, [&](Fix x, Fix){return to_chars(buffer, buffer + sizeof(buffer), x).ptr - buffer;});
+	bench("text", "to_chars_3", type, numbers, numbers, [&](Fix x, Fix){return to_chars(buffer, buffer + sizeof(buffer), x, 3).ptr - buffer;});
+	bench("text", "from_chars", type, table.strings, table.strings, [](const char* str, const char*){
+		Fix x = 0;
+		from_chars(str, str + std::strlen(str), x);
+		return x;
+	});
+}
+
+template<class Float>
+void bench_float_text(){
+	const std::vector<double> values = operands(6);
+	const std::vector<Float> numbers = convert<Float>(values);
+	const string_table table(values);
+	const std::string type = type_name(Float());
+	char buffer[64];
+
+	bench_text(numbers, table, [](const char* str, const char*){return static_cast<Float>(std::strtod(str, nullptr));});
+	bench("text", "to_chars", type, numbers, numbers, [&](Float x, Float){return std::snprintf(buffer, sizeof(buffer), "%.9g", static_cast<double>(x));});
+	bench("text", "to_chars_3", type, numbers, numbers, [&](Float x, Float){return std::snprintf(buffer, sizeof(buffer), "%.3f", static_cast<double>(x));});
+}
+
+// ---------------- fixmath ----------------
+
+// functions, that are defined for fix32 and fix64
+template<class Fix>
+void bench_fix_math(){
+	const std::string type = type_name(Fix());
+	const std::vector<Fix> x = convert_fix<Fix>(random_values(-2, 2, 7));
+	const std::vector<Fix> y = convert_fix<Fix>(random_values(-2, 2, 8));
+	const std::vector<Fix> positive = convert_fix<Fix>(random_values(0.5, 4, 9));
+	const std::vector<Fix> t = convert_fix<Fix>(random_values(0, 1, 10));
+	const std::vector<Fix> exponents = convert_fix<Fix>(random_values(-2, 2, 12));
+
+	bench("fixmath", "abs", type, x, y, [](Fix a, Fix){return abs(a);});
+	bench("fixmath", "min", type, x, y, [](Fix a, Fix b){return min(a, b);});
+	bench("fixmath", "max", type, x, y, [](Fix a, Fix b){return max(a, b);});
+	bench("fixmath", "mod", type, x, positive, [](Fix a, Fix b){return mod(a, b);});
+	bench("fixmath", "remainder", type, x, positive, [](Fix a, Fix b){return remainder(a, b);});
+	bench("fixmath", "floor", type, x, y, [](Fix a, Fix){return floor(a);});
+	bench("fixmath", "ceil", type, x, y, [](Fix a, Fix){return ceil(a);});
+	bench("fixmath", "lerp", type, x, t, [&](Fix a, Fix b){return lerp(a, y[0], b);});
+	bench("fixmath", "expm1", type, exponents, y, [](Fix a, Fix){return expm1(a);});
+
+	bench("fixmath", "exp2", type, exponents, y, [](Fix a, Fix){return exp2(a);});
+	bench("fixmath", "exp", type, exponents, y, [](Fix a, Fix){return exp(a);});
+	bench("fixmath", "exp10", type, exponents, y, [](Fix a, Fix){return exp10(a);});
+	bench("fixmath", "log2", type, positive, y, [](Fix a, Fix){return log2(a);});
+	bench("fixmath", "atan", type, x, y, [](Fix a, Fix){return atan(a);});
+	bench("fixmath", "atan2", type, x, y, [](Fix a, Fix b){return atan2(a, b);});
+	bench("fixmath", "polar", type, x, y, [](Fix a, Fix b){return polar(a, b).angle;});
+
+	bench("fixmath", "fast::exp2", type, exponents, y, [](Fix a, Fix){return fixmath::fast::exp2(a);});
+	bench("fixmath", "fast::exp", type, exponents, y, [](Fix a, Fix){return fixmath::fast::exp(a);});
+	bench("fixmath", "fast::exp10", type, exponents, y, [](Fix a, Fix){return fixmath::fast::exp10(a);});
+	bench("fixmath", "fast::log2", type, positive, y, [](Fix a, Fix){return fixmath::fast::log2(a);});
+	bench("fixmath", "fast::atan", type, x, y, [](Fix a, Fix){return fixmath::fast::atan(a);});
+	bench("fixmath", "fast::atan2", type, x, y, [](Fix a, Fix b){return fixmath::fast::atan2(a, b);});
+
+	bench("fixmath", "precise::exp2", type, exponents, y, [](Fix a, Fix){return fixmath::precise::exp2(a);});
+	bench("fixmath", "precise::exp", type, exponents, y, [](Fix a, Fix){return fixmath::precise::exp(a);});
+	bench("fixmath", "precise::exp10", type, exponents, y, [](Fix a, Fix){return fixmath::precise::exp10(a);});
+	bench("fixmath", "precise::log2", type, positive, y, [](Fix a, Fix){return fixmath::precise::log2(a);});
+	bench("fixmath", "precise::atan", type, x, y, [](Fix a, Fix){return fixmath::precise::atan(a);});
+	bench("fixmath", "precise::atan2", type, x, y, [](Fix a, Fix b){return fixmath::precise::atan2(a, b);});
+}
+
+// activation functions, that are only defined for fix32
+template<size_t N>
+void bench_fix32_activations(){
+	using Fix = fix32<N>;
+	const std::string type = type_name(Fix());
+	const std::vector<Fix> x = convert_fix<Fix>(random_values(-4, 4, 11));
+
+	bench("fixmath", "tanh", type, x, x, [](Fix a, Fix){return tanh(a);});
+	bench("fixmath", "sigmoid", type, x, x, [](Fix a, Fix){return sigmoid(a);});
+	bench("fixmath", "gelu", type, x, x, [](Fix a, Fix){return gelu(a);});
+	bench("fixmath", "relu6", type, x, x, [](Fix a, Fix){return relu6(a);});
+}
+
+template<class Float>
+void bench_float_math(){
+	const std::string type = type_name(Float());
+	const std::vector<Float> x = convert<Float>(random_values(-2, 2, 7));
+	const std::vector<Float> y = convert<Float>(random_values(-2, 2, 8));
+	const std::vector<Float> positive = convert<Float>(random_values(0.5, 4, 9));
+	const std::vector<Float> t = convert<Float>(random_values(0, 1, 10));
+	const std::vector<Float> exponents = convert<Float>(random_values(-2, 2, 12));
+	const std::vector<Float> activations = convert<Float>(random_values(-4, 4, 11));
+	const Float ten = 10;
+	const Float one = 1;
+	const Float half = 0.5;
+	const Float sqrt_half = static_cast<Float>(0.70710678118654752);
+
+	bench("fixmath", "abs", type, x, y, [](Float a, Float){return std::fabs(a);});
+	bench("fixmath", "min", type, x, y, [](Float a, Float b){return (a < b) ? a : b;});
+	bench("fixmath", "max", type, x, y, [](Float a, Float b){return (a > b) ? a : b;});
+	bench("fixmath", "mod", type, x, positive, [](Float a, Float b){return std::fmod(a, b);});
+	bench("fixmath", "remainder", type, x, positive, [](Float a, Float b){return std::remainder(a, b);});
+	bench("fixmath", "floor", type, x, y, [](Float a, Float){return std::floor(a);});
+	bench("fixmath", "ceil", type, x, y, [](Float a, Float){return std::ceil(a);});
+	bench("fixmath", "lerp", type, x, t, [&](Float a, Float b){return a + (y[0] - a) * b;});
+	bench("fixmath", "expm1", type, exponents, y, [](Float a, Float){return std::expm1(a);});
+
+	bench("fixmath", "exp2", type, exponents, y, [](Float a, Float){return std::exp2(a);});
+	bench("fixmath", "exp", type, exponents, y, [](Float a, Float){return std::exp(a);});
+	bench("fixmath", "exp10", type, exponents, y, [&](Float a, Float){return std::pow(ten, a);});
+	bench("fixmath", "log2", type, positive, y, [](Float a, Float){return std::log2(a);});
+	bench("fixmath", "atan", type, x, y, [](Float a, Float){return std::atan(a);});
+	bench("fixmath", "atan2", type, x, y, [](Float a, Float b){return std::atan2(a, b);});
+	bench("fixmath", "polar", type, x, y, [](Float a, Float b){return std::atan2(b, a) + std::hypot(a, b);});
+
+	bench("fixmath", "tanh", type, activations, activations, [](Float a, Float){return std::tanh(a);});
+	bench("fixmath", "sigmoid", type, activations, activations, [&](Float a, Float){return one / (one + std::exp(-a));});
+	bench("fixmath", "gelu", type, activations, activations, [&](Float a, Float){return half * a * (one + std::erf(a * sqrt_half));});
+	bench("fixmath", "relu6", type, activations, activations, [](Float a, Float){return (a < 0) ? Float(0) : (a > 6) ? Float(6) : a;});
+}
+
+// ---------------- main ----------------
+
+template<class Fix>
+void bench_fix(){
+	bench_fix_operators<Fix>();
+	bench_fix_conversions<Fix>();
+	bench_fix_text<Fix>();
+	bench_fix_math<Fix>();
+}
+
+template<class Float>
+void bench_float(){
+	bench_float_operators<Float>();
+	bench_float_conversions<Float>();
+	bench_float_text<Float>();
+	bench_float_math<Float>();
+}
+
+int main(int argc, char** argv){
+	const char* output_path = nullptr;
+	for(int i = 1; i < argc; ++i){
+		const std::string argument = argv[i];
+		if(argument == "--quick"){
+			config.sample_seconds = 2e-4;
+		}else if(argument == "--filter" && i + 1 < argc){
+			config.filter = argv[++i];
+		}else if(argument.size() > 0 && argument[0] != '-'){
+			output_path = argv[i];
+		}else{
+			std::cerr << "usage: bench_fixpoint [--quick] [--filter text] [output.json]" << std::endl;
+			return 1;
+		}
+	}
+
+	std::cerr << std::left << std::setw(12) << "group" << std::setw(22) << "operation" << std::setw(12) << "type"
+		<< std::right << std::setw(10) << "lat [ns]" << std::setw(10) << "thr [ns]" << std::endl;
+
+	bench_fix<fix32<8>>();
+	bench_fix<fix32<16>>();
+	bench_fix<fix32<24>>();
+	bench_fix<fix64<16>>();
+	bench_fix<fix64<32>>();
+	bench_fix<fix64<48>>();
+	bench_fix32_activations<8>();
+	bench_fix32_activations<16>();
+	bench_fix32_activations<24>();
+
+	bench_float<float>();
+	bench_float<double>();
+
+	bench_integer_operators<int32_t>();
+	bench_integer_operators<int64_t>();
+
+	if(output_path != nullptr){
+		std::ofstream file(output_path);
+		write_json(file);
+		if(!file){
+			std::cerr << "could not write " << output_path << std::endl;
+			return 1;
+		}
+	}else{
+		write_json(std::cout);
+	}
+	return 0;
+}
@@ -0,0 +1,59 @@
+/*
+	Author: Tobias Wallner
+	tobias.wallner1@gmx.net
+
+	Compares the search of lerp() with eytzinger_pwl_table for table sizes from
+	L1 resident to DRAM resident. Build with CMAKE_BUILD_TYPE=Release.
+*/
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <random>
+#include "fixtable.hpp"
+
+// prevents the compiler from removing the benchmarked calculations
+static volatile int32_t sink;
+
+template<class Function>
+double ns_per_query(const std::vector<fix32<16>>& queries, Function&& function){
+	const auto start = std::chrono::steady_clock::now();
+	int32_t accumulator = 0;
+	for(fix32<16> q : queries){
+		accumulator ^= function(q).reinterpret_as_int32();
+	}
+	const auto stop = std::chrono::steady_clock::now();
+	sink = accumulator;
+	return std::chrono::duration<double, std::nano>(stop - start).count() / static_cast<double>(queries.size());
+}
+
+int main(){
+	std::mt19937 rng(42);
+	const size_t n_queries = 1 << 20;
+
+	std::cout << "lerp search vs. eytzinger_pwl_table, fix32<16>, " << n_queries << " random queries" << std::endl;
+	std::cout << std::setw(10) << "breakpts" << std::setw(12) << "keys [KiB]" << std::setw(14) << "lerp [ns]" << std::setw(18) << "eytzinger [ns]" << std::endl;
+
+	for(size_t n = 1 << 8; n <= (1 << 22); n <<= 2){
+		std::vector<fix32<16>> x(n);
+		std::vector<fix32<16>> y(n);
+		for(size_t i = 0; i < n; ++i){
+			x[i] = fix32<16>::reinterpret(static_cast<int32_t>(i * 64));
+			y[i] = fix32<16>::reinterpret(static_cast<int32_t>(rng() & 0xFFFFF));
+		}
+		const eytzinger_pwl_table<fix32<16>> table(x.data(), x.data() + n, y.data());
+
+		std::uniform_int_distribution<int32_t> distribution(0, static_cast<int32_t>(n * 64 - 1));
+		std::vector<fix32<16>> queries(n_queries);
+		for(fix32<16>& q : queries) q = fix32<16>::reinterpret(distribution(rng));
+
+		const double t_lerp = ns_per_query(queries, [&](fix32<16> q){return lerp(x.begin(), x.end(), y.begin(), y.end(), q);});
+		const double t_eytzinger = ns_per_query(queries, [&](fix32<16> q){return table(q);});
+
+		std::cout << std::setw(10) << n << std::setw(12) << (n * sizeof(fix32<16>)) / 1024
+			<< std::fixed << std::setprecision(1) << std::setw(14) << t_lerp << std::setw(18) << t_eytzinger << std::endl;
+	}
+	return 0;
+}
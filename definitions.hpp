@@ -2,40 +2,170 @@
 /*
 	To disable boundary checks:
 		Define: DISABLE_FIXPOINT_ASSERTIONS
-		
+		Or use the functions in the namespace fixpoint_unchecked for single call sites,
+		and try_convert() or try_divide() to get a std::errc instead of an error,
+		or the checked and overflowing functions of fixchecked.hpp to get an overflow flag.
+
 	To handle errors, define one of the following
 		FIXPOINT_THROW_ERROR			(default)
 		FIXPOINT_EXIT_ERROR 			(calls exit(-1) to exit the program)
 		FIXPOINT_TRAP_ERROR 			(traps the execution in a while loop)
 		FIXPOINT_LOG_ERROR				(logs the error to some output stream and continues execution)
 		FIXPOINT_CUSTOM_ERROR		 	(calls the user defined function: 'void fixpoint_custom_error_handler(const char* error_message)')
-		
+
 	Set the error output stream by defining (only for FIXPOINT_EXIT, FIXPOINT_TRAP or FIXPOINT_RETURN_ZERO):
 		FIXPOINT_CERR	(default is std::cerr)
+
+	A check compiles to one branch, that is predicted not to be taken, to an out of line cold handler.
+	The error message is only formatted in the handler, after the check has failed.
 */
 
+#include <cinttypes>
+#include <type_traits>
+
 #define FIXPOINT_ENABLE_IF(condition) typename std::enable_if_t<(condition), int> = 0
 
+#if defined(__GNUC__)
+	#define FIXPOINT_COLD __attribute__((cold, noinline))
+	#define FIXPOINT_UNLIKELY(condition) __builtin_expect(!!(condition), 0)
+#elif defined(_MSC_VER)
+	#define FIXPOINT_COLD __declspec(noinline)
+	#define FIXPOINT_UNLIKELY(condition) (condition)
+#else
+	#define FIXPOINT_COLD
+	#define FIXPOINT_UNLIKELY(condition) (condition)
+#endif
+
 #ifdef DISABLE_FIXPOINT_ASSERTIONS
-	#define fixpoint_assert(condition, message)
+	#define fixpoint_raise(message)
 #else
-	
-	#ifndef FIXPOINT_CERR
-		#define FIXPOINT_CERR std::cout
-	#endif
 
 	#if defined(FIXPOINT_CUSTOM_ERROR)
+		#include <sstream>
 		void fixpoint_custom_error_handler(const char* error_message);
-		#define fixpoint_assert(condition, message) if(!(condition)){std::stringstream s; s << message; fixpoint_custom_error_handler(s.str().c_str());}
+	#elif defined(FIXPOINT_TRAP_ERROR) || defined(FIXPOINT_EXIT_ERROR) || defined(FIXPOINT_LOG_ERROR)
+		#include <cstdlib>
+		#ifndef FIXPOINT_CERR
+			#include <iostream>
+			#define FIXPOINT_CERR std::cout
+		#endif
+	#else
+		#include <sstream>
+		#include <stdexcept>
+	#endif
+
+	namespace fixpoint_detail{
+		// 'message' writes the error message to the stream it is called with
+		template<class Message>
+		FIXPOINT_COLD void raise_error(const Message& message){
+	#if defined(FIXPOINT_CUSTOM_ERROR)
+			std::stringstream s;
+			message(s);
+			fixpoint_custom_error_handler(s.str().c_str());
 	#elif defined(FIXPOINT_TRAP_ERROR)
-		#define fixpoint_assert(condition, message) if(!(condition)){FIXPOINT_CERR << message; while(true){};}
+			message(FIXPOINT_CERR);
+			while(true){};
 	#elif defined(FIXPOINT_EXIT_ERROR)
-		#define fixpoint_assert(condition, message) if(!(condition)){FIXPOINT_CERR << message; exit(-1);}
+			message(FIXPOINT_CERR);
+			exit(-1);
 	#elif defined(FIXPOINT_LOG_ERROR)
-		#define fixpoint_assert(condition, message) if(!(condition)){FIXPOINT_CERR << message;}
+			message(FIXPOINT_CERR);
+	#else
+			std::stringstream s;
+			message(s);
+			throw std::runtime_error(s.str().c_str());
+	#endif
+		}
+	}
+
+	// capturing by copy keeps the arguments of the message in registers on the hot path.
+	// C++20 deprecates the implicit capture of 'this' by [=], so it captures by reference.
+	#if __cplusplus >= 202002L
+		#define fixpoint_raise(message) fixpoint_detail::raise_error([&](auto& fixpoint_error_stream){fixpoint_error_stream << message;});
 	#else
-		#include <exception>
-		#define fixpoint_assert(condition, message) if(!(condition)){std::stringstream s; s << message; throw std::runtime_error(s.str().c_str());}
+		#define fixpoint_raise(message) fixpoint_detail::raise_error([=](auto& fixpoint_error_stream){fixpoint_error_stream << message;});
 	#endif
 
-#endif
\ No newline at end of file
+#endif
+
+/*
+	To count overflows, divisions by zero, saturations, truncations and domain errors, and to keep
+	the most recent of them in a ring buffer that can be read from another thread, define:
+		FIXPOINT_INSTRUMENT				(see fixinstrument.hpp)
+		FIXPOINT_INSTRUMENT_ARITHMETIC	(additionally checks + - * for overflows, which prevents vectorization)
+*/
+#if defined(FIXPOINT_INSTRUMENT_ARITHMETIC) && !defined(FIXPOINT_INSTRUMENT)
+	#define FIXPOINT_INSTRUMENT
+#endif
+
+#if defined(FIXPOINT_INSTRUMENT)
+	#if defined(__GNUC__)
+		#define FIXPOINT_FUNCTION __PRETTY_FUNCTION__
+	#else
+		#define FIXPOINT_FUNCTION __func__
+	#endif
+	#define fixpoint_record(kind, value) fixpoint_instrument::record(fixpoint_instrument::event_kind::kind, fixpoint_detail::event_value(value), FIXPOINT_FUNCTION);
+#else
+	#define fixpoint_record(kind, value)
+#endif
+
+#if defined(DISABLE_FIXPOINT_ASSERTIONS)
+	#define fixpoint_assert(condition, message)
+#else
+	#define fixpoint_assert(condition, message) if(FIXPOINT_UNLIKELY(!(condition))){fixpoint_raise(message)}
+#endif
+
+// like fixpoint_assert(), but also reports an event of the given kind and value to the instrumentation
+#if defined(DISABLE_FIXPOINT_ASSERTIONS) && !defined(FIXPOINT_INSTRUMENT)
+	#define fixpoint_check(condition, kind, value, message)
+#else
+	#define fixpoint_check(condition, kind, value, message) if(FIXPOINT_UNLIKELY(!(condition))){fixpoint_record(kind, value) fixpoint_raise(message)}
+#endif
+
+// reports an event to the instrumentation, without raising an error. Compiles to nothing without FIXPOINT_INSTRUMENT.
+#if defined(FIXPOINT_INSTRUMENT)
+	#define fixpoint_instrument_check(condition, kind, value) if(FIXPOINT_UNLIKELY(!(condition))){fixpoint_record(kind, value)}
+#else
+	#define fixpoint_instrument_check(condition, kind, value)
+#endif
+
+// like fixpoint_instrument_check(), for the checks of the arithmetic operators. Compiles to nothing without FIXPOINT_INSTRUMENT_ARITHMETIC.
+#if defined(FIXPOINT_INSTRUMENT_ARITHMETIC)
+	#define fixpoint_instrument_arithmetic(condition, kind, value) fixpoint_instrument_check(condition, kind, value)
+#else
+	#define fixpoint_instrument_arithmetic(condition, kind, value)
+#endif
+
+/*
+	Operations without checks, for call sites where the arguments are known to be valid.
+
+	Example:
+		const fix32<16> a = fixpoint_unchecked::convert<fix32<16>>(sample);
+		const fix32<16> b = fixpoint_unchecked::divide(a, gain);
+*/
+namespace fixpoint_unchecked{
+	template<class Fix, class Number>
+	constexpr Fix convert(Number num){return Fix(num, typename Fix::UncheckedToken());}
+
+	template<class Fix, class Divisor>
+	constexpr Fix divide(Fix lhs, Divisor rhs){return Fix::divide(lhs, rhs, typename Fix::UncheckedToken());}
+}
+
+namespace fixpoint_detail{
+	// true if num, truncated towards zero, lies in [low, high]
+	template<class Number, std::enable_if_t<std::is_integral<Number>::value, bool> = true>
+	constexpr bool in_range(Number num, int64_t low, int64_t high){
+		return std::is_signed<Number>::value
+			? (static_cast<int64_t>(num) >= low && static_cast<int64_t>(num) <= high)
+			: (static_cast<uint64_t>(num) <= static_cast<uint64_t>(high));
+	}
+
+	template<class Number, std::enable_if_t<std::is_floating_point<Number>::value, bool> = true>
+	constexpr bool in_range(Number num, int64_t low, int64_t high){
+		return static_cast<long double>(num) >= static_cast<long double>(low) && static_cast<long double>(num) < static_cast<long double>(high) + 1;
+	}
+}
+
+#if defined(FIXPOINT_INSTRUMENT)
+	#include "fixinstrument.hpp"
+#endif
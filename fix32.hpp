@@ -12,16 +12,23 @@
 #include <type_traits>
 
 #include "definitions.hpp"
+#include "fixchars.hpp"
 
 namespace fixpoint_detail {
 	constexpr int bit_scan_reverse(uint32_t value) {
+#if defined(__GNUC__)
+		return (value == 0) ? -1 : 31 - __builtin_clz(value);
+#else
 		int index = -1;
 		while (value) {
 			value >>= 1;
 			++index;
 		}
 		return index;
+#endif
 	}
+
+	constexpr bool fits_int32(int64_t value){return INT32_MIN <= value && value <= INT32_MAX;}
 }
 
 template<size_t fractional_bits>
@@ -39,12 +46,11 @@ public:
 
 	constexpr fix32() = default;
 	constexpr fix32(const fix32&) = default;
-	constexpr fix32(int32_t num) : value(num << fractional_bits){
-		fixpoint_assert(num <= fix32::max, "Truncation error constructing fix<" << fractional_bits << ">(int32_t num) with num=" << num << ". 'num' is larger than the largest representable number fix<" << fractional_bits << ">::max=" << fix32<fractional_bits>::max << ".");
-		fixpoint_assert(num <= fix32::max, "Truncation error constructing fix<" << fractional_bits << ">(int32_t num) with num=" << num << ". 'num' is smaller than the smallest representable number fix<" << fractional_bits << ">::min=" << fix32<fractional_bits>::min << ".");
+	constexpr fix32(int32_t num) : fix32(num, UncheckedToken()){
+		fixpoint_check(num >= fix32::min && num <= fix32::max, truncation, num, "Truncation error constructing fix<" << fractional_bits << ">(int32_t num) with num=" << num << ". 'num' is outside of the range of representable numbers [fix<" << fractional_bits << ">::min, fix<" << fractional_bits << ">::max]=[" << fix32<fractional_bits>::min << ", " << fix32<fractional_bits>::max << "].");
 	}
 	
-	constexpr fix32(int32_t num, ReinterpretToken t) : value(num){}
+	constexpr fix32(int32_t num, ReinterpretToken) : value(num){}
 
 	template<typename Integer, std::enable_if_t<std::is_integral<Integer>::value, bool> = true>
 	fix32(Integer num) : fix32(static_cast<int32_t>(num)){}
@@ -52,9 +58,23 @@ public:
 	template<typename Integer, std::enable_if_t<std::is_integral<Integer>::value, bool> = true>
 	fix32(Integer num, ReinterpretToken t) : fix32(static_cast<int32_t>(num), t){}
 
-	inline fix32(float num) : value(0) {
-		fixpoint_assert(num <= fix32::max, "Truncation error constructing fix<" << fractional_bits << ">(float num) with num=" << num << ". 'num' is larger than the largest representable number fix<" << fractional_bits << ">::max=" << fix32<fractional_bits>::max << ".");
-		fixpoint_assert(num <= fix32::max, "Truncation error constructing fix<" << fractional_bits << ">(float num) with num=" << num << ". 'num' is smaller than the smallest representable number fix<" << fractional_bits << ">::min=" << fix32<fractional_bits>::min << ".");
+	inline fix32(float num) : fix32(num, UncheckedToken()) {
+		fixpoint_check(num >= fix32::min && num < fix32::max + 1.f, truncation, num, "Truncation error constructing fix<" << fractional_bits << ">(float num) with num=" << num << ". 'num' is outside of the range of representable numbers [fix<" << fractional_bits << ">::min, fix<" << fractional_bits << ">::max]=[" << fix32<fractional_bits>::min << ", " << fix32<fractional_bits>::max << "].");
+	}
+	
+	inline fix32(double num) : fix32(num, UncheckedToken()){
+		fixpoint_check(num >= fix32::min && num < fix32::max + 1., truncation, num, "Truncation error constructing fix<" << fractional_bits << ">(double num) with num=" << num << ". 'num' is outside of the range of representable numbers [fix<" << fractional_bits << ">::min, fix<" << fractional_bits << ">::max]=[" << fix32<fractional_bits>::min << ", " << fix32<fractional_bits>::max << "].");
+	}
+
+	// constructors without range checks, see fixpoint_unchecked::convert()
+	class UncheckedToken{};
+
+	constexpr fix32(int32_t num, UncheckedToken) : value(static_cast<int32_t>(static_cast<uint32_t>(num) << fractional_bits)){}
+
+	template<typename Integer, std::enable_if_t<std::is_integral<Integer>::value, bool> = true>
+	constexpr fix32(Integer num, UncheckedToken t) : fix32(static_cast<int32_t>(num), t){}
+
+	inline fix32(float num, UncheckedToken) : value(0) {
 		if (num != 0.f) {
 			const uint32_t inum = *reinterpret_cast<const uint32_t*>(&num);
 			const uint32_t float_mantissa = (inum & ((1 << 23) - 1)) | (1 << 23);
@@ -69,88 +89,13 @@ public:
 		}
 	}
 	
-	inline fix32(double num) : fix32(static_cast<float>(num)){
-		fixpoint_assert(num <= fix32::max, "Truncation error constructing fix<" << fractional_bits << ">(double num) with num=" << num << ". 'num' is larger than the largest representable number fix<" << fractional_bits << ">::max=" << fix32<fractional_bits>::max << ".");
-		fixpoint_assert(num <= fix32::max, "Truncation error constructing fix<" << fractional_bits << ">(double num) with num=" << num << ". 'num' is smaller than the smallest representable number fix<" << fractional_bits << ">::min=" << fix32<fractional_bits>::min << ".");
+	inline fix32(double num, UncheckedToken t) : fix32(static_cast<float>(num), t){
 		/*TODO: propper conversion*/
 	}
 	
 	constexpr fix32(const char* str, int radix=10) : value(0){
-		bool sign = false;
-		uint32_t digits = 0;
-		uint32_t fractions = 0;
-		char const * const str_first = str;
-		
-		// parse sign
-		if (*str == '-') {
-			sign = true;
-			++str;
-		}
-
-		// select radix
-		if (*str == '0') {
-			++str;
-			switch (*str) {
-				case 'b': {++str; radix = 2; } break;
-				case 'o': {++str; radix = 8; } break;
-				case 'd': {++str; radix = 10; } break;
-				case 'x': case 'X': {++str; radix = 16; } break;
-				default: break;
-			}
-		}
-
-		// select ranges
-		char digit_first = '0';
-		char digit_last = '0' + ((radix <= 10) ? (radix) : 10);
-		char alpha_first = 'a';
-		char alpha_last = 'a' + ((radix > 10) ? radix - 10 : 0);
-		char ALPHA_first = 'A';
-		char ALPHA_last = 'A' + ((radix > 10) ? radix - 10 : 0);
-
-
-		// parse digits
-		while (true) {
-			if (digit_first <= *str && *str <= digit_last) {
-				digits = digits * radix + (*str - digit_first);
-			}else if (alpha_first <= *str && *str <= alpha_last) {
-				digits = digits * radix + (*str - alpha_first + 10);
-			}else if (ALPHA_first <= *str && *str <= ALPHA_last) {
-				digits = digits * radix + (*str - ALPHA_first + 10);
-			}else {
-				break;
-			}
-			++str;
-		}
-		digits <<= fractional_bits;
-
-		// parse fractions
-		if (*str == '.') {
-			++str;
-			size_t s = radix;
-			while (true) {
-				if (digit_first <= *str && *str <= digit_last) {
-					fractions = fractions + ((static_cast<uint32_t>(*str) - static_cast<uint32_t>(digit_first)) << 28) / s;
-				}else if (alpha_first <= *str && *str <= alpha_last) {
-					fractions = fractions + ((static_cast<uint32_t>(*str) - static_cast<uint32_t>(alpha_first) + 10) << 28) / s;
-				}else if (ALPHA_first <= *str && *str <= ALPHA_last) {
-					fractions = fractions + ((static_cast<uint32_t>(*str) - static_cast<uint32_t>(ALPHA_first) + 10) << 28) / s;
-				}else {
-					break;
-				}
-				++str;
-				size_t new_s = s * radix;
-				s = (new_s > s) ? new_s : 0; //overflow protection
-			}
-
-			// shift fractions to the correct binary point
-			int shifts = static_cast<int>(28) - static_cast<int>(fractional_bits);
-			fractions = (shifts >= 0) ? fractions >> shifts : fractions << -shifts;
-		}
-		
-		const uint32_t abs_value = digits | fractions;
-		const int32_t result = sign ? (-static_cast<int32_t>(abs_value)) : static_cast<int32_t>(abs_value);
-		
-		this->value = result;
+		fixpoint_detail::string_source source{str};
+		this->value = static_cast<int32_t>(fixpoint_detail::parse_radix<uint32_t, 28>(source, fractional_bits, radix));
 	}
 
 	fix32& assign(const char* str, int radix=10) {
@@ -170,12 +115,21 @@ public:
 	
 	// Arithmetic operators
 	
-	constexpr friend fix32 operator+ (fix32 lhs, fix32 rhs){return fix32::reinterpret(lhs.value + rhs.value);}
+	constexpr friend fix32 operator+ (fix32 lhs, fix32 rhs){
+		fixpoint_instrument_arithmetic(fixpoint_detail::fits_int32(static_cast<int64_t>(lhs.value) + rhs.value), overflow, fixpoint_detail::raw_to_double(static_cast<int64_t>(lhs.value) + rhs.value, fractional_bits));
+		return fix32::reinterpret(lhs.value + rhs.value);
+	}
+
 	constexpr friend fix32 operator- (fix32 a){return fix32::reinterpret(-a.value);}
-	constexpr friend fix32 operator- (fix32 lhs, fix32 rhs){return fix32::reinterpret(lhs.value - rhs.value);}
+
+	constexpr friend fix32 operator- (fix32 lhs, fix32 rhs){
+		fixpoint_instrument_arithmetic(fixpoint_detail::fits_int32(static_cast<int64_t>(lhs.value) - rhs.value), overflow, fixpoint_detail::raw_to_double(static_cast<int64_t>(lhs.value) - rhs.value, fractional_bits));
+		return fix32::reinterpret(lhs.value - rhs.value);
+	}
 	
 	constexpr friend fix32 operator* (fix32 lhs, fix32 rhs){
 		const int64_t temp = static_cast<int64_t>(lhs.value) * static_cast<int64_t>(rhs.value);
+		fixpoint_instrument_arithmetic(fixpoint_detail::fits_int32(temp >> fractional_bits), overflow, fixpoint_detail::raw_to_double(temp, 2 * fractional_bits));
 		return fix32::reinterpret(static_cast<int32_t>(static_cast<uint32_t>(temp >> fractional_bits)));
 	}
 	
@@ -190,14 +144,24 @@ public:
 	}
 
 	constexpr friend fix32 operator/ (fix32 lhs, fix32 rhs){
-		fixpoint_assert(rhs != 0, "Error: fixpoint division by zero");
-		const int64_t temp = (static_cast<int64_t>(lhs.value) << fractional_bits) / static_cast<int64_t>(rhs.value);
-		return fix32::reinterpret(static_cast<int32_t>(temp));
+		fixpoint_check(rhs != 0, divide_by_zero, lhs, "Error: fixpoint division by zero");
+		return fix32::divide(lhs, rhs, UncheckedToken());
 	}
 	
 	template<typename Integer, std::enable_if_t<std::is_integral<Integer>::value, bool> = true>
 	constexpr friend fix32 operator/ (fix32 lhs, Integer rhs){
-		fixpoint_assert(rhs != 0, "Error: fixpoint division by zero");
+		fixpoint_check(rhs != 0, divide_by_zero, lhs, "Error: fixpoint division by zero");
+		return fix32::divide(lhs, rhs, UncheckedToken());
+	}
+
+	// division without the check for zero, see fixpoint_unchecked::divide()
+	static constexpr fix32 divide(fix32 lhs, fix32 rhs, UncheckedToken){
+		const int64_t temp = (static_cast<int64_t>(lhs.value) << fractional_bits) / static_cast<int64_t>(rhs.value);
+		return fix32::reinterpret(static_cast<int32_t>(temp));
+	}
+
+	template<typename Integer, std::enable_if_t<std::is_integral<Integer>::value, bool> = true>
+	static constexpr fix32 divide(fix32 lhs, Integer rhs, UncheckedToken){
 		return fix32::reinterpret(lhs.value / static_cast<int32_t>(rhs));
 	}
 	
@@ -255,7 +219,7 @@ public:
 		uint32_t digits = f.value >> fractional_bits;
 		uint32_t fractionals = f.value & ((1 << fractional_bits) - 1);
 
-		int significant_places = 0;
+		size_t significant_places = 0;
 		bool count_significant_enable = digits != 0;
 
 		// print digits and decimal point
@@ -277,86 +241,62 @@ public:
 	template<class Stream>
 	friend Stream& operator<<(Stream& stream, fix32 f){return print(stream, f);}
 
-	template<class Stream>
-	friend Stream& operator>>(Stream& stream, fix32& f) {
-		bool sign = false;
-		uint32_t digits = 0;
-		uint32_t fractions = 0;
-		int radix = 10;
-		
-		// parse sign
-		if (stream.peek() == '-') {
-			sign = true;
-			stream.get();
-		}
-
-		// select radix
-		if (stream.peek() == '0') {
-			stream.get();
-			switch (stream.peek()) {
-				case 'b': {stream.get(); radix = 2; } break;
-				case 'o': {stream.get(); radix = 8; } break;
-				case 'd': {stream.get(); radix = 10; } break;
-				case 'x': case 'X': {stream.get(); radix = 16; } break;
-				default: break;
-			}
-		}
+	// writes f in decimal to [first, last) without allocating. With a negative precision the shortest
+	// string that reads back as f is written, otherwise exactly 'precision' correctly rounded digits after the decimal point.
+	friend fix_to_chars_result to_chars(char* first, char* last, fix32 f, int precision = -1){
+		const bool negative = f.value < 0;
+		const uint64_t magnitude = negative ? (0 - static_cast<uint64_t>(f.value)) : static_cast<uint64_t>(f.value);
+		const uint64_t mask = (1ULL << fractional_bits) - 1;
+		return fixpoint_detail::to_chars_fixed(first, last, negative, magnitude >> fractional_bits, magnitude & mask, static_cast<int>(fractional_bits), precision);
+	}
 
-		// select ranges
-		char digit_first = '0';
-		char digit_last = '0' + ((radix <= 10) ? (radix) : 10);
-		char alpha_first = 'a';
-		char alpha_last = 'a' + ((radix > 10) ? radix - 10 : 0);
-		char ALPHA_first = 'A';
-		char ALPHA_last = 'A' + ((radix > 10) ? radix - 10 : 0);
-
-
-		// parse digits
-		while (true) {
-			if (digit_first <= stream.peek() && stream.peek() <= digit_last) {
-				digits = digits * radix + (stream.peek() - digit_first);
-			}else if (alpha_first <= stream.peek() && stream.peek() <= alpha_last) {
-				digits = digits * radix + (stream.peek() - alpha_first + 10);
-			}else if (ALPHA_first <= stream.peek() && stream.peek() <= ALPHA_last) {
-				digits = digits * radix + (stream.peek() - ALPHA_first + 10);
-			}else {
-				break;
-			}
-			stream.get();
-		}
-		digits <<= fractional_bits;
-
-		// parse fractions
-		if (stream.peek() == '.') {
-			stream.get();
-			size_t s = radix;
-			while (true) {
-				if (digit_first <= stream.peek() && stream.peek() <= digit_last) {
-					fractions = fractions + ((static_cast<uint32_t>(stream.peek()) - static_cast<uint32_t>(digit_first)) << 28) / s;
-				}else if (alpha_first <= stream.peek() && stream.peek() <= alpha_last) {
-					fractions = fractions + ((static_cast<uint32_t>(stream.peek()) - static_cast<uint32_t>(alpha_first) + 10) << 28) / s;
-				}else if (ALPHA_first <= stream.peek() && stream.peek() <= ALPHA_last) {
-					fractions = fractions + ((static_cast<uint32_t>(stream.peek()) - static_cast<uint32_t>(ALPHA_first) + 10) << 28) / s;
-				}else {
-					break;
-				}
-				stream.get();
-				size_t new_s = s * radix;
-				s = (new_s > s) ? new_s : 0; //overflow protection
-			}
-
-			// shift fractions to the correct binary point
-			int shifts = static_cast<int>(28) - static_cast<int>(fractional_bits);
-			fractions = (shifts >= 0) ? fractions >> shifts : fractions << -shifts;
+	// reads a decimal number with the pattern -?[0-9]*(.[0-9]*)? from [first, last), correctly rounded to the nearest.
+	// f is only assigned on success.
+	friend fix_from_chars_result from_chars(const char* first, const char* last, fix32& f){
+		bool negative = false;
+		uint64_t magnitude = 0;
+		const fix_from_chars_result result = fixpoint_detail::from_chars_fixed(first, last, static_cast<int>(fractional_bits), 0x7FFFFFFFULL, 0x80000000ULL, negative, magnitude);
+		if(result.ec == std::errc()){
+			f.value = static_cast<int32_t>(negative ? (0 - magnitude) : magnitude);
 		}
+		return result;
+	}
 
-		const uint32_t abs_value = digits | fractions;
-		const int32_t value = sign ? (-static_cast<int32_t>(abs_value)) : static_cast<int32_t>(abs_value);
-
-		f = fix32::reinterpret(value);
+	template<class Stream>
+	friend Stream& operator>>(Stream& stream, fix32& f) {
+		f = fix32::reinterpret(static_cast<int32_t>(fixpoint_detail::read_radix<uint32_t, 28>(stream, fractional_bits, 0)));
 		return stream;
 	}
 
 };
 
+/*
+	Conversion of an integer or floating point number, that returns an error code instead of
+	raising an error. Returns std::errc::result_out_of_range if num is not representable, result is
+	only assigned on success.
+*/
+template<size_t fractional_bits, class Number>
+std::errc try_convert(Number num, fix32<fractional_bits>& result){
+	if(!fixpoint_detail::in_range(num, fix32<fractional_bits>::min, fix32<fractional_bits>::max)){
+		return std::errc::result_out_of_range;
+	}
+	result = fixpoint_unchecked::convert<fix32<fractional_bits>>(num);
+	return std::errc();
+}
 
+/*
+	Division, that returns std::errc::argument_out_of_domain for a division by zero and std::errc::result_out_of_range
+	if the quotient is not representable, instead of raising an error. result is only assigned on success.
+*/
+template<size_t fractional_bits>
+constexpr std::errc try_divide(fix32<fractional_bits> lhs, fix32<fractional_bits> rhs, fix32<fractional_bits>& result){
+	if(rhs == 0){
+		return std::errc::argument_out_of_domain;
+	}
+	const int64_t temp = (static_cast<int64_t>(lhs.reinterpret_as_int32()) * (static_cast<int64_t>(1) << fractional_bits)) / rhs.reinterpret_as_int32();
+	if(temp < INT32_MIN || temp > INT32_MAX){
+		return std::errc::result_out_of_range;
+	}
+	result = fix32<fractional_bits>::reinterpret(static_cast<int32_t>(temp));
+	return std::errc();
+}
@@ -12,15 +12,82 @@
 #include <type_traits>
 
 #include "definitions.hpp"
+#include "fixchars.hpp"
 
 namespace fixpoint_detail {
 	constexpr int bit_scan_reverse(uint64_t value) {
+#if defined(__GNUC__)
+		return (value == 0) ? -1 : 63 - __builtin_clzll(value);
+#else
 		int index = -1;
 		while (value) {
 			value >>= 1;
 			++index;
 		}
 		return index;
+#endif
+	}
+
+	constexpr bool sum_fits_int64(int64_t a, int64_t b){
+		const int64_t sum = static_cast<int64_t>(static_cast<uint64_t>(a) + static_cast<uint64_t>(b));
+		return ((a ^ sum) & (b ^ sum)) >= 0;
+	}
+
+	constexpr bool difference_fits_int64(int64_t a, int64_t b){
+		const int64_t difference = static_cast<int64_t>(static_cast<uint64_t>(a) - static_cast<uint64_t>(b));
+		return ((a ^ b) & (a ^ difference)) >= 0;
+	}
+
+	/*
+		The product of the raw values a and b shifted down by fractional_bits and rounded down (floor),
+		wrapped around to 64 bits. Sets overflow if it does not fit. Without 128-bit integers.
+	*/
+	constexpr int64_t multiply_shift_portable(int64_t a, int64_t b, size_t fractional_bits, bool& overflow){
+		const bool negative = (a < 0) != (b < 0);
+		const uint64_t x = (a < 0) ? 0 - static_cast<uint64_t>(a) : static_cast<uint64_t>(a);
+		const uint64_t y = (b < 0) ? 0 - static_cast<uint64_t>(b) : static_cast<uint64_t>(b);
+
+		// 128-bit product of the magnitudes
+		const uint64_t x0 = x & 0xFFFFFFFFULL;
+		const uint64_t x1 = x >> 32;
+		const uint64_t y0 = y & 0xFFFFFFFFULL;
+		const uint64_t y1 = y >> 32;
+		const uint64_t p00 = x0 * y0;
+		const uint64_t p01 = x0 * y1;
+		const uint64_t p10 = x1 * y0;
+		const uint64_t middle = (p00 >> 32) + (p01 & 0xFFFFFFFFULL) + (p10 & 0xFFFFFFFFULL);
+		const uint64_t lower = (middle << 32) | (p00 & 0xFFFFFFFFULL);
+		const uint64_t upper = x1 * y1 + (p01 >> 32) + (p10 >> 32) + (middle >> 32);
+
+		// shift the magnitude down, and round it up for negative products, so that the product is rounded down
+		const uint64_t fraction_mask = (fractional_bits == 0) ? 0 : (~0ULL >> (64 - fractional_bits));
+		const bool round_up = negative && (lower & fraction_mask) != 0;
+		uint64_t shifted_lower = (fractional_bits == 0) ? lower : ((lower >> fractional_bits) | (upper << (64 - fractional_bits)));
+		uint64_t shifted_upper = upper >> fractional_bits;
+		shifted_lower += round_up;
+		shifted_upper += (round_up && shifted_lower == 0);
+
+		const uint64_t limit = negative ? (1ULL << 63) : (1ULL << 63) - 1;
+		overflow |= shifted_upper != 0 || shifted_lower > limit;
+		return static_cast<int64_t>(negative ? 0 - shifted_lower : shifted_lower);
+	}
+
+	// the same, with 128-bit integers where available
+	constexpr int64_t multiply_shift(int64_t a, int64_t b, size_t fractional_bits, bool& overflow){
+#if defined(__SIZEOF_INT128__)
+		__extension__ const __int128 product = (static_cast<__int128>(a) * b) >> fractional_bits;
+		overflow |= product < INT64_MIN || product > INT64_MAX;
+		return static_cast<int64_t>(product);
+#else
+		return multiply_shift_portable(a, b, fractional_bits, overflow);
+#endif
+	}
+
+	// true if the product of the raw values a and b, shifted down by fractional_bits, fits into 64 bits
+	constexpr bool product_fits_int64(int64_t a, int64_t b, size_t fractional_bits){
+		bool overflow = false;
+		multiply_shift(a, b, fractional_bits, overflow);
+		return !overflow;
 	}
 }
 
@@ -31,15 +98,17 @@ private:
 	
 public:
 
-	static constexpr int64_t max = (1 << (63-fractional_bits)) - 1;
-	static constexpr int64_t min = -(1 << (63-fractional_bits));
+	static constexpr int64_t max = INT64_MAX >> fractional_bits;
+	static constexpr int64_t min = INT64_MIN >> fractional_bits;
 
 	class ReinterpretToken{};
 
 	constexpr fix64() = default;
 	constexpr fix64(const fix64&) = default;
-	constexpr fix64(int64_t number) : value(number << fractional_bits){}
-	constexpr fix64(int64_t number, ReinterpretToken t) : value(number){}
+	constexpr fix64(int64_t number) : fix64(number, UncheckedToken()){
+		fixpoint_check(number >= fix64::min && number <= fix64::max, truncation, number, "Truncation error constructing fix64<" << fractional_bits << ">(int64_t number) with number=" << number << ". 'number' is outside of the range of representable numbers [fix64<" << fractional_bits << ">::min, fix64<" << fractional_bits << ">::max]=[" << fix64<fractional_bits>::min << ", " << fix64<fractional_bits>::max << "].");
+	}
+	constexpr fix64(int64_t number, ReinterpretToken) : value(number){}
 	
 	template<typename Integer, std::enable_if_t<std::is_integral<Integer>::value, bool> = true>
 	fix64(Integer number) : fix64(static_cast<int64_t>(number)){}
@@ -47,7 +116,23 @@ public:
 	template<typename Integer, std::enable_if_t<std::is_integral<Integer>::value, bool> = true>
 	fix64(Integer number, ReinterpretToken t) : fix64(static_cast<int64_t>(number), t){}
 
-	inline fix64(float num) {
+	inline fix64(float num) : fix64(num, UncheckedToken()){
+		fixpoint_check(fixpoint_detail::in_range(num, fix64::min, fix64::max), truncation, num, "Truncation error constructing fix64<" << fractional_bits << ">(float num) with num=" << num << ". 'num' is outside of the range of representable numbers [fix64<" << fractional_bits << ">::min, fix64<" << fractional_bits << ">::max]=[" << fix64<fractional_bits>::min << ", " << fix64<fractional_bits>::max << "].");
+	}
+	
+	inline fix64(double num) : fix64(num, UncheckedToken()){
+		fixpoint_check(fixpoint_detail::in_range(num, fix64::min, fix64::max), truncation, num, "Truncation error constructing fix64<" << fractional_bits << ">(double num) with num=" << num << ". 'num' is outside of the range of representable numbers [fix64<" << fractional_bits << ">::min, fix64<" << fractional_bits << ">::max]=[" << fix64<fractional_bits>::min << ", " << fix64<fractional_bits>::max << "].");
+	}
+
+	// constructors without range checks, see fixpoint_unchecked::convert()
+	class UncheckedToken{};
+
+	constexpr fix64(int64_t number, UncheckedToken) : value(static_cast<int64_t>(static_cast<uint64_t>(number) << fractional_bits)){}
+
+	template<typename Integer, std::enable_if_t<std::is_integral<Integer>::value, bool> = true>
+	constexpr fix64(Integer number, UncheckedToken t) : fix64(static_cast<int64_t>(number), t){}
+
+	inline fix64(float num, UncheckedToken) : value(0) {
 		if (num != 0.f) {
 			const uint32_t inum = *reinterpret_cast<const uint32_t*>(&num);
 			const uint32_t float_mantissa = (inum & ((1 << 23) - 1)) | (1 << 23);
@@ -62,83 +147,11 @@ public:
 		}
 	}
 	
-	inline fix64(double num) : fix64(static_cast<float>(num)){}
+	inline fix64(double num, UncheckedToken t) : fix64(static_cast<float>(num), t){}
 	
 	constexpr fix64(const char* str, int radix = 10) : value(0) {
-		bool sign = false;
-		uint64_t digits = 0;
-		uint64_t fractions = 0;
-		char const * const str_first = str;
-		
-		// parse sign
-		if (*str == '-') {
-			sign = true;
-			++str;
-		}
-
-		//select radix
-		if (*str == '0') {
-			++str;
-			switch (*str) {
-				case 'b': {++str; radix = 2; } break;
-				case 'o': {++str; radix = 8; } break;
-				case 'd': {++str; radix = 10; } break;
-				case 'x': case 'X': {++str; radix = 16; } break;
-				default: break;
-			}
-		}
-
-		// select ranges
-		char digit_first = '0';
-		char digit_last = '0' + ((radix <= 10) ? (radix) : 10);
-		char alpha_first = 'a';
-		char alpha_last = 'a' + ((radix > 10) ? radix - 10 : 0);
-		char ALPHA_first = 'A';
-		char ALPHA_last = 'A' + ((radix > 10) ? radix - 10 : 0);
-
-
-		// parse digits
-		while (true) {
-			if (digit_first <= *str && *str <= digit_last) {
-				digits = digits * radix + (*str - digit_first);
-			}else if (alpha_first <= *str && *str <= alpha_last) {
-				digits = digits * radix + (*str - alpha_first + 10);
-			}else if (ALPHA_first <= *str && *str <= ALPHA_last) {
-				digits = digits * radix + (*str - ALPHA_first + 10);
-			}else {
-				break;
-			}
-			++str;
-		}
-		digits <<= fractional_bits;
-
-		// parse fractions
-		if (*str == '.') {
-			++str;
-			size_t s = radix;
-			while (true) {
-				if (digit_first <= *str && *str <= digit_last) {
-					fractions = fractions + ((static_cast<uint64_t>(*str) - static_cast<uint64_t>(digit_first)) << 60) / s;
-				}else if (alpha_first <= *str && *str <= alpha_last) {
-					fractions = fractions + ((static_cast<uint64_t>(*str) - static_cast<uint64_t>(alpha_first) + 10) << 60) / s;
-				}else if (ALPHA_first <= *str && *str <= ALPHA_last) {
-					fractions = fractions + ((static_cast<uint64_t>(*str) - static_cast<uint64_t>(ALPHA_first) + 10) << 60) / s;
-				}else {
-					break;
-				}
-				++str;
-				size_t new_s = s * radix;
-				s = (new_s > s) ? new_s : 0; //overflow protection
-			}
-
-			// shift fractions to the correct binary point
-			int shifts = static_cast<int>(60) - static_cast<int>(fractional_bits);
-			fractions = (shifts >= 0) ? fractions >> shifts : fractions << -shifts;
-		}
-
-		const uint64_t abs_value = digits | fractions;
-		const int64_t result = sign ? (-static_cast<int64_t>(abs_value)) : static_cast<int64_t>(abs_value);
-		this->value = result;
+		fixpoint_detail::string_source source{str};
+		this->value = static_cast<int64_t>(fixpoint_detail::parse_radix<uint64_t, 60>(source, fractional_bits, radix));
 	}
 
 	inline fix64& assign(const char* str, int radix = 10) {
@@ -160,6 +173,7 @@ public:
 	constexpr friend fix64 operator+ (fix64 lhs, fix64 rhs){
 		fix64 result;
 		result.value = lhs.value + rhs.value;
+		fixpoint_instrument_arithmetic(fixpoint_detail::sum_fits_int64(lhs.value, rhs.value), overflow, fixpoint_detail::raw_to_double(static_cast<double>(lhs.value) + rhs.value, fractional_bits));
 		return result;
 	}
 	
@@ -172,41 +186,16 @@ public:
 	constexpr friend fix64 operator- (fix64 lhs, fix64 rhs){
 		fix64 result;
 		result.value = lhs.value - rhs.value;
+		fixpoint_instrument_arithmetic(fixpoint_detail::difference_fits_int64(lhs.value, rhs.value), overflow, fixpoint_detail::raw_to_double(static_cast<double>(lhs.value) - rhs.value, fractional_bits));
 		return result;
 	}
 	
 	constexpr friend fix64 operator* (fix64 lhs, fix64 rhs){
-		/*
-			Perform the following multiplication:
-				(a * 2^32 + b) * (c * 2^32 + d)
-		*/
-		const uint64_t a = (static_cast<uint64_t>(lhs.value) >> 32) & ((1ULL<<32)-1);
-		const uint64_t b = static_cast<uint64_t>(lhs.value) & ((1ULL<<32)-1);
-		
-		const uint64_t c = (static_cast<uint64_t>(rhs.value) >> 32) & ((1ULL<<32)-1);
-		const uint64_t d = static_cast<uint64_t>(rhs.value) & ((1ULL<<32)-1);
-		
-		const uint64_t ac = a * c;
-		const uint64_t bc = b * c;
-		const uint64_t ad = a * d;
-		const uint64_t bd = b * d;
-		
-		const uint64_t ad_bc = bc + ad;
-		const bool ad_bc_carrie = (ad_bc < bc || ad_bc < ad);
-		
-		const uint64_t ad_bc_upper = (ad_bc >> 32) & ((1ULL<<32)-1) | (ad_bc_carrie ? (1ULL << 32) : (0ULL));
-		const uint64_t ad_bc_lower = ad_bc & ((1ULL<<32)-1);
-		
-		const uint64_t ad_bc_lower_shifted = (ad_bc_lower << 32);
-		const uint64_t result_lower = bd + ad_bc_lower_shifted;
-		const bool result_carrie = (result_lower < bd || result_lower < ad_bc_lower_shifted);
-		
-		const uint64_t result_upper = ac + ad_bc_upper + result_carrie;
-		
-		const uint64_t result_value = (result_upper << (64 - fractional_bits)) | (result_lower >> fractional_bits);
-		
-		const fix64 result = fix64::reinterpret(result_value);
-		return result;
+		// the signed 128-bit product, shifted down and rounded down, wrapped around to 64 bits
+		bool overflowed = false;
+		const int64_t product = fixpoint_detail::multiply_shift(lhs.value, rhs.value, fractional_bits, overflowed);
+		fixpoint_instrument_arithmetic(!overflowed, overflow, fixpoint_detail::raw_to_double(static_cast<double>(lhs.value) * rhs.value, 2 * fractional_bits));
+		return fix64::reinterpret(product);
 	}
 	
 	template<typename Integer, std::enable_if_t<std::is_integral<Integer>::value, bool> = true>
@@ -220,8 +209,12 @@ public:
 	}
 
 	constexpr friend fix64 operator/ (fix64 lhs, fix64 rhs){
-		fixpoint_assert(rhs != 0, "Error: fixpoint division by zero");
-		
+		fixpoint_check(rhs != 0, divide_by_zero, lhs, "Error: fixpoint division by zero");
+		return fix64::divide(lhs, rhs, UncheckedToken());
+	}
+
+	// division without the check for zero, see fixpoint_unchecked::divide()
+	static constexpr fix64 divide(fix64 lhs, fix64 rhs, UncheckedToken){
 		bool sign_lhs = lhs < 0;
 		bool sign_rhs = rhs < 0;
 		
@@ -240,7 +233,8 @@ public:
 		
 		if(lhs_upper == 0){
 			// shortcut
-			return fix64::reinterpret(lhs_lower / rhs_abs);
+			const fix64 result = fix64::reinterpret(lhs_lower / rhs_abs);
+			return (sign_lhs == sign_rhs) ? result : -result;
 		}
 		
 		// shift up rhs until it is larger or equal to [uppper, lower]
@@ -290,6 +284,11 @@ public:
 	
 	template<typename Integer, std::enable_if_t<std::is_integral<Integer>::value, bool> = true>
 	constexpr friend fix64 operator/ (fix64 lhs, Integer rhs){
+		return fix64::divide(lhs, rhs, UncheckedToken());
+	}
+
+	template<typename Integer, std::enable_if_t<std::is_integral<Integer>::value, bool> = true>
+	static constexpr fix64 divide(fix64 lhs, Integer rhs, UncheckedToken){
 		return fix64::reinterpret(lhs.value / static_cast<int64_t>(rhs));
 	}
 
@@ -323,12 +322,12 @@ public:
 	explicit constexpr operator uint64_t () const {return static_cast<uint64_t>(this->value >> fractional_bits);}
 	
 	explicit constexpr operator float () const {
-		float result = static_cast<float>(this->value) / (1 << fractional_bits);
+		float result = static_cast<float>(this->value) / static_cast<float>(static_cast<int64_t>(1) << fractional_bits);
 		return result;
 	}
 	
 	explicit constexpr operator double () const {
-		double result = static_cast<double>(this->value) / (1 << fractional_bits);
+		double result = static_cast<double>(this->value) / static_cast<double>(static_cast<int64_t>(1) << fractional_bits);
 		return result;
 	}
 	
@@ -347,7 +346,7 @@ public:
 		uint64_t digits = f.value >> fractional_bits;
 		uint64_t fractionals = f.value & ((1ULL << fractional_bits) - 1);
 
-		int significant_places = 0;
+		size_t significant_places = 0;
 		bool count_significant_enable = digits != 0;
 
 		// print digits and decimal point
@@ -370,83 +369,71 @@ public:
 	template<class Stream>
 	friend inline Stream& operator<<(Stream& stream, fix64 f){return print(stream, f);}
 
-	template<class Stream>
-	friend Stream& operator>>(Stream& stream, fix64& f){
-		bool sign = false;
-		uint64_t digits = 0;
-		uint64_t fractions = 0;
-		int radix = 10;
-		
-		// parse sign
-		if (stream.peek() == '-') {
-			sign = true;
-			stream.get();
-		}
+	// writes f in decimal to [first, last) without allocating. With a negative precision the shortest
+	// string that reads back as f is written, otherwise exactly 'precision' correctly rounded digits after the decimal point.
+	friend fix_to_chars_result to_chars(char* first, char* last, fix64 f, int precision = -1){
+		const bool negative = f.value < 0;
+		const uint64_t magnitude = negative ? (0 - static_cast<uint64_t>(f.value)) : static_cast<uint64_t>(f.value);
+		const uint64_t mask = (1ULL << fractional_bits) - 1;
+		return fixpoint_detail::to_chars_fixed(first, last, negative, magnitude >> fractional_bits, magnitude & mask, static_cast<int>(fractional_bits), precision);
+	}
 
-		//select radix
-		if (stream.peek() == '0') {
-			stream.get();
-			switch (stream.peek()) {
-				case 'b': {stream.get(); radix = 2; } break;
-				case 'o': {stream.get(); radix = 8; } break;
-				case 'd': {stream.get(); radix = 10; } break;
-				case 'x': case 'X': {stream.get(); radix = 16; } break;
-				default: break;
-			}
+	// reads a decimal number with the pattern -?[0-9]*(.[0-9]*)? from [first, last), correctly rounded to the nearest.
+	// f is only assigned on success.
+	friend fix_from_chars_result from_chars(const char* first, const char* last, fix64& f){
+		bool negative = false;
+		uint64_t magnitude = 0;
+		const fix_from_chars_result result = fixpoint_detail::from_chars_fixed(first, last, static_cast<int>(fractional_bits), 0x7FFFFFFFFFFFFFFFULL, 0x8000000000000000ULL, negative, magnitude);
+		if(result.ec == std::errc()){
+			f.value = static_cast<int64_t>(negative ? (0 - magnitude) : magnitude);
 		}
+		return result;
+	}
 
-		// select ranges
-		char digit_first = '0';
-		char digit_last = '0' + ((radix <= 10) ? (radix) : 10);
-		char alpha_first = 'a';
-		char alpha_last = 'a' + ((radix > 10) ? radix - 10 : 0);
-		char ALPHA_first = 'A';
-		char ALPHA_last = 'A' + ((radix > 10) ? radix - 10 : 0);
-
-
-		// parse digits
-		while (true) {
-			if (digit_first <= stream.peek() && stream.peek() <= digit_last) {
-				digits = digits * radix + (stream.peek() - digit_first);
-			}else if (alpha_first <= stream.peek() && stream.peek() <= alpha_last) {
-				digits = digits * radix + (stream.peek() - alpha_first + 10);
-			}else if (ALPHA_first <= stream.peek() && stream.peek() <= ALPHA_last) {
-				digits = digits * radix + (stream.peek() - ALPHA_first + 10);
-			}else {
-				break;
-			}
-			stream.get();
-		}
-		digits <<= fractional_bits;
-
-		// parse fractions
-		if (stream.peek() == '.') {
-			stream.get();
-			size_t s = radix;
-			while (true) {
-				if (digit_first <= stream.peek() && stream.peek() <= digit_last) {
-					fractions = fractions + ((static_cast<uint64_t>(stream.peek()) - static_cast<uint64_t>(digit_first)) << 60) / s;
-				}else if (alpha_first <= stream.peek() && stream.peek() <= alpha_last) {
-					fractions = fractions + ((static_cast<uint64_t>(stream.peek()) - static_cast<uint64_t>(alpha_first) + 10) << 60) / s;
-				}else if (ALPHA_first <= stream.peek() && stream.peek() <= ALPHA_last) {
-					fractions = fractions + ((static_cast<uint64_t>(stream.peek()) - static_cast<uint64_t>(ALPHA_first) + 10) << 60) / s;
-				}else {
-					break;
-				}
-				stream.get();
-				size_t new_s = s * radix;
-				s = (new_s > s) ? new_s : 0; //overflow protection
-			}
+	template<class Stream>
+	friend Stream& operator>>(Stream& stream, fix64& f){
+		f = fix64::reinterpret(static_cast<int64_t>(fixpoint_detail::read_radix<uint64_t, 60>(stream, fractional_bits, 0)));
+		return stream;
+	}
+};
 
-			// shift fractions to the correct binary point
-			int shifts = static_cast<int>(60) - static_cast<int>(fractional_bits);
-			fractions = (shifts >= 0) ? fractions >> shifts : fractions << -shifts;
-		}
+/*
+	Conversion of an integer or floating point number, that returns an error code instead of
+	raising an error. Returns std::errc::result_out_of_range if num is not representable, result is
+	only assigned on success.
+*/
+template<size_t fractional_bits, class Number>
+std::errc try_convert(Number num, fix64<fractional_bits>& result){
+	if(!fixpoint_detail::in_range(num, INT64_MIN >> fractional_bits, INT64_MAX >> fractional_bits)){
+		return std::errc::result_out_of_range;
+	}
+	result = fixpoint_unchecked::convert<fix64<fractional_bits>>(num);
+	return std::errc();
+}
 
-		const uint64_t abs_value = digits | fractions;
-		const int64_t value = sign ? (-static_cast<int64_t>(abs_value)) : static_cast<int64_t>(abs_value);
-		
-		f = fix64::reinterpret(value);
-		return stream;
+/*
+	Division, that returns std::errc::argument_out_of_domain for a division by zero and std::errc::result_out_of_range
+	if the quotient is not representable, instead of raising an error. result is only assigned on success.
+*/
+template<size_t fractional_bits>
+constexpr std::errc try_divide(fix64<fractional_bits> lhs, fix64<fractional_bits> rhs, fix64<fractional_bits>& result){
+	if(rhs == 0){
+		return std::errc::argument_out_of_domain;
+	}
+	// the quotient of the magnitudes L * 2^fractional_bits / R is at least 2^63, if L >= R * 2^(63 - fractional_bits)
+	const bool negative = (lhs < 0) != (rhs < 0);
+	const uint64_t lhs_abs = (lhs < 0) ? 0 - static_cast<uint64_t>(lhs.reinterpret_as_int64()) : static_cast<uint64_t>(lhs.reinterpret_as_int64());
+	const uint64_t rhs_abs = (rhs < 0) ? 0 - static_cast<uint64_t>(rhs.reinterpret_as_int64()) : static_cast<uint64_t>(rhs.reinterpret_as_int64());
+	const size_t shift = 63 - fractional_bits;
+	if(rhs_abs <= (~0ULL >> shift) && lhs_abs >= (rhs_abs << shift)){
+		// only -2^63 is representable, if the quotient rounds down to it
+		const uint64_t excess = lhs_abs - (rhs_abs << shift);
+		if(!negative || excess > ((rhs_abs - 1) >> fractional_bits)){
+			return std::errc::result_out_of_range;
+		}
+		result = fix64<fractional_bits>::reinterpret(INT64_MIN);
+		return std::errc();
 	}
-};
\ No newline at end of file
+	result = fix64<fractional_bits>::divide(lhs, rhs, typename fix64<fractional_bits>::UncheckedToken());
+	return std::errc();
+}
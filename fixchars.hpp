@@ -0,0 +1,474 @@
+#pragma once
+/*
+
+	Author: Tobias Wallner
+	tobias.wallner1@gmx.net
+
+	Allocation free conversions between fixed-point numbers and decimal character sequences.
+	The friend functions to_chars() and from_chars() of fix32 and fix64 are implemented with
+	the raw integer functions in here, so that both share one implementation.
+
+	The string constructors and operator>> share parse_radix(), which reads characters from
+	a null terminated string, from the get area of a std::streambuf or through peek() and get().
+
+*/
+
+#include <cstddef>
+#include <cinttypes>
+#include <cstring>
+#include <system_error>
+#include <iosfwd>
+#include <type_traits>
+
+// 8 digits can be converted at once on little endian targets
+#if (defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)) || defined(_M_X64) || defined(_M_IX86) || defined(_M_ARM64)
+	#define FIXPOINT_SWAR_DIGITS
+#endif
+
+// result of to_chars(), like std::to_chars_result of C++17
+struct fix_to_chars_result{
+	char* ptr;
+	std::errc ec;
+};
+
+// result of from_chars(), like std::from_chars_result of C++17
+struct fix_from_chars_result{
+	const char* ptr;
+	std::errc ec;
+};
+
+namespace fixpoint_detail{
+
+	// returns the upper 64 bits of x * 10 and stores the lower 64 bits in lower
+	inline uint64_t mul10(uint64_t x, uint64_t& lower){
+		const uint64_t upper_product = (x >> 32) * 10;
+		const uint64_t lower_product = (x & 0xFFFFFFFFULL) * 10;
+		const uint64_t shifted = upper_product << 32;
+		lower = shifted + lower_product;
+		return (upper_product >> 32) + (lower < shifted);
+	}
+
+	// returns (digit * 2^64 + x) / 10 and stores the remainder in remainder
+	inline uint64_t div10(uint64_t digit, uint64_t x, uint64_t& remainder){
+		const uint64_t upper = (digit << 32) | (x >> 32);
+		const uint64_t upper_quotient = upper / 10;
+		const uint64_t lower = ((upper % 10) << 32) | (x & 0xFFFFFFFFULL);
+		const uint64_t lower_quotient = lower / 10;
+		remainder = lower % 10;
+		return (upper_quotient << 32) | lower_quotient;
+	}
+
+	// returns 10^exponent for exponent in [0, 19]
+	inline uint64_t pow10(int exponent){
+		static const uint64_t table[20] = {
+			1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL,
+			10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+			1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL
+		};
+		return table[exponent];
+	}
+
+#if defined(FIXPOINT_SWAR_DIGITS)
+	// returns true if the 8 characters at str are all decimal digits
+	inline bool is_eight_digits(const char* str){
+		uint64_t chunk;
+		std::memcpy(&chunk, str, 8);
+		return ((chunk & 0xF0F0F0F0F0F0F0F0ULL) | (((chunk + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) == 0x3333333333333333ULL;
+	}
+
+	// returns the value of the 8 decimal digits at str, with 3 multiplications instead of 8
+	inline uint64_t eight_digits_value(const char* str){
+		uint64_t chunk;
+		std::memcpy(&chunk, str, 8);
+		chunk -= 0x3030303030303030ULL;
+		chunk = (chunk * 10) + (chunk >> 8);
+		return (((chunk & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) + (((chunk >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+	}
+#endif
+
+	/*
+		Writes the number (negative ? -1 : 1) * (integer + fraction / 2^fractional_bits) in decimal to [first, last).
+
+		precision < 0:	the shortest representation that from_chars() reads back as the same number.
+						Integral numbers are written without a decimal point.
+		precision >= 0:	exactly 'precision' digits after the decimal point, correctly rounded (ties to even).
+
+		fractional_bits has to be in [0, 63].
+	*/
+	inline fix_to_chars_result to_chars_fixed(char* first, char* last, bool negative, uint64_t integer, uint64_t fraction, int fractional_bits, int precision){
+		// the exact decimal expansion of a binary fraction with n bits has n digits, so at most 63 are ever needed
+		char digits[64];
+		int count = 0;
+		bool round_up = false;
+
+		if(fractional_bits > 0){
+			const uint64_t mask = (1ULL << fractional_bits) - 1;
+			const uint64_t half = 1ULL << (fractional_bits - 1);
+			const auto next_digit = [&](){
+				uint64_t lower;
+				const uint64_t upper = mul10(fraction, lower);
+				digits[count++] = static_cast<char>((upper << (64 - fractional_bits)) | (lower >> fractional_bits));
+				fraction = lower & mask;
+			};
+
+			if(precision < 0){
+				// stop as soon as the remaining distance to the written digits or to the next larger
+				// ones is less than half a unit in the last place, (10^count / 2) in units of the remainder.
+				uint64_t margin = 1;
+				while(fraction != 0){
+					next_digit();
+					margin *= 10;
+					const bool round_down_ok = 2 * fraction < margin;
+					const bool round_up_ok = fraction != 0 && 2 * ((mask - fraction) + 1) < margin;
+					if(round_down_ok || round_up_ok){
+						if(round_down_ok && round_up_ok){
+							round_up = (fraction > half) || (fraction == half && (digits[count-1] & 1));
+						}else{
+							round_up = round_up_ok;
+						}
+						break;
+					}
+				}
+			}else{
+				const int exact_digits = (precision < 64) ? precision : 64;
+				while(count < exact_digits && fraction != 0){
+					next_digit();
+				}
+				round_up = (fraction > half) || (fraction == half && ((count == 0) ? (integer & 1) : (digits[count-1] & 1)));
+			}
+		}
+
+		// propagate the rounding through the fraction into the integer
+		if(round_up){
+			int i = count - 1;
+			while(i >= 0 && digits[i] == 9){
+				digits[i] = 0;
+				--i;
+			}
+			if(i >= 0){
+				++digits[i];
+			}else{
+				++integer;
+			}
+		}
+		if(precision < 0){
+			while(count > 0 && digits[count-1] == 0){
+				--count;
+			}
+		}
+
+		// integer digits, generated in reverse
+		char integer_digits[20];
+		int integer_count = 0;
+		do{
+			integer_digits[integer_count++] = static_cast<char>('0' + integer % 10);
+			integer /= 10;
+		}while(integer != 0);
+
+		const int fraction_count = (precision < 0) ? count : precision;
+		const size_t length = static_cast<size_t>(negative) + integer_count + ((fraction_count > 0) ? 1 + fraction_count : 0);
+		if(static_cast<size_t>(last - first) < length){
+			return fix_to_chars_result{last, std::errc::value_too_large};
+		}
+
+		if(negative){
+			*first++ = '-';
+		}
+		while(integer_count > 0){
+			*first++ = integer_digits[--integer_count];
+		}
+		if(fraction_count > 0){
+			*first++ = '.';
+			for(int i = 0; i < fraction_count; ++i){
+				*first++ = static_cast<char>('0' + ((i < count) ? digits[i] : 0));
+			}
+		}
+		return fix_to_chars_result{first, std::errc()};
+	}
+
+	/*
+		Reads a decimal number with the pattern -?[0-9]*(.[0-9]*)? with at least one digit from [first, last),
+		correctly rounded to fractional_bits in [0, 63] (ties to even).
+		On success stores the sign in negative and the magnitude in raw units in magnitude.
+		Returns std::errc::result_out_of_range if the magnitude is larger than max_positive or max_negative.
+	*/
+	inline fix_from_chars_result from_chars_fixed(const char* first, const char* last, int fractional_bits, uint64_t max_positive, uint64_t max_negative, bool& negative, uint64_t& magnitude){
+		const char* str = first;
+		const bool sign = (str != last && *str == '-');
+		str += sign;
+
+		// integer part
+		const uint64_t integer_limit = max_negative >> fractional_bits;
+		uint64_t integer = 0;
+		bool overflow = false;
+		const char* const integer_first = str;
+#if defined(FIXPOINT_SWAR_DIGITS)
+		for(; last - str >= 8 && is_eight_digits(str); str += 8){
+			overflow |= integer > integer_limit / 100000000ULL;
+			integer = integer * 100000000ULL + eight_digits_value(str);
+			overflow |= integer > integer_limit;
+		}
+#endif
+		for(; str != last && '0' <= *str && *str <= '9'; ++str){
+			overflow |= integer > integer_limit / 10;
+			integer = integer * 10 + static_cast<uint64_t>(*str - '0');
+			overflow |= integer > integer_limit;
+		}
+		bool has_digits = str != integer_first;
+
+		// fraction part as a 64-bit binary fraction, truncated, where 'inexact' remembers if bits were lost.
+		// longer fractions are summed from the last digit to the first with fraction = (digit + fraction) / 10
+		uint64_t fraction = 0;
+		bool inexact = false;
+		if(str != last && *str == '.'){
+			const char* const fraction_first = ++str;
+#if defined(FIXPOINT_SWAR_DIGITS)
+			while(last - str >= 8 && is_eight_digits(str)){
+				str += 8;
+			}
+#endif
+			while(str != last && '0' <= *str && *str <= '9'){
+				++str;
+			}
+			has_digits |= str != fraction_first;
+			const int count = static_cast<int>(str - fraction_first);
+#if defined(__SIZEOF_INT128__)
+			if(count <= 19){
+				// up to 19 digits fit into 64 bits: fraction = digits * 2^64 / 10^count, with a single division
+				uint64_t digits = 0;
+				const char* digit = fraction_first;
+	#if defined(FIXPOINT_SWAR_DIGITS)
+				for(; str - digit >= 8; digit += 8){
+					digits = digits * 100000000ULL + eight_digits_value(digit);
+				}
+	#endif
+				for(; digit != str; ++digit){
+					digits = digits * 10 + static_cast<uint64_t>(*digit - '0');
+				}
+				const unsigned __int128 scaled = static_cast<unsigned __int128>(digits) << 64;
+				const uint64_t divisor = pow10(count);
+				fraction = static_cast<uint64_t>(scaled / divisor);
+				inexact = static_cast<uint64_t>(scaled % divisor) != 0;
+			}else
+#endif
+			{
+				for(const char* digit = str; digit != fraction_first; ){
+					--digit;
+					uint64_t remainder;
+					fraction = div10(static_cast<uint64_t>(*digit - '0'), fraction, remainder);
+					inexact |= remainder != 0;
+				}
+			}
+		}
+
+		if(!has_digits){
+			return fix_from_chars_result{first, std::errc::invalid_argument};
+		}
+
+		// round the 64-bit fraction to fractional_bits, ties to even
+		const uint64_t half = 1ULL << (63 - fractional_bits);
+		const uint64_t rest = fraction & (2 * half - 1);
+		uint64_t result_fraction = (fractional_bits == 0) ? 0 : (fraction >> (64 - fractional_bits));
+		const uint64_t last_bit = (fractional_bits == 0) ? integer : result_fraction;
+		result_fraction += (rest > half) || (rest == half && (inexact || (last_bit & 1)));
+
+		const uint64_t limit = sign ? max_negative : max_positive;
+		const uint64_t result = overflow ? ~0ULL : (integer << fractional_bits) + result_fraction;
+		if(overflow || result > limit){
+			return fix_from_chars_result{str, std::errc::result_out_of_range};
+		}
+
+		negative = sign;
+		magnitude = result;
+		return fix_from_chars_result{str, std::errc()};
+	}
+
+	// ---------------- radix parsing ----------------
+
+	// source of parse_radix() that reads a null terminated string
+	struct string_source{
+		const char* str;
+
+		constexpr int peek() const {return *str;}
+		constexpr void advance(){++str;}
+	};
+
+	// source of parse_radix() for streams without a std::streambuf, that reads through peek() and get()
+	template<class Stream>
+	struct stream_source{
+		Stream& stream;
+
+		int peek(){return stream.peek();}
+		void advance(){stream.get();}
+	};
+
+	// grants access to the protected get area of a std::basic_streambuf
+	template<class Streambuf>
+	struct get_area : Streambuf{
+		using char_type = typename Streambuf::char_type;
+		static char_type* next(Streambuf* buf){return (buf->*(&get_area::gptr))();}
+		static char_type* end(Streambuf* buf){return (buf->*(&get_area::egptr))();}
+		static void bump(Streambuf* buf, int count){(buf->*(&get_area::gbump))(count);}
+	};
+
+	/*
+		Source of parse_radix() that reads straight from the get area of a std::basic_streambuf.
+		The fast path walks the characters in [next, end) and the refill path, taken at the end of the
+		get area, hands the consumed characters back to the streambuf with sync() and lets sgetc() refill it.
+		Unbuffered streambufs, that keep the get area empty, are read one character at a time.
+	*/
+	template<class Streambuf>
+	struct streambuf_source{
+		using access = get_area<Streambuf>;
+		using char_type = typename Streambuf::char_type;
+		using traits_type = typename Streambuf::traits_type;
+
+		Streambuf* buf;
+		char_type* next;
+		char_type* end;
+		bool eof = false;
+
+		explicit streambuf_source(Streambuf* buf) : buf(buf), next(access::next(buf)), end(access::end(buf)){}
+
+		int peek(){
+			if(next == end){
+				sync();
+				const typename traits_type::int_type c = buf->sgetc();
+				if(traits_type::eq_int_type(c, traits_type::eof())){
+					eof = true;
+					return -1;
+				}
+				next = access::next(buf);
+				end = access::end(buf);
+				if(next == end){
+					return static_cast<int>(c);
+				}
+			}
+			return static_cast<int>(traits_type::to_int_type(*next));
+		}
+
+		void advance(){
+			if(next != end){
+				++next;
+			}else{
+				buf->sbumpc();
+				next = end = access::next(buf);
+			}
+		}
+
+		// moves the position of the streambuf to the next unread character
+		void sync(){
+			char_type* const position = access::next(buf);
+			if(next != position){
+				access::bump(buf, static_cast<int>(next - position));
+			}
+			next = end = access::next(buf);
+		}
+	};
+
+	/*
+		Parses [-][0b|0o|0d|0x]digits[.digits] from source, where the prefix selects the radix, and
+		returns the raw value with fractional_bits. Unsigned is the raw type and the fraction is
+		accumulated with fraction_bits before it is shifted to fractional_bits.
+	*/
+	template<class Unsigned, int fraction_bits, class Source>
+	constexpr Unsigned parse_radix(Source& source, size_t fractional_bits, int radix){
+		bool sign = false;
+		Unsigned digits = 0;
+		Unsigned fractions = 0;
+
+		// parse sign
+		if (source.peek() == '-') {
+			sign = true;
+			source.advance();
+		}
+
+		// select radix
+		if (source.peek() == '0') {
+			source.advance();
+			switch (source.peek()) {
+				case 'b': {source.advance(); radix = 2; } break;
+				case 'o': {source.advance(); radix = 8; } break;
+				case 'd': {source.advance(); radix = 10; } break;
+				case 'x': case 'X': {source.advance(); radix = 16; } break;
+				default: break;
+			}
+		}
+
+		// select ranges
+		const char digit_first = '0';
+		const char digit_last = '0' + ((radix <= 10) ? (radix) : 10);
+		const char alpha_first = 'a';
+		const char alpha_last = 'a' + ((radix > 10) ? radix - 10 : 0);
+		const char ALPHA_first = 'A';
+		const char ALPHA_last = 'A' + ((radix > 10) ? radix - 10 : 0);
+
+		// parse digits
+		while (true) {
+			const int c = source.peek();
+			if (digit_first <= c && c <= digit_last) {
+				digits = digits * radix + (c - digit_first);
+			}else if (alpha_first <= c && c <= alpha_last) {
+				digits = digits * radix + (c - alpha_first + 10);
+			}else if (ALPHA_first <= c && c <= ALPHA_last) {
+				digits = digits * radix + (c - ALPHA_first + 10);
+			}else {
+				break;
+			}
+			source.advance();
+		}
+		digits <<= fractional_bits;
+
+		// parse fractions
+		if (source.peek() == '.') {
+			source.advance();
+			size_t s = radix;
+			while (true) {
+				const int c = source.peek();
+				if (digit_first <= c && c <= digit_last) {
+					fractions = fractions + ((static_cast<Unsigned>(c) - static_cast<Unsigned>(digit_first)) << fraction_bits) / s;
+				}else if (alpha_first <= c && c <= alpha_last) {
+					fractions = fractions + ((static_cast<Unsigned>(c) - static_cast<Unsigned>(alpha_first) + 10) << fraction_bits) / s;
+				}else if (ALPHA_first <= c && c <= ALPHA_last) {
+					fractions = fractions + ((static_cast<Unsigned>(c) - static_cast<Unsigned>(ALPHA_first) + 10) << fraction_bits) / s;
+				}else {
+					break;
+				}
+				source.advance();
+				size_t new_s = s * radix;
+				s = (new_s > s) ? new_s : 0; //overflow protection
+			}
+
+			// shift fractions to the correct binary point
+			int shifts = static_cast<int>(fraction_bits) - static_cast<int>(fractional_bits);
+			fractions = (shifts >= 0) ? fractions >> shifts : fractions << -shifts;
+		}
+
+		const Unsigned abs_value = digits | fractions;
+		return sign ? static_cast<Unsigned>(0 - abs_value) : abs_value;
+	}
+
+	// reads with parse_radix() from the streambuf of a std::basic_istream, with the same state changes as peek() and get()
+	template<class Unsigned, int fraction_bits, class Stream>
+	auto read_radix(Stream& stream, size_t fractional_bits, int) -> decltype(stream.rdbuf()->sgetc(), Unsigned()){
+		const typename std::basic_istream<typename Stream::char_type, typename Stream::traits_type>::sentry sentry(stream, true);
+		if(!sentry){
+			return 0;
+		}
+		streambuf_source<typename std::remove_pointer<decltype(stream.rdbuf())>::type> source(stream.rdbuf());
+		const Unsigned value = parse_radix<Unsigned, fraction_bits>(source, fractional_bits, 10);
+		source.sync();
+		// peek() sets eofbit at the end and failbit on the next call, which the parser always makes
+		if(source.eof){
+			stream.setstate(Stream::eofbit | Stream::failbit);
+		}
+		return value;
+	}
+
+	// reads with parse_radix() through peek() and get() of any other stream
+	template<class Unsigned, int fraction_bits, class Stream>
+	Unsigned read_radix(Stream& stream, size_t fractional_bits, long){
+		stream_source<Stream> source{stream};
+		return parse_radix<Unsigned, fraction_bits>(source, fractional_bits, 10);
+	}
+}
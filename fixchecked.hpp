@@ -0,0 +1,202 @@
+#pragma once
+/*
+
+	Author: Tobias Wallner
+	tobias.wallner1@gmx.net
+
+	Checked arithmetic for fix32 and fix64, that reports overflows with a flag instead of raising an error.
+	Nothing in here throws, allocates or formats a message, so it can be used in real-time threads.
+
+	overflowing_add/sub/mul/div(lhs, rhs, overflow)
+		return the exact sum and difference, the product rounded down (floor) and the quotient rounded
+		towards zero, wrapped around to the width of the format on overflow, and set the sticky flag
+		'overflow' if the result is not representable. A division by zero returns 0 and sets the flag.
+		Chain as many operations as needed and test the flag once at the end.
+
+	checked_add/sub/mul/div(lhs, rhs, result)
+		assign the same result and return true if it is representable.
+
+	checked_add/sub/mul/div(lhs, rhs, out, count, overflow_mask)
+		work element-wise on arrays of count values, and set bit i % 64 of overflow_mask[i / 64]
+		for every element i that overflowed. The mask needs (count + 63) / 64 words.
+		Return true if no element overflowed. out may be lhs or rhs.
+
+	The checks use __builtin_add_overflow and __builtin_sub_overflow where available, the 64-bit product
+	for fix32 and the 128-bit product for fix64. Addition, subtraction and multiplication compile
+	without branches, and all of them are constexpr.
+
+	Example:
+		bool overflow = false;
+		const fix32<16> y = overflowing_add(overflowing_mul(gain, x, overflow), offset, overflow);
+		if(overflow){ ... }
+*/
+
+#include <cstddef>
+#include <cinttypes>
+#include <system_error>
+#include <type_traits>
+
+#include "fix32.hpp"
+#include "fix64.hpp"
+
+namespace fixpoint_detail{
+
+	// store the sum or difference of a and b wrapped around in result, and return true if it overflowed
+	template<class Int>
+	constexpr bool add_overflow(Int a, Int b, Int& result){
+#if defined(__GNUC__)
+		return __builtin_add_overflow(a, b, &result);
+#else
+		using Unsigned = std::make_unsigned_t<Int>;
+		result = static_cast<Int>(static_cast<Unsigned>(a) + static_cast<Unsigned>(b));
+		return ((a ^ result) & (b ^ result)) < 0;
+#endif
+	}
+
+	template<class Int>
+	constexpr bool sub_overflow(Int a, Int b, Int& result){
+#if defined(__GNUC__)
+		return __builtin_sub_overflow(a, b, &result);
+#else
+		using Unsigned = std::make_unsigned_t<Int>;
+		result = static_cast<Int>(static_cast<Unsigned>(a) - static_cast<Unsigned>(b));
+		return ((a ^ b) & (a ^ result)) < 0;
+#endif
+	}
+
+	// applies operation(lhs[i], rhs[i], overflow) to count elements and collects the overflows in 64-bit masks
+	template<class Fix, class Operation>
+	bool checked_elements(const Fix* lhs, const Fix* rhs, Fix* out, size_t count, uint64_t* overflow_mask, Operation operation){
+		uint64_t any = 0;
+		for(size_t first = 0; first < count; first += 64){
+			const size_t n = (count - first < 64) ? count - first : 64;
+			uint64_t mask = 0;
+			for(size_t j = 0; j < n; ++j){
+				bool overflow = false;
+				out[first + j] = operation(lhs[first + j], rhs[first + j], overflow);
+				mask |= static_cast<uint64_t>(overflow) << j;
+			}
+			overflow_mask[first / 64] = mask;
+			any |= mask;
+		}
+		return any == 0;
+	}
+}
+
+// fix32
+
+template<size_t fractional_bits>
+constexpr fix32<fractional_bits> overflowing_add(fix32<fractional_bits> lhs, fix32<fractional_bits> rhs, bool& overflow){
+	int32_t result = 0;
+	overflow |= fixpoint_detail::add_overflow(lhs.reinterpret_as_int32(), rhs.reinterpret_as_int32(), result);
+	return fix32<fractional_bits>::reinterpret(result);
+}
+
+template<size_t fractional_bits>
+constexpr fix32<fractional_bits> overflowing_sub(fix32<fractional_bits> lhs, fix32<fractional_bits> rhs, bool& overflow){
+	int32_t result = 0;
+	overflow |= fixpoint_detail::sub_overflow(lhs.reinterpret_as_int32(), rhs.reinterpret_as_int32(), result);
+	return fix32<fractional_bits>::reinterpret(result);
+}
+
+template<size_t fractional_bits>
+constexpr fix32<fractional_bits> overflowing_mul(fix32<fractional_bits> lhs, fix32<fractional_bits> rhs, bool& overflow){
+	const int64_t product = (static_cast<int64_t>(lhs.reinterpret_as_int32()) * rhs.reinterpret_as_int32()) >> fractional_bits;
+	overflow |= !fixpoint_detail::fits_int32(product);
+	return fix32<fractional_bits>::reinterpret(static_cast<int32_t>(static_cast<uint32_t>(product)));
+}
+
+template<size_t fractional_bits>
+constexpr fix32<fractional_bits> overflowing_div(fix32<fractional_bits> lhs, fix32<fractional_bits> rhs, bool& overflow){
+	// divides by 1 instead of 0, the result is replaced by 0 afterwards
+	const int32_t divisor = rhs.reinterpret_as_int32();
+	const bool zero = divisor == 0;
+	const int64_t quotient = (static_cast<int64_t>(lhs.reinterpret_as_int32()) * (static_cast<int64_t>(1) << fractional_bits)) / (divisor | static_cast<int32_t>(zero));
+	overflow |= zero || !fixpoint_detail::fits_int32(quotient);
+	return fix32<fractional_bits>::reinterpret(zero ? 0 : static_cast<int32_t>(static_cast<uint32_t>(quotient)));
+}
+
+// fix64
+
+template<size_t fractional_bits>
+constexpr fix64<fractional_bits> overflowing_add(fix64<fractional_bits> lhs, fix64<fractional_bits> rhs, bool& overflow){
+	int64_t result = 0;
+	overflow |= fixpoint_detail::add_overflow(lhs.reinterpret_as_int64(), rhs.reinterpret_as_int64(), result);
+	return fix64<fractional_bits>::reinterpret(result);
+}
+
+template<size_t fractional_bits>
+constexpr fix64<fractional_bits> overflowing_sub(fix64<fractional_bits> lhs, fix64<fractional_bits> rhs, bool& overflow){
+	int64_t result = 0;
+	overflow |= fixpoint_detail::sub_overflow(lhs.reinterpret_as_int64(), rhs.reinterpret_as_int64(), result);
+	return fix64<fractional_bits>::reinterpret(result);
+}
+
+template<size_t fractional_bits>
+constexpr fix64<fractional_bits> overflowing_mul(fix64<fractional_bits> lhs, fix64<fractional_bits> rhs, bool& overflow){
+	return fix64<fractional_bits>::reinterpret(fixpoint_detail::multiply_shift(lhs.reinterpret_as_int64(), rhs.reinterpret_as_int64(), fractional_bits, overflow));
+}
+
+// the long division of fix64 is not free of branches, the check itself is
+template<size_t fractional_bits>
+constexpr fix64<fractional_bits> overflowing_div(fix64<fractional_bits> lhs, fix64<fractional_bits> rhs, bool& overflow){
+	fix64<fractional_bits> result = fix64<fractional_bits>::reinterpret(0);
+	const std::errc error = try_divide(lhs, rhs, result);
+	overflow |= error != std::errc();
+	if(error == std::errc::result_out_of_range){
+		result = fix64<fractional_bits>::divide(lhs, rhs, typename fix64<fractional_bits>::UncheckedToken());
+	}
+	return result;
+}
+
+// single values
+
+template<class Fix>
+constexpr bool checked_add(Fix lhs, Fix rhs, Fix& result){
+	bool overflow = false;
+	result = overflowing_add(lhs, rhs, overflow);
+	return !overflow;
+}
+
+template<class Fix>
+constexpr bool checked_sub(Fix lhs, Fix rhs, Fix& result){
+	bool overflow = false;
+	result = overflowing_sub(lhs, rhs, overflow);
+	return !overflow;
+}
+
+template<class Fix>
+constexpr bool checked_mul(Fix lhs, Fix rhs, Fix& result){
+	bool overflow = false;
+	result = overflowing_mul(lhs, rhs, overflow);
+	return !overflow;
+}
+
+template<class Fix>
+constexpr bool checked_div(Fix lhs, Fix rhs, Fix& result){
+	bool overflow = false;
+	result = overflowing_div(lhs, rhs, overflow);
+	return !overflow;
+}
+
+// arrays
+
+template<class Fix>
+bool checked_add(const Fix* lhs, const Fix* rhs, Fix* out, size_t count, uint64_t* overflow_mask){
+	return fixpoint_detail::checked_elements(lhs, rhs, out, count, overflow_mask, [](Fix a, Fix b, bool& overflow){return overflowing_add(a, b, overflow);});
+}
+
+template<class Fix>
+bool checked_sub(const Fix* lhs, const Fix* rhs, Fix* out, size_t count, uint64_t* overflow_mask){
+	return fixpoint_detail::checked_elements(lhs, rhs, out, count, overflow_mask, [](Fix a, Fix b, bool& overflow){return overflowing_sub(a, b, overflow);});
+}
+
+template<class Fix>
+bool checked_mul(const Fix* lhs, const Fix* rhs, Fix* out, size_t count, uint64_t* overflow_mask){
+	return fixpoint_detail::checked_elements(lhs, rhs, out, count, overflow_mask, [](Fix a, Fix b, bool& overflow){return overflowing_mul(a, b, overflow);});
+}
+
+template<class Fix>
+bool checked_div(const Fix* lhs, const Fix* rhs, Fix* out, size_t count, uint64_t* overflow_mask){
+	return fixpoint_detail::checked_elements(lhs, rhs, out, count, overflow_mask, [](Fix a, Fix b, bool& overflow){return overflowing_div(a, b, overflow);});
+}
@@ -0,0 +1,329 @@
+#pragma once
+/*
+
+	Author: Tobias Wallner
+	tobias.wallner1@gmx.net
+
+	Lossless compression of fixed-point time series with delta-of-delta and zig-zag varints.
+
+	The values are split into blocks, that can be decoded independently:
+		varint count				number of values in the block
+		varint bytes				size of the payload
+		payload						count zig-zag varints of the second differences of the raw values
+
+	The second differences of v[0], v[1], ... are v[0], v[1] - 2*v[0], v[2] - 2*v[1] + v[0], ...,
+	calculated modulo 2^32 for fix32 and 2^64 for fix64, so the decoder restores the values with
+	two prefix sums. Slowly varying and linear signals have second differences close to 0, that
+	take one byte each.
+
+*/
+
+#include <cstddef>
+#include <cinttypes>
+#include <vector>
+#include <thread>
+#include <system_error>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#ifndef FIXPOINT_SSE2
+		#define FIXPOINT_SSE2
+	#endif
+#endif
+
+#include "fixpacked.hpp"
+
+namespace fixpoint_detail{
+	template<class Unsigned>
+	Unsigned zig_zag_encode(Unsigned value){
+		using Signed = typename std::make_signed<Unsigned>::type;
+		return static_cast<Unsigned>((value << 1) ^ static_cast<Unsigned>(static_cast<Signed>(value) >> (sizeof(Unsigned) * 8 - 1)));
+	}
+
+	template<class Unsigned>
+	Unsigned zig_zag_decode(Unsigned value){
+		return static_cast<Unsigned>((value >> 1) ^ (0 - (value & 1)));
+	}
+
+	inline void write_varint(std::vector<unsigned char>& out, uint64_t value){
+		while(value >= 0x80){
+			out.push_back(static_cast<unsigned char>(value | 0x80));
+			value >>= 7;
+		}
+		out.push_back(static_cast<unsigned char>(value));
+	}
+
+	// reads a varint from [str, last) into value, returns nullptr if it is cut off or longer than 10 bytes
+	inline const unsigned char* read_varint(const unsigned char* str, const unsigned char* last, uint64_t& value){
+		if(str != last && *str < 0x80){
+			value = *str;
+			return str + 1;
+		}
+		value = 0;
+		for(int shift = 0; str != last && shift < 64; shift += 7){
+			const unsigned char byte = *str++;
+			value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+			if(byte < 0x80){
+				return str;
+			}
+		}
+		return nullptr;
+	}
+
+	// replaces values[i] with values[0] + ... + values[i], 4 values of 32 bits at a time with SSE2
+	inline void prefix_sum(uint32_t* values, size_t count){
+		size_t i = 0;
+		uint32_t sum = 0;
+#if defined(FIXPOINT_SSE2)
+		__m128i carry = _mm_setzero_si128();
+		for(; count - i >= 4; i += 4){
+			__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+			x = _mm_add_epi32(x, _mm_slli_si128(x, 4));
+			x = _mm_add_epi32(x, _mm_slli_si128(x, 8));
+			x = _mm_add_epi32(x, carry);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(values + i), x);
+			carry = _mm_shuffle_epi32(x, 0xFF);
+		}
+		sum = static_cast<uint32_t>(_mm_cvtsi128_si32(carry));
+#endif
+		for(; i < count; ++i){
+			sum += values[i];
+			values[i] = sum;
+		}
+	}
+
+	// replaces values[i] with values[0] + ... + values[i], 2 values of 64 bits at a time with SSE2
+	inline void prefix_sum(uint64_t* values, size_t count){
+		size_t i = 0;
+		uint64_t sum = 0;
+#if defined(FIXPOINT_SSE2)
+		__m128i carry = _mm_setzero_si128();
+		for(; count - i >= 2; i += 2){
+			__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+			x = _mm_add_epi64(x, _mm_slli_si128(x, 8));
+			x = _mm_add_epi64(x, carry);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(values + i), x);
+			carry = _mm_unpackhi_epi64(x, x);
+		}
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(&sum), carry);
+#endif
+		for(; i < count; ++i){
+			sum += values[i];
+			values[i] = sum;
+		}
+	}
+
+	// decodes 'count' zig-zag varints from [first, last) and restores the raw values with two prefix sums
+	template<class Unsigned>
+	bool decode_delta_block(const unsigned char* first, const unsigned char* last, size_t count, Unsigned* out){
+		const unsigned char* str = first;
+		for(size_t i = 0; i < count; ++i){
+			uint64_t value;
+			str = read_varint(str, last, value);
+			if(str == nullptr){
+				return false;
+			}
+			out[i] = zig_zag_decode(static_cast<Unsigned>(value));
+		}
+		prefix_sum(out, count);
+		prefix_sum(out, count);
+		return str == last;
+	}
+}
+
+/*
+	Streaming encoder, that compresses values pushed one by one or in spans.
+	Every block_size values a block is appended to data(), flush() closes a shorter block.
+
+	Example:
+		delta_encoder<fix32<16>> encoder;
+		for(...) encoder.push(sample);
+		encoder.flush();
+		send(encoder.data().data(), encoder.data().size());
+		encoder.clear();
+*/
+template<class Fix>
+class delta_encoder{
+	using type = fixpoint_detail::packed_type<Fix>;
+	using unsigned_type = typename type::unsigned_type;
+
+	std::vector<unsigned char> bytes;
+	std::vector<unsigned char> payload;
+	size_t block_values;
+	size_t pending = 0;
+	unsigned_type previous = 0;
+	unsigned_type previous_delta = 0;
+
+public:
+	explicit delta_encoder(size_t block_size = 1024) : block_values(block_size){
+		fixpoint_assert(block_size > 0, "Error: the block size of delta_encoder has to be larger than 0");
+	}
+
+	void push(Fix value){
+		const unsigned_type raw = type::raw(value);
+		const unsigned_type delta = static_cast<unsigned_type>(raw - this->previous);
+		const unsigned_type second = static_cast<unsigned_type>(delta - this->previous_delta);
+		fixpoint_detail::write_varint(this->payload, fixpoint_detail::zig_zag_encode(second));
+		this->previous = raw;
+		this->previous_delta = delta;
+		if(++this->pending == this->block_values){
+			this->flush();
+		}
+	}
+
+	void push(const Fix* first, size_t count){
+		for(size_t i = 0; i < count; ++i){
+			this->push(first[i]);
+		}
+	}
+
+	// appends the values pushed since the last block as a block of their own
+	void flush(){
+		if(this->pending == 0){
+			return;
+		}
+		fixpoint_detail::write_varint(this->bytes, this->pending);
+		fixpoint_detail::write_varint(this->bytes, this->payload.size());
+		this->bytes.insert(this->bytes.end(), this->payload.begin(), this->payload.end());
+		this->payload.clear();
+		this->pending = 0;
+		this->previous = 0;
+		this->previous_delta = 0;
+	}
+
+	// the encoded blocks
+	const std::vector<unsigned char>& data() const {return this->bytes;}
+
+	// removes the encoded blocks, for example after they have been sent
+	void clear(){this->bytes.clear();}
+
+	size_t block_size() const {return this->block_values;}
+};
+
+/*
+	Decoder of the blocks written by delta_encoder. open() reads the block headers only, so that
+	any range of values can then be decoded without decoding the blocks before it, and all blocks
+	can be decoded in parallel.
+
+	Example:
+		delta_decoder<fix32<16>> decoder;
+		if(decoder.open(data, data + size) != std::errc()) return;
+		std::vector<fix32<16>> values(decoder.size());
+		decoder.decode(values.data(), 4);
+*/
+template<class Fix>
+class delta_decoder{
+	using type = fixpoint_detail::packed_type<Fix>;
+	using unsigned_type = typename type::unsigned_type;
+
+	struct block{
+		const unsigned char* first;
+		const unsigned char* last;
+		size_t count;
+		size_t index;		// of the first value in the block
+	};
+	std::vector<block> block_list;
+	size_t value_count = 0;
+
+	std::errc decode_block(const block& b, Fix* out, std::vector<unsigned_type>& raw) const {
+		raw.resize(b.count);
+		if(!fixpoint_detail::decode_delta_block(b.first, b.last, b.count, raw.data())){
+			return std::errc::invalid_argument;
+		}
+		for(size_t i = 0; i < b.count; ++i){
+			out[i] = type::make(raw[i]);
+		}
+		return std::errc();
+	}
+
+public:
+	// reads the block headers of [first, last), returns std::errc::invalid_argument if they are malformed
+	std::errc open(const unsigned char* first, const unsigned char* last){
+		this->block_list.clear();
+		this->value_count = 0;
+		const unsigned char* str = first;
+		while(str != last){
+			uint64_t count;
+			uint64_t bytes;
+			str = fixpoint_detail::read_varint(str, last, count);
+			str = (str == nullptr) ? nullptr : fixpoint_detail::read_varint(str, last, bytes);
+			if(str == nullptr || bytes > static_cast<uint64_t>(last - str) || count > bytes){
+				this->block_list.clear();
+				this->value_count = 0;
+				return std::errc::invalid_argument;
+			}
+			this->block_list.push_back(block{str, str + bytes, static_cast<size_t>(count), this->value_count});
+			this->value_count += static_cast<size_t>(count);
+			str += bytes;
+		}
+		return std::errc();
+	}
+
+	size_t size() const {return this->value_count;}
+	size_t blocks() const {return this->block_list.size();}
+
+	// decodes the values [first, first + count) into out, only decoding the blocks that contain them
+	std::errc decode(size_t first, size_t count, Fix* out) const {
+		fixpoint_assert(first + count <= this->value_count, "Error: delta_decoder::decode() of values [" << first << ", " << first + count << ") of " << this->value_count);
+		// the block that contains 'first'
+		size_t low = 0;
+		size_t high = this->block_list.size();
+		while(high - low > 1){
+			const size_t middle = (low + high) / 2;
+			if(this->block_list[middle].index <= first){
+				low = middle;
+			}else{
+				high = middle;
+			}
+		}
+		std::vector<Fix> buffer;
+		std::vector<unsigned_type> raw;
+		for(size_t i = low; count > 0 && i < this->block_list.size(); ++i){
+			const block& b = this->block_list[i];
+			buffer.resize(b.count);
+			const std::errc ec = this->decode_block(b, buffer.data(), raw);
+			if(ec != std::errc()){
+				return ec;
+			}
+			const size_t skip = first - b.index;
+			const size_t n = (b.count - skip < count) ? b.count - skip : count;
+			for(size_t j = 0; j < n; ++j){
+				*out++ = buffer[skip + j];
+			}
+			first += n;
+			count -= n;
+		}
+		return std::errc();
+	}
+
+	// decodes all size() values into out, distributing the blocks over 'threads' threads
+	std::errc decode(Fix* out, unsigned threads = 1) const {
+		threads = (threads == 0) ? std::thread::hardware_concurrency() : threads;
+		threads = (threads == 0) ? 1 : threads;
+		std::vector<std::errc> errors(threads, std::errc());
+		const auto work = [&](unsigned t){
+			std::vector<unsigned_type> raw;
+			for(size_t i = t; i < this->block_list.size(); i += threads){
+				const std::errc ec = this->decode_block(this->block_list[i], out + this->block_list[i].index, raw);
+				if(ec != std::errc()){
+					errors[t] = ec;
+					return;
+				}
+			}
+		};
+		std::vector<std::thread> workers;
+		for(unsigned t = 1; t < threads; ++t){
+			workers.emplace_back(work, t);
+		}
+		work(0);
+		for(std::thread& worker : workers){
+			worker.join();
+		}
+		for(std::errc ec : errors){
+			if(ec != std::errc()){
+				return ec;
+			}
+		}
+		return std::errc();
+	}
+};
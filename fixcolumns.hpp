@@ -0,0 +1,391 @@
+#pragma once
+/*
+
+	Author: Tobias Wallner
+	tobias.wallner1@gmx.net
+
+	Binary container for columns of fixed-point numbers, that can be memory mapped and read without parsing.
+
+	Layout, all fields in the byte order given by byte_order:
+		offset 0:	char magic[8] = "FIXCOLS"
+		offset 8:	uint32_t byte_order = 0x01020304
+		offset 12:	uint32_t version = 1
+		offset 16:	uint64_t column_count
+		offset 64:	column_count descriptors of 32 bytes:
+						uint8_t width			bytes per value, 4 for fix32 and 8 for fix64
+						uint8_t fractional_bits
+						uint8_t reserved[6]
+						uint64_t offset			from the start of the file, a multiple of 64
+						uint64_t count			number of values
+						uint64_t reserved
+		followed by the raw values of each column, 64 byte aligned.
+
+*/
+
+#include <cstddef>
+#include <cinttypes>
+#include <cstring>
+#include <cerrno>
+#include <iosfwd>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include <system_error>
+
+#if defined(__unix__) || defined(__APPLE__)
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+	#define FIXPOINT_MMAP
+#endif
+
+#include "fix32.hpp"
+#include "fix64.hpp"
+
+namespace fixpoint_detail{
+	constexpr size_t column_alignment = 64;
+	constexpr size_t column_header_size = 64;
+	constexpr size_t column_descriptor_size = 32;
+	constexpr uint32_t column_byte_order = 0x01020304;
+	constexpr uint32_t column_version = 1;
+
+	// storage of fix32 and fix64 in a column, known at compile time
+	template<class Fix> struct column_type;
+
+	template<size_t N> struct column_type<fix32<N>>{
+		using raw_type = int32_t;
+		using unsigned_type = uint32_t;
+		static constexpr uint8_t width = 4;
+		static constexpr uint8_t fractional_bits = N;
+		static fix32<N> make(uint32_t raw){return fix32<N>::reinterpret(static_cast<int32_t>(raw));}
+	};
+
+	template<size_t N> struct column_type<fix64<N>>{
+		using raw_type = int64_t;
+		using unsigned_type = uint64_t;
+		static constexpr uint8_t width = 8;
+		static constexpr uint8_t fractional_bits = N;
+		static fix64<N> make(uint64_t raw){return fix64<N>::reinterpret(static_cast<int64_t>(raw));}
+	};
+
+	inline uint32_t byte_swap(uint32_t value){
+#if defined(__GNUC__)
+		return __builtin_bswap32(value);
+#else
+		return ((value & 0x000000FFU) << 24) | ((value & 0x0000FF00U) << 8) | ((value & 0x00FF0000U) >> 8) | ((value & 0xFF000000U) >> 24);
+#endif
+	}
+
+	inline uint64_t byte_swap(uint64_t value){
+#if defined(__GNUC__)
+		return __builtin_bswap64(value);
+#else
+		return (static_cast<uint64_t>(byte_swap(static_cast<uint32_t>(value))) << 32) | byte_swap(static_cast<uint32_t>(value >> 32));
+#endif
+	}
+
+	// reads an unaligned value of type T at data, that is byte swapped if swap is set
+	template<class T>
+	T load(const unsigned char* data, bool swap){
+		T value;
+		std::memcpy(&value, data, sizeof(T));
+		return swap ? byte_swap(value) : value;
+	}
+
+	inline size_t align_column(size_t offset){
+		return (offset + column_alignment - 1) / column_alignment * column_alignment;
+	}
+}
+
+/*
+	Read only view of a column in a binary_columns buffer, without copying.
+	Each value is read from the buffer and returned through Fix::reinterpret(), byte swapped
+	if the buffer was written on a machine with the other byte order.
+	If the values need no byte swap and are aligned for Fix, values() returns them as an array.
+*/
+template<class Fix>
+class column_view{
+	using type = fixpoint_detail::column_type<Fix>;
+	using unsigned_type = typename type::unsigned_type;
+
+	const unsigned char* first = nullptr;
+	size_t count = 0;
+	bool swap = false;
+
+public:
+	class const_iterator{
+		const column_view* view;
+		size_t index;
+	public:
+		using iterator_category = std::input_iterator_tag;
+		using value_type = Fix;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const Fix*;
+		using reference = Fix;
+
+		const_iterator(const column_view* view, size_t index) : view(view), index(index){}
+		Fix operator*() const {return (*view)[index];}
+		const_iterator& operator++(){++index; return *this;}
+		const_iterator operator++(int){const_iterator previous = *this; ++index; return previous;}
+		bool operator==(const const_iterator& other) const {return index == other.index;}
+		bool operator!=(const const_iterator& other) const {return index != other.index;}
+	};
+
+	column_view() = default;
+	column_view(const void* data, size_t count, bool swap) : first(static_cast<const unsigned char*>(data)), count(count), swap(swap){}
+
+	Fix operator[](size_t index) const {
+		return type::make(fixpoint_detail::load<unsigned_type>(first + index * sizeof(unsigned_type), swap));
+	}
+
+	size_t size() const {return count;}
+	bool empty() const {return count == 0;}
+
+	// the raw values, valid for direct access if byte_swapped() is false
+	const void* data() const {return first;}
+	bool byte_swapped() const {return swap;}
+
+	// the size() values as an array, or nullptr if they are byte swapped or not aligned for Fix
+	const Fix* values() const {
+		const bool aligned = reinterpret_cast<uintptr_t>(first) % alignof(Fix) == 0;
+		return (!swap && aligned) ? reinterpret_cast<const Fix*>(first) : nullptr;
+	}
+
+	const_iterator begin() const {return const_iterator(this, 0);}
+	const_iterator end() const {return const_iterator(this, count);}
+};
+
+/*
+	Collects columns of fix32 and fix64 and writes them in the binary column format.
+	Only pointers to the values are stored, they have to stay valid until write() is called.
+
+	Example:
+		binary_columns_writer writer;
+		writer.add(time);			// std::vector<fix32<16>>
+		writer.add(pressure);		// std::vector<fix64<40>>
+		std::ofstream file("trace.fixcols", std::ios::binary);
+		writer.write(file);
+*/
+class binary_columns_writer{
+	struct column{
+		uint8_t width;
+		uint8_t fractional_bits;
+		const void* data;
+		size_t count;
+	};
+	std::vector<column> columns;
+
+	size_t data_offset(size_t index) const {
+		size_t offset = fixpoint_detail::align_column(fixpoint_detail::column_header_size + columns.size() * fixpoint_detail::column_descriptor_size);
+		for(size_t i = 0; i < index; ++i){
+			offset = fixpoint_detail::align_column(offset + columns[i].count * columns[i].width);
+		}
+		return offset;
+	}
+
+public:
+	template<class Fix>
+	void add(const Fix* first, size_t count){
+		using type = fixpoint_detail::column_type<Fix>;
+		static_assert(sizeof(Fix) == type::width, "fixed-point numbers have to be stored as their raw integer");
+		columns.push_back(column{type::width, type::fractional_bits, first, count});
+	}
+
+	template<class Fix>
+	void add(const std::vector<Fix>& values){add(values.data(), values.size());}
+
+	// number of bytes that write() writes
+	size_t size() const {
+		return columns.empty() ? data_offset(0) : data_offset(columns.size() - 1) + columns.back().count * columns.back().width;
+	}
+
+	// writes size() bytes to out
+	void write(char* out) const {
+		std::memset(out, 0, size());
+		std::memcpy(out, "FIXCOLS", 8);
+		const uint32_t byte_order = fixpoint_detail::column_byte_order;
+		const uint32_t version = fixpoint_detail::column_version;
+		const uint64_t column_count = columns.size();
+		std::memcpy(out + 8, &byte_order, 4);
+		std::memcpy(out + 12, &version, 4);
+		std::memcpy(out + 16, &column_count, 8);
+
+		size_t offset = data_offset(0);
+		for(size_t i = 0; i < columns.size(); ++i){
+			char* const descriptor = out + fixpoint_detail::column_header_size + i * fixpoint_detail::column_descriptor_size;
+			const uint64_t column_offset = offset;
+			const uint64_t count = columns[i].count;
+			descriptor[0] = static_cast<char>(columns[i].width);
+			descriptor[1] = static_cast<char>(columns[i].fractional_bits);
+			std::memcpy(descriptor + 8, &column_offset, 8);
+			std::memcpy(descriptor + 16, &count, 8);
+			if(count != 0){
+				std::memcpy(out + offset, columns[i].data, columns[i].count * columns[i].width);
+			}
+			offset = fixpoint_detail::align_column(offset + columns[i].count * columns[i].width);
+		}
+	}
+
+	// writes the columns to a stream with write(const char*, size), like std::ostream
+	template<class Stream>
+	Stream& write(Stream& stream) const {
+		std::vector<char> buffer(size());
+		write(buffer.data());
+		stream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+		return stream;
+	}
+};
+
+/*
+	Reads a buffer in the binary column format, for example a memory mapped file, without copying.
+	open() only checks the header and the descriptors, so it takes the same time for any size.
+
+	Example:
+		mapped_file file;
+		binary_columns trace;
+		column_view<fix32<16>> time;
+		if(file.open("trace.fixcols") != std::errc() || trace.open(file.data(), file.size()) != std::errc()) return;
+		if(trace.column(0, time) != std::errc()) return;	// column 0 is not a fix32<16>
+		for(fix32<16> t : time) ...
+*/
+class binary_columns{
+	const unsigned char* first = nullptr;
+	size_t bytes = 0;
+	size_t column_count = 0;
+	bool swap = false;
+
+	const unsigned char* descriptor(size_t index) const {
+		return first + fixpoint_detail::column_header_size + index * fixpoint_detail::column_descriptor_size;
+	}
+
+public:
+	/*
+		Checks the header of [data, data + size) and returns
+			std::errc::invalid_argument		if it is not in the binary column format, or the data of a column
+											is not 64 byte aligned or overlaps the header or the descriptors
+			std::errc::not_supported		if it is a newer version
+			std::errc::result_out_of_range	if a column lies outside of the buffer
+	*/
+	std::errc open(const void* data, size_t size){
+		first = static_cast<const unsigned char*>(data);
+		bytes = size;
+		column_count = 0;
+		if(size < fixpoint_detail::column_header_size || std::memcmp(first, "FIXCOLS", 8) != 0){
+			return std::errc::invalid_argument;
+		}
+		const uint32_t byte_order = fixpoint_detail::load<uint32_t>(first + 8, false);
+		if(byte_order != fixpoint_detail::column_byte_order && byte_order != fixpoint_detail::byte_swap(fixpoint_detail::column_byte_order)){
+			return std::errc::invalid_argument;
+		}
+		swap = byte_order != fixpoint_detail::column_byte_order;
+		if(fixpoint_detail::load<uint32_t>(first + 12, swap) > fixpoint_detail::column_version){
+			return std::errc::not_supported;
+		}
+		const uint64_t count = fixpoint_detail::load<uint64_t>(first + 16, swap);
+		if(count > (size - fixpoint_detail::column_header_size) / fixpoint_detail::column_descriptor_size){
+			return std::errc::result_out_of_range;
+		}
+		const size_t data_first = fixpoint_detail::align_column(fixpoint_detail::column_header_size + static_cast<size_t>(count) * fixpoint_detail::column_descriptor_size);
+		for(size_t i = 0; i < count; ++i){
+			const unsigned char* const d = first + fixpoint_detail::column_header_size + i * fixpoint_detail::column_descriptor_size;
+			const uint64_t offset = fixpoint_detail::load<uint64_t>(d + 8, swap);
+			const uint64_t values = fixpoint_detail::load<uint64_t>(d + 16, swap);
+			if(offset % fixpoint_detail::column_alignment != 0 || offset < data_first){
+				return std::errc::invalid_argument;
+			}
+			if((d[0] != 4 && d[0] != 8) || offset > size || values > (size - offset) / d[0]){
+				return std::errc::result_out_of_range;
+			}
+		}
+		column_count = static_cast<size_t>(count);
+		return std::errc();
+	}
+
+	size_t columns() const {return column_count;}
+	size_t rows(size_t index) const {return static_cast<size_t>(fixpoint_detail::load<uint64_t>(descriptor(index) + 16, swap));}
+	unsigned width(size_t index) const {return descriptor(index)[0];}
+	unsigned fractional_bits(size_t index) const {return descriptor(index)[1];}
+	bool byte_swapped() const {return swap;}
+
+	/*
+		Sets view to the column at index, if it stores values of type Fix.
+		Returns std::errc::invalid_argument if the width or the fractional bits of the column do
+		not match the ones of Fix, and std::errc::result_out_of_range if there is no such column.
+	*/
+	template<class Fix>
+	std::errc column(size_t index, column_view<Fix>& view) const {
+		using type = fixpoint_detail::column_type<Fix>;
+		if(index >= column_count){
+			return std::errc::result_out_of_range;
+		}
+		if(width(index) != type::width || fractional_bits(index) != type::fractional_bits){
+			return std::errc::invalid_argument;
+		}
+		const uint64_t offset = fixpoint_detail::load<uint64_t>(descriptor(index) + 8, swap);
+		view = column_view<Fix>(first + offset, rows(index), swap);
+		return std::errc();
+	}
+};
+
+#if defined(FIXPOINT_MMAP)
+/*
+	Read only memory mapping of a whole file. The pages are loaded on first access,
+	so opening does not depend on the size of the file.
+*/
+class mapped_file{
+	void* address = nullptr;
+	size_t length = 0;
+
+public:
+	mapped_file() = default;
+	mapped_file(const mapped_file&) = delete;
+	mapped_file& operator=(const mapped_file&) = delete;
+	mapped_file(mapped_file&& other) noexcept : address(other.address), length(other.length){other.address = nullptr; other.length = 0;}
+	mapped_file& operator=(mapped_file&& other) noexcept {
+		std::swap(address, other.address);
+		std::swap(length, other.length);
+		return *this;
+	}
+	~mapped_file(){close();}
+
+	// maps the file at path, returns the error of open(), fstat() or mmap()
+	std::errc open(const char* path){
+		close();
+		const int descriptor = ::open(path, O_RDONLY);
+		if(descriptor < 0){
+			return static_cast<std::errc>(errno);
+		}
+		struct stat status;
+		if(::fstat(descriptor, &status) != 0){
+			const int error = errno;
+			::close(descriptor);
+			return static_cast<std::errc>(error);
+		}
+		const size_t size = static_cast<size_t>(status.st_size);
+		if(size != 0){
+			void* const mapping = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, descriptor, 0);
+			if(mapping == MAP_FAILED){
+				const int error = errno;
+				::close(descriptor);
+				return static_cast<std::errc>(error);
+			}
+			address = mapping;
+		}
+		length = size;
+		::close(descriptor);
+		return std::errc();
+	}
+
+	void close(){
+		if(address != nullptr){
+			::munmap(address, length);
+		}
+		address = nullptr;
+		length = 0;
+	}
+
+	const void* data() const {return address;}
+	size_t size() const {return length;}
+};
+#endif
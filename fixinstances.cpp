@@ -0,0 +1,11 @@
+/*
+
+	Author: Tobias Wallner
+	tobias.wallner1@gmx.net
+
+	The explicit instantiations declared in fixinstances.hpp, compiled into the library fixpoint_instances.
+*/
+
+#include "fixinstances.hpp"
+
+FIXPOINT_INSTANCES_ALL(template)
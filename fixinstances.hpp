@@ -0,0 +1,95 @@
+#pragma once
+/*
+
+	Author: Tobias Wallner
+	tobias.wallner1@gmx.net
+
+	Explicit instantiations of the common formats fix32<8/16/24/30> and fix64<16/32/48/62>.
+
+	Include this header instead of fix32.hpp, fix64.hpp and fixmath.hpp and link the library
+	fixpoint_instances (fixinstances.cpp) to stop every translation unit from instantiating the
+	classes and the math functions of these formats again. The header declares them with
+	'extern template' and the library defines them once.
+
+	The operators and all other constexpr functions stay inline: the compiler still instantiates them
+	to inline them and for constant expressions, it just does not emit its own copy. The array functions
+	tanh, sigmoid, gelu, relu6 and softmax are not inline and are only compiled in the library.
+	Other formats are instantiated as before. The module fixpoint (fixpoint.cppm) holds the same
+	instantiations.
+
+	The functions that need integer bits are only instantiated for the formats that have them:
+	exp10, polar, atan2 and atan not for fix32<30> and fix64<62>, the activations only for fix32<8/16/24>.
+*/
+
+#include "fix32.hpp"
+#include "fix64.hpp"
+#include "fixmath.hpp"
+
+// prefix is 'extern template' for the declarations and 'template' for the definitions
+#define FIXPOINT_INSTANCES_TIER(prefix, tier, Fix)												\
+	prefix Fix tier exp2(Fix);																	\
+	prefix Fix tier exp(Fix);																	\
+	prefix Fix tier log2(Fix);
+
+#define FIXPOINT_INSTANCES_RANGED_TIER(prefix, tier, Fix)										\
+	prefix Fix tier exp10(Fix);																	\
+	prefix polar_coordinates<Fix> tier polar(Fix, Fix);											\
+	prefix Fix tier atan2(Fix, Fix);															\
+	prefix Fix tier atan(Fix);
+
+#define FIXPOINT_INSTANCES(prefix, Fix)															\
+	prefix class Fix;																			\
+	prefix Fix abs(Fix);																		\
+	prefix Fix mod(Fix, Fix);																	\
+	prefix Fix remainder(Fix, Fix);																\
+	prefix Fix min(Fix, Fix);																	\
+	prefix Fix max(Fix, Fix);																	\
+	prefix Fix lerp(Fix, Fix, Fix);																\
+	prefix Fix lerp(Fix, Fix, Fix, Fix, Fix);													\
+	prefix Fix expm1(Fix);																		\
+	prefix Fix round_down(Fix);																	\
+	prefix Fix round_up(Fix);																	\
+	prefix Fix floor(Fix);																		\
+	prefix Fix ceil(Fix);																		\
+	FIXPOINT_INSTANCES_TIER(prefix, , Fix)														\
+	FIXPOINT_INSTANCES_TIER(prefix, fixmath::fast::, Fix)										\
+	FIXPOINT_INSTANCES_TIER(prefix, fixmath::balanced::, Fix)									\
+	FIXPOINT_INSTANCES_TIER(prefix, fixmath::precise::, Fix)
+
+#define FIXPOINT_INSTANCES_RANGED(prefix, Fix)													\
+	FIXPOINT_INSTANCES_RANGED_TIER(prefix, , Fix)												\
+	FIXPOINT_INSTANCES_RANGED_TIER(prefix, fixmath::fast::, Fix)								\
+	FIXPOINT_INSTANCES_RANGED_TIER(prefix, fixmath::balanced::, Fix)							\
+	FIXPOINT_INSTANCES_RANGED_TIER(prefix, fixmath::precise::, Fix)
+
+#define FIXPOINT_INSTANCES_ACTIVATION(prefix, Fix)												\
+	prefix Fix tanh(Fix);																		\
+	prefix Fix sigmoid(Fix);																	\
+	prefix Fix gelu(Fix);																		\
+	prefix Fix relu6(Fix);																		\
+	prefix Fix* tanh(const Fix*, const Fix*, Fix*);												\
+	prefix Fix* sigmoid(const Fix*, const Fix*, Fix*);											\
+	prefix Fix* gelu(const Fix*, const Fix*, Fix*);												\
+	prefix Fix* relu6(const Fix*, const Fix*, Fix*);											\
+	prefix Fix* softmax(const Fix*, const Fix*, Fix*);
+
+#define FIXPOINT_INSTANCES_ALL(prefix)															\
+	FIXPOINT_INSTANCES(prefix, fix32<8>)														\
+	FIXPOINT_INSTANCES(prefix, fix32<16>)														\
+	FIXPOINT_INSTANCES(prefix, fix32<24>)														\
+	FIXPOINT_INSTANCES(prefix, fix32<30>)														\
+	FIXPOINT_INSTANCES(prefix, fix64<16>)														\
+	FIXPOINT_INSTANCES(prefix, fix64<32>)														\
+	FIXPOINT_INSTANCES(prefix, fix64<48>)														\
+	FIXPOINT_INSTANCES(prefix, fix64<62>)														\
+	FIXPOINT_INSTANCES_RANGED(prefix, fix32<8>)													\
+	FIXPOINT_INSTANCES_RANGED(prefix, fix32<16>)												\
+	FIXPOINT_INSTANCES_RANGED(prefix, fix32<24>)												\
+	FIXPOINT_INSTANCES_RANGED(prefix, fix64<16>)												\
+	FIXPOINT_INSTANCES_RANGED(prefix, fix64<32>)												\
+	FIXPOINT_INSTANCES_RANGED(prefix, fix64<48>)												\
+	FIXPOINT_INSTANCES_ACTIVATION(prefix, fix32<8>)												\
+	FIXPOINT_INSTANCES_ACTIVATION(prefix, fix32<16>)											\
+	FIXPOINT_INSTANCES_ACTIVATION(prefix, fix32<24>)
+
+FIXPOINT_INSTANCES_ALL(extern template)
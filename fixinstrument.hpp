@@ -0,0 +1,272 @@
+#pragma once
+/*
+
+	Author: Tobias Wallner
+	tobias.wallner1@gmx.net
+
+	Instrumentation of fix32 and fix64, that counts overflows, divisions by zero, saturations, truncating
+	conversions and domain errors, and keeps the most recent of them in a ring buffer.
+
+	Enable it by defining FIXPOINT_INSTRUMENT before including any header of the library. It works with
+	and without DISABLE_FIXPOINT_ASSERTIONS. Every event is counted in a counter of the thread that caused it,
+	and written to a lock-free ring buffer of FIXPOINT_EVENT_RING_SIZE (default 256, a power of two) events,
+	shared by all threads. Both are only touched after a check has failed, so that correct code only pays
+	for the checks themselves.
+
+	The + - * operators are not checked for overflows otherwise. Define FIXPOINT_INSTRUMENT_ARITHMETIC
+	to count their overflows too, which costs a branch per operation and prevents vectorization.
+
+	Example:
+		// worker thread
+		fixpoint_instrument::scoped_site site("motor_control");	// tags the events of this thread in this scope
+		const fix32<16> torque = gain * error;
+
+		// monitoring thread
+		const fixpoint_instrument::counters totals = fixpoint_instrument::total_counters();
+		fixpoint_instrument::event events[16];
+		const size_t n = fixpoint_instrument::recent_events(events, 16);
+*/
+
+#include <cstddef>
+#include <cinttypes>
+#include <cmath>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "definitions.hpp"
+
+template<size_t fractional_bits> class fix32;
+template<size_t fractional_bits> class fix64;
+
+#ifndef FIXPOINT_EVENT_RING_SIZE
+	#define FIXPOINT_EVENT_RING_SIZE 256
+#endif
+
+namespace fixpoint_instrument{
+
+	enum class event_kind : unsigned{
+		overflow,			// the result of an operation is not representable
+		divide_by_zero,
+		saturation,			// a result has been clamped to the representable range, for example by exp2() when it rounds up
+		truncation,			// a number is out of the range of the fixed-point type it is converted to
+		domain,				// an argument is outside of the domain of a function, for example log2(0)
+	};
+
+	constexpr size_t event_kinds = 5;
+
+	inline const char* to_string(event_kind kind){
+		static const char* const names[event_kinds] = {"overflow", "divide_by_zero", "saturation", "truncation", "domain"};
+		return names[static_cast<unsigned>(kind)];
+	}
+
+	struct counters{
+		uint64_t count[event_kinds] = {};
+
+		uint64_t operator[](event_kind kind) const {return this->count[static_cast<unsigned>(kind)];}
+
+		uint64_t total() const {
+			uint64_t sum = 0;
+			for(uint64_t c : this->count){
+				sum += c;
+			}
+			return sum;
+		}
+	};
+
+	struct event{
+		event_kind kind;
+		double value;				// the value that caused the event, for example the numerator of a division by zero
+		const char* operation;		// the function that detected the event
+		const char* site;			// the innermost scoped_site of the thread, or nullptr
+		unsigned thread;			// the number of the thread, in the order of their first event
+		uint64_t sequence;			// the number of the event since the start of the program
+	};
+
+	static_assert((FIXPOINT_EVENT_RING_SIZE & (FIXPOINT_EVENT_RING_SIZE - 1)) == 0, "FIXPOINT_EVENT_RING_SIZE has to be a power of two");
+}
+
+namespace fixpoint_detail{
+
+	// counters of one thread. Only the thread writes them, other threads read them.
+	struct thread_counters{
+		std::atomic<uint64_t> count[fixpoint_instrument::event_kinds];
+		unsigned index;
+		thread_counters();
+		~thread_counters();
+	};
+
+	struct instrument_registry{
+		std::mutex mutex;
+		std::vector<const thread_counters*> threads;
+		uint64_t retired[fixpoint_instrument::event_kinds] = {};	// of threads that have exited
+		unsigned thread_count = 0;
+	};
+
+	// never destroyed, so that threads that exit after main() can still unregister
+	inline instrument_registry& registry(){
+		static instrument_registry* r = new instrument_registry();
+		return *r;
+	}
+
+	inline thread_counters::thread_counters(){
+		for(std::atomic<uint64_t>& c : this->count){
+			c.store(0, std::memory_order_relaxed);
+		}
+		instrument_registry& r = registry();
+		std::lock_guard<std::mutex> lock(r.mutex);
+		this->index = r.thread_count++;
+		r.threads.push_back(this);
+	}
+
+	inline thread_counters::~thread_counters(){
+		instrument_registry& r = registry();
+		std::lock_guard<std::mutex> lock(r.mutex);
+		for(size_t k = 0; k < fixpoint_instrument::event_kinds; ++k){
+			r.retired[k] += this->count[k].load(std::memory_order_relaxed);
+		}
+		for(size_t i = 0; i < r.threads.size(); ++i){
+			if(r.threads[i] == this){
+				r.threads.erase(r.threads.begin() + i);
+				break;
+			}
+		}
+	}
+
+	inline thread_counters& local_counters(){
+		thread_local thread_counters counters;
+		return counters;
+	}
+
+	inline const char*& local_site(){
+		thread_local const char* site = nullptr;
+		return site;
+	}
+
+	/*
+		A slot of the ring is guarded by a sequence number: 2*i+1 while event i is written, 2*i+2 after it is written.
+		A reader accepts a slot only if it has the sequence number 2*i+2 before and after reading it.
+	*/
+	struct event_slot{
+		std::atomic<uint64_t> sequence{0};
+		std::atomic<unsigned> kind{0};
+		std::atomic<double> value{0};
+		std::atomic<const char*> operation{nullptr};
+		std::atomic<const char*> site{nullptr};
+		std::atomic<unsigned> thread{0};
+	};
+
+	struct event_ring{
+		std::atomic<uint64_t> next{0};
+		event_slot slots[FIXPOINT_EVENT_RING_SIZE];
+	};
+
+	inline event_ring& ring(){
+		static event_ring* r = new event_ring();
+		return *r;
+	}
+
+	template<class T>
+	double event_value(T value){return static_cast<double>(value);}
+
+	template<size_t N>
+	double event_value(fix32<N> value){return std::ldexp(static_cast<double>(value.reinterpret_as_int32()), -static_cast<int>(N));}
+
+	template<size_t N>
+	double event_value(fix64<N> value){return std::ldexp(static_cast<double>(value.reinterpret_as_int64()), -static_cast<int>(N));}
+
+	// the value of a raw integer with the given fractional bits
+	inline double raw_to_double(double raw, size_t fractional_bits){return std::ldexp(raw, -static_cast<int>(fractional_bits));}
+}
+
+namespace fixpoint_instrument{
+
+	// counts the event in the counters of this thread and writes it to the ring of recent events
+	inline FIXPOINT_COLD void record(event_kind kind, double value, const char* operation){
+		fixpoint_detail::thread_counters& local = fixpoint_detail::local_counters();
+		std::atomic<uint64_t>& count = local.count[static_cast<unsigned>(kind)];
+		count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+		fixpoint_detail::event_ring& r = fixpoint_detail::ring();
+		const uint64_t i = r.next.fetch_add(1, std::memory_order_relaxed);
+		fixpoint_detail::event_slot& slot = r.slots[i % FIXPOINT_EVENT_RING_SIZE];
+		slot.sequence.store(2 * i + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		slot.kind.store(static_cast<unsigned>(kind), std::memory_order_relaxed);
+		slot.value.store(value, std::memory_order_relaxed);
+		slot.operation.store(operation, std::memory_order_relaxed);
+		slot.site.store(fixpoint_detail::local_site(), std::memory_order_relaxed);
+		slot.thread.store(local.index, std::memory_order_relaxed);
+		slot.sequence.store(2 * i + 2, std::memory_order_release);
+	}
+
+	// tags the events of the current thread while it exists, scopes can be nested
+	class scoped_site{
+		const char* previous;
+	public:
+		explicit scoped_site(const char* name) : previous(fixpoint_detail::local_site()){fixpoint_detail::local_site() = name;}
+		~scoped_site(){fixpoint_detail::local_site() = this->previous;}
+		scoped_site(const scoped_site&) = delete;
+		scoped_site& operator=(const scoped_site&) = delete;
+	};
+
+	// the counters of the calling thread
+	inline counters thread_counters(){
+		counters result;
+		const fixpoint_detail::thread_counters& local = fixpoint_detail::local_counters();
+		for(size_t k = 0; k < event_kinds; ++k){
+			result.count[k] = local.count[k].load(std::memory_order_relaxed);
+		}
+		return result;
+	}
+
+	// the sum of the counters of all threads, including threads that have exited
+	inline counters total_counters(){
+		counters result;
+		fixpoint_detail::instrument_registry& r = fixpoint_detail::registry();
+		std::lock_guard<std::mutex> lock(r.mutex);
+		for(size_t k = 0; k < event_kinds; ++k){
+			result.count[k] = r.retired[k];
+		}
+		for(const fixpoint_detail::thread_counters* local : r.threads){
+			for(size_t k = 0; k < event_kinds; ++k){
+				result.count[k] += local->count[k].load(std::memory_order_relaxed);
+			}
+		}
+		return result;
+	}
+
+	// the number of events recorded since the start of the program
+	inline uint64_t events_recorded(){return fixpoint_detail::ring().next.load(std::memory_order_acquire);}
+
+	/*
+		Copies up to max_count of the most recent events to out, oldest first, and returns their number.
+		Does not block the threads that record events. Events that are overwritten while they are read are skipped.
+	*/
+	inline size_t recent_events(event* out, size_t max_count){
+		const fixpoint_detail::event_ring& r = fixpoint_detail::ring();
+		const uint64_t last = r.next.load(std::memory_order_acquire);
+		uint64_t first = (last > FIXPOINT_EVENT_RING_SIZE) ? last - FIXPOINT_EVENT_RING_SIZE : 0;
+		first = (last - first > max_count) ? last - max_count : first;
+		size_t n = 0;
+		for(uint64_t i = first; i < last; ++i){
+			const fixpoint_detail::event_slot& slot = r.slots[i % FIXPOINT_EVENT_RING_SIZE];
+			const uint64_t before = slot.sequence.load(std::memory_order_acquire);
+			if(before != 2 * i + 2){
+				continue;
+			}
+			event e;
+			e.kind = static_cast<event_kind>(slot.kind.load(std::memory_order_relaxed));
+			e.value = slot.value.load(std::memory_order_relaxed);
+			e.operation = slot.operation.load(std::memory_order_relaxed);
+			e.site = slot.site.load(std::memory_order_relaxed);
+			e.thread = slot.thread.load(std::memory_order_relaxed);
+			e.sequence = i;
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if(slot.sequence.load(std::memory_order_relaxed) == before){
+				out[n++] = e;
+			}
+		}
+		return n;
+	}
+}
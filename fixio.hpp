@@ -0,0 +1,513 @@
+#pragma once
+/*
+
+	Author: Tobias Wallner
+	tobias.wallner1@gmx.net
+
+	Bulk conversion between text buffers and columns of fixed-point numbers.
+
+*/
+
+#include <cstddef>
+#include <cinttypes>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <thread>
+#include <system_error>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define FIXPOINT_SSE2
+#endif
+
+#include "fix32.hpp"
+#include "fix64.hpp"
+
+namespace fixpoint_detail{
+	inline int count_trailing_zeros_32(uint32_t value){
+#if defined(__GNUC__)
+		return __builtin_ctz(value);
+#else
+		int count = 0;
+		while((value & 1) == 0){
+			value >>= 1;
+			++count;
+		}
+		return count;
+#endif
+	}
+
+	// returns the first position of c in [first, last), or last. compares 16 characters at once with SSE2.
+	inline const char* find_char(const char* first, const char* last, char c){
+#if defined(FIXPOINT_SSE2)
+		const __m128i pattern = _mm_set1_epi8(c);
+		for(; last - first >= 16; first += 16){
+			const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+			const int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, pattern));
+			if(mask != 0){
+				return first + count_trailing_zeros_32(static_cast<uint32_t>(mask));
+			}
+		}
+#endif
+		for(; first != last; ++first){
+			if(*first == c) return first;
+		}
+		return last;
+	}
+
+	// returns the number of occurrences of c in [first, last). compares 16 characters at once with SSE2.
+	inline size_t count_char(const char* first, const char* last, char c){
+		size_t count = 0;
+#if defined(FIXPOINT_SSE2)
+		const __m128i pattern = _mm_set1_epi8(c);
+		for(; last - first >= 16; first += 16){
+			const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+			const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, pattern)));
+	#if defined(__GNUC__)
+			count += static_cast<size_t>(__builtin_popcount(mask));
+	#else
+			for(uint32_t m = mask; m != 0; m &= m - 1) ++count;
+	#endif
+		}
+#endif
+		for(; first != last; ++first){
+			count += (*first == c);
+		}
+		return count;
+	}
+}
+
+// ================ CSV Parsing ================
+
+struct csv_options{
+	char delimiter = ',';
+	size_t header_lines = 0;	// lines at the start that are skipped
+	unsigned threads = 1;		// number of threads that parse chunks of the buffer, 0 for std::thread::hardware_concurrency()
+};
+
+// result of parse_csv(). on error, line and column (both starting at 1) locate the field that could not be read
+struct csv_result{
+	std::errc ec;
+	size_t rows;
+	size_t line;
+	size_t column;
+};
+
+namespace fixpoint_detail{
+	template<class Fix>
+	struct csv_chunk{
+		std::vector<std::vector<Fix>> columns;
+		size_t newlines = 0;
+		csv_result result{std::errc(), 0, 0, 0};
+	};
+
+	// parses the complete lines of [first, last) into chunk. line numbers in the result are relative to first
+	template<class Fix>
+	void parse_csv_chunk(const char* first, const char* last, char delimiter, size_t column_count, csv_chunk<Fix>& chunk){
+		chunk.columns.assign(column_count, std::vector<Fix>());
+		for(std::vector<Fix>& column : chunk.columns){
+			column.reserve(static_cast<size_t>(last - first) / (column_count * 8) + 1);
+		}
+		std::vector<Fix> row(column_count);
+		size_t line = 0;
+		const char* str = first;
+		while(str != last){
+			const char* const line_first = str;
+			++line;
+			const auto fail = [&](std::errc ec, const char* position){
+				chunk.result = csv_result{ec, chunk.columns[0].size(), line, static_cast<size_t>(position - line_first) + 1};
+			};
+
+			// skip empty lines
+			if(*str == '\n' || (*str == '\r' && (str + 1 == last || str[1] == '\n'))){
+				str = fixpoint_detail::find_char(str, last, '\n');
+				str += (str != last);
+				++chunk.newlines;
+				continue;
+			}
+
+			for(size_t c = 0; c < column_count; ++c){
+				const fix_from_chars_result r = from_chars(str, last, row[c]);
+				if(r.ec != std::errc()){
+					fail(r.ec, str);
+					return;
+				}
+				str = r.ptr;
+				if(c + 1 < column_count){
+					if(str == last || *str != delimiter){
+						fail(std::errc::invalid_argument, str);
+						return;
+					}
+					++str;
+				}
+			}
+
+			// end of the line
+			if(str != last && *str == '\r'){
+				++str;
+			}
+			if(str != last){
+				if(*str != '\n'){
+					fail(std::errc::invalid_argument, str);
+					return;
+				}
+				++str;
+				++chunk.newlines;
+			}
+			for(size_t c = 0; c < column_count; ++c){
+				chunk.columns[c].push_back(row[c]);
+			}
+		}
+	}
+}
+
+/*
+	Parses a buffer of delimiter separated values, like a memory mapped CSV file, into one vector per column.
+
+	Every line needs the same number of fields, which is taken from the first line after the header.
+	Each field has to be a decimal number as read by from_chars(), without surrounding white space.
+	Lines may end with "\n" or "\r\n", empty lines are skipped.
+
+	With options.threads > 1 the buffer is split into chunks at line boundaries, that are parsed
+	in parallel and concatenated in order. Line breaks are searched and counted with SSE2, and the
+	digits of the fields are converted 8 at a time.
+
+	On error the columns hold the rows before the erroneous line, and the result tells its line and column.
+
+	Example:
+		std::vector<std::vector<fix32<16>>> columns;
+		csv_options options;
+		options.header_lines = 1;
+		options.threads = 4;
+		const csv_result r = parse_csv(data, data + size, columns, options);
+		if(r.ec != std::errc()) std::cerr << "error in line " << r.line << ", column " << r.column;
+*/
+template<class Fix>
+csv_result parse_csv(const char* first, const char* last, std::vector<std::vector<Fix>>& columns, const csv_options& options = csv_options()){
+	columns.clear();
+
+	// skip the header
+	const char* str = first;
+	for(size_t i = 0; i < options.header_lines && str != last; ++i){
+		str = fixpoint_detail::find_char(str, last, '\n');
+		str += (str != last);
+	}
+	const size_t first_line = options.header_lines + 1;
+
+	// the number of columns is given by the first non empty line
+	const char* probe = str;
+	while(probe != last && (*probe == '\n' || *probe == '\r')) ++probe;
+	if(probe == last){
+		return csv_result{std::errc(), 0, 0, 0};
+	}
+	const char* const probe_end = fixpoint_detail::find_char(probe, last, '\n');
+	const size_t column_count = fixpoint_detail::count_char(probe, probe_end, options.delimiter) + 1;
+
+	// split into chunks at line boundaries
+	unsigned threads = (options.threads == 0) ? std::thread::hardware_concurrency() : options.threads;
+	threads = (threads == 0) ? 1 : threads;
+	const size_t chunk_size = static_cast<size_t>(last - str) / threads + 1;
+	std::vector<const char*> bounds(1, str);
+	while(bounds.back() != last){
+		const char* end = (static_cast<size_t>(last - bounds.back()) <= chunk_size) ? last : bounds.back() + chunk_size;
+		end = fixpoint_detail::find_char(end, last, '\n');
+		bounds.push_back(end + (end != last));
+	}
+
+	std::vector<fixpoint_detail::csv_chunk<Fix>> chunks(bounds.size() - 1);
+	std::vector<std::thread> workers;
+	for(size_t i = 1; i < chunks.size(); ++i){
+		workers.emplace_back([&, i](){fixpoint_detail::parse_csv_chunk(bounds[i], bounds[i+1], options.delimiter, column_count, chunks[i]);});
+	}
+	fixpoint_detail::parse_csv_chunk(bounds[0], bounds[1], options.delimiter, column_count, chunks[0]);
+	for(std::thread& worker : workers){
+		worker.join();
+	}
+
+	// concatenate in order until the first error
+	columns.assign(column_count, std::vector<Fix>());
+	size_t rows = 0;
+	for(const auto& chunk : chunks){
+		rows += chunk.columns[0].size();
+	}
+	for(std::vector<Fix>& column : columns){
+		column.reserve(rows);
+	}
+	size_t line = first_line;
+	for(auto& chunk : chunks){
+		for(size_t c = 0; c < column_count; ++c){
+			columns[c].insert(columns[c].end(), chunk.columns[c].begin(), chunk.columns[c].end());
+		}
+		if(chunk.result.ec != std::errc()){
+			return csv_result{chunk.result.ec, columns[0].size(), line + chunk.result.line - 1, chunk.result.column};
+		}
+		line += chunk.newlines;
+	}
+	return csv_result{std::errc(), columns[0].size(), 0, 0};
+}
+
+// ================ Bulk Writing ================
+
+struct write_options{
+	size_t precision = 3;		// significant places after the comma, like print()
+	char delimiter = ',';		// between the values of a row
+	unsigned threads = 1;		// number of threads that format chunks of rows, 0 for std::thread::hardware_concurrency()
+};
+
+namespace fixpoint_detail{
+	// "00", "01", ..., "99"
+	inline const char* two_digits(size_t value){
+		static const char table[201] =
+			"00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+			"40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+			"8081828384858687888990919293949596979899";
+		return table + 2 * value;
+	}
+
+	// writes value in decimal to out, two digits at a time from the back, and returns the end
+	template<class Unsigned>
+	char* write_unsigned(char* out, Unsigned value){
+		int length = 1;
+		for(Unsigned rest = value; rest >= 10; rest /= 10){
+			++length;
+		}
+		char* const end = out + length;
+		char* last = end;
+		while(value >= 100){
+			last -= 2;
+			std::memcpy(last, two_digits(value % 100), 2);
+			value /= 100;
+		}
+		if(value >= 10){
+			std::memcpy(last - 2, two_digits(value), 2);
+		}else{
+			last[-1] = static_cast<char>('0' + value);
+		}
+		return end;
+	}
+
+	/*
+		Writes the fractional digits exactly like print(): each digit is 'fractionals * 10 >> N', digits
+		count towards 'precision' once the integer part or a previous digit was not zero, and the
+		digits end when the remainder becomes zero. While at least two more digits count, both are
+		taken from 'fractionals * 100 >> N' and copied from the table at once.
+		Unsigned is the type in which print() calculates.
+	*/
+	template<class Unsigned, size_t N>
+	char* write_fractionals(char* out, Unsigned fractionals, bool count_significant_enable, size_t precision){
+		const Unsigned mask = static_cast<Unsigned>((static_cast<Unsigned>(1) << N) - 1);
+		// the product of fractionals and 100 does not overflow
+		constexpr bool pairs = (N + 7) <= sizeof(Unsigned) * 8;
+		size_t significant_places = 0;
+		while(fractionals != 0 && significant_places < precision){
+			if(pairs && count_significant_enable && significant_places + 2 <= precision){
+				const Unsigned product = static_cast<Unsigned>(fractionals * 100);
+				const Unsigned pair = static_cast<Unsigned>(product >> N);
+				fractionals = product & mask;
+				if(fractionals == 0 && pair % 10 == 0){
+					// print() stops after the first digit, because the remainder became 0
+					*out++ = static_cast<char>('0' + pair / 10);
+					return out;
+				}
+				std::memcpy(out, two_digits(pair), 2);
+				out += 2;
+				significant_places += 2;
+			}else{
+				significant_places += count_significant_enable;
+				fractionals = static_cast<Unsigned>(fractionals * 10);
+				const Unsigned n = static_cast<Unsigned>(fractionals >> N);
+				count_significant_enable |= n != 0;
+				fractionals = fractionals & mask;
+				*out++ = static_cast<char>('0' + static_cast<char>(n));
+			}
+		}
+		return out;
+	}
+
+	// writes the same characters as print(stream, f, precision) and returns the end
+	template<size_t N>
+	char* write_print(char* out, fix32<N> f, size_t precision){
+		if(f < 0){
+			*out++ = '-';
+			f = -f;
+		}
+		const uint32_t digits = reinterpret_as_int32(f) >> N;
+		const uint32_t fractionals = reinterpret_as_int32(f) & ((1 << N) - 1);
+		out = write_unsigned(out, digits);
+		*out++ = '.';
+		return write_fractionals<uint32_t, N>(out, fractionals, digits != 0, precision);
+	}
+
+	template<size_t N>
+	char* write_print(char* out, fix64<N> f, size_t precision){
+		if(f < 0){
+			*out++ = '-';
+			f = -f;
+		}
+		const uint64_t digits = f.reinterpret_as_int64() >> N;
+		const uint64_t fractionals = f.reinterpret_as_int64() & ((1ULL << N) - 1);
+		out = write_unsigned(out, digits);
+		*out++ = '.';
+		return write_fractionals<uint64_t, N>(out, fractionals, digits != 0, precision);
+	}
+
+	// upper bound of the characters that write_print() writes: sign, integer digits, point and at most N fractional digits
+	template<size_t N> constexpr size_t max_print_chars(fix32<N>){return 1 + 10 + 1 + N;}
+	template<size_t N> constexpr size_t max_print_chars(fix64<N>){return 1 + 20 + 1 + N;}
+
+	// appends the rows [row_first, row_last) to buffer, growing it by blocks of rows of the longest possible length
+	template<class Fix>
+	void write_csv_rows(std::string& buffer, const std::vector<std::vector<Fix>>& columns, size_t row_first, size_t row_last, const write_options& options){
+		const size_t max_chars = max_print_chars(Fix()) + 1;
+		const size_t block_rows = 256;
+		for(size_t block = row_first; block < row_last; block += block_rows){
+			const size_t block_last = (row_last - block > block_rows) ? block + block_rows : row_last;
+			const size_t begin = buffer.size();
+			buffer.resize(begin + (block_last - block) * columns.size() * max_chars);
+			char* const first = &buffer[0] + begin;
+			char* out = first;
+			for(size_t row = block; row < block_last; ++row){
+				for(size_t c = 0; c < columns.size(); ++c){
+					out = write_print(out, columns[c][row], options.precision);
+					*out++ = (c + 1 < columns.size()) ? options.delimiter : '\n';
+				}
+			}
+			buffer.resize(begin + static_cast<size_t>(out - first));
+		}
+	}
+
+	// formats rows on options.threads threads and appends them in order to buffer
+	template<class Fix>
+	void write_csv_parallel(std::string& buffer, const std::vector<std::vector<Fix>>& columns, size_t rows, const write_options& options){
+		unsigned threads = (options.threads == 0) ? std::thread::hardware_concurrency() : options.threads;
+		threads = (threads == 0) ? 1 : threads;
+		if(threads == 1 || rows < 2 * threads){
+			write_csv_rows(buffer, columns, 0, rows, options);
+			return;
+		}
+		std::vector<std::string> chunks(threads);
+		std::vector<std::thread> workers;
+		const size_t rows_per_chunk = (rows + threads - 1) / threads;
+		for(unsigned i = 1; i < threads; ++i){
+			workers.emplace_back([&, i](){
+				const size_t row_first = (i * rows_per_chunk < rows) ? i * rows_per_chunk : rows;
+				const size_t row_last = (row_first + rows_per_chunk < rows) ? row_first + rows_per_chunk : rows;
+				write_csv_rows(chunks[i], columns, row_first, row_last, options);
+			});
+		}
+		write_csv_rows(buffer, columns, 0, (rows_per_chunk < rows) ? rows_per_chunk : rows, options);
+		for(std::thread& worker : workers){
+			worker.join();
+		}
+		for(unsigned i = 1; i < threads; ++i){
+			buffer += chunks[i];
+		}
+	}
+
+	template<class Fix>
+	size_t row_count(const std::vector<std::vector<Fix>>& columns){
+		const size_t rows = columns.empty() ? 0 : columns[0].size();
+		for(const std::vector<Fix>& column : columns){
+			fixpoint_assert(column.size() == rows, "Error: all columns have to have the same number of rows, but got " << column.size() << " and " << rows);
+		}
+		return rows;
+	}
+}
+
+/*
+	Appends the columns as rows of delimiter separated values to buffer, one line per row.
+	Each value is written exactly like print(stream, value, options.precision) writes it.
+
+	The characters are produced two at a time from a table, directly into the buffer, and with
+	options.threads > 1 chunks of rows are formatted in parallel.
+
+	Example:
+		std::string csv;
+		write_options options;
+		options.precision = 6;
+		write_csv(csv, columns, options);
+*/
+template<class Fix>
+void write_csv(std::string& buffer, const std::vector<std::vector<Fix>>& columns, const write_options& options = write_options()){
+	fixpoint_detail::write_csv_parallel(buffer, columns, fixpoint_detail::row_count(columns), options);
+}
+
+/*
+	Writes the columns as rows of delimiter separated values into the caller provided [first, last).
+	Returns the end of the written characters, or {last, std::errc::value_too_large} if they do not fit.
+*/
+template<class Fix>
+fix_to_chars_result write_csv(char* first, char* last, const std::vector<std::vector<Fix>>& columns, const write_options& options = write_options()){
+	const size_t rows = fixpoint_detail::row_count(columns);
+	const size_t max_chars = fixpoint_detail::max_print_chars(Fix()) + 1;
+	if(options.threads != 1 && rows > 1){
+		std::string buffer;
+		fixpoint_detail::write_csv_parallel(buffer, columns, rows, options);
+		if(buffer.size() > static_cast<size_t>(last - first)){
+			return fix_to_chars_result{last, std::errc::value_too_large};
+		}
+		std::memcpy(first, buffer.data(), buffer.size());
+		return fix_to_chars_result{first + buffer.size(), std::errc()};
+	}
+
+	char temporary[2 * (1 + 20 + 1 + 64)];
+	for(size_t row = 0; row < rows; ++row){
+		for(size_t c = 0; c < columns.size(); ++c){
+			// write in place when there is enough space for the longest value, otherwise check the actual length
+			const bool in_place = static_cast<size_t>(last - first) >= max_chars;
+			char* const out = in_place ? first : temporary;
+			char* end = fixpoint_detail::write_print(out, columns[c][row], options.precision);
+			*end++ = (c + 1 < columns.size()) ? options.delimiter : '\n';
+			if(!in_place){
+				const size_t length = static_cast<size_t>(end - temporary);
+				if(length > static_cast<size_t>(last - first)){
+					return fix_to_chars_result{last, std::errc::value_too_large};
+				}
+				std::memcpy(first, temporary, length);
+				end = first + length;
+			}
+			first = end;
+		}
+	}
+	return fix_to_chars_result{first, std::errc()};
+}
+
+/*
+	Appends the values as a JSON array of numbers to buffer, for example "[1.5,-0.25,3.0]".
+	The numbers are written like print(), except that a 0 follows a trailing decimal point,
+	which JSON does not allow.
+*/
+template<class Fix>
+void write_json(std::string& buffer, const std::vector<Fix>& values, const write_options& options = write_options()){
+	const size_t max_chars = fixpoint_detail::max_print_chars(Fix()) + 2;
+	const size_t begin = buffer.size();
+	buffer.resize(begin + 2 + values.size() * max_chars);
+	char* const first = &buffer[0] + begin;
+	char* out = first;
+	*out++ = '[';
+	for(size_t i = 0; i < values.size(); ++i){
+		out = fixpoint_detail::write_print(out, values[i], options.precision);
+		if(out[-1] == '.'){
+			*out++ = '0';
+		}
+		*out++ = (i + 1 < values.size()) ? ',' : ']';
+	}
+	if(values.empty()){
+		*out++ = ']';
+	}
+	buffer.resize(begin + static_cast<size_t>(out - first));
+}
+
+// appends the columns as a JSON array of arrays, one array per column
+template<class Fix>
+void write_json(std::string& buffer, const std::vector<std::vector<Fix>>& columns, const write_options& options = write_options()){
+	buffer += '[';
+	for(size_t c = 0; c < columns.size(); ++c){
+		write_json(buffer, columns[c], options);
+		if(c + 1 < columns.size()){
+			buffer += ',';
+		}
+	}
+	buffer += ']';
+}
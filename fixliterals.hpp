@@ -0,0 +1,182 @@
+#pragma once
+/*
+
+	Author: Tobias Wallner
+	tobias.wallner1@gmx.net
+
+	User defined literals for fix32 and fix64, evaluated at compile time and correctly rounded.
+
+	Example:
+		using namespace fixpoint_literals;
+		constexpr fix32<30> a = -0.0784753434979_fix;		// converts to any fix32<N> and fix64<N>
+		constexpr fix64<60> b = 1.4426950408889634074_fix;
+		constexpr fix32<16> c = 1.5_q16;					// shorthands for common fix32 formats
+		constexpr fix32<16> d = 2.5e-3_fix;					// exponents and digit separators (1'000.5_fix)
+
+	Unlike the string constructors, that accumulate 28 (fix32) or 60 (fix64) fractional bits, the
+	literals read every digit exactly and round once to the fractional bits of the target, ties to even.
+	Literals that are out of range, or not decimal, fail to compile.
+
+*/
+
+#include <cstddef>
+#include <cinttypes>
+
+#include "fix32.hpp"
+#include "fix64.hpp"
+
+namespace fixpoint_detail{
+	struct literal_value{
+		uint64_t magnitude;
+		bool valid;
+		bool overflow;
+	};
+
+	/*
+		Reads the decimal literal str of length L (digits, '.', digit separators and an optional exponent)
+		and returns its magnitude rounded to fractional_bits, ties to even. overflow is set if it is larger than limit.
+	*/
+	template<size_t L>
+	constexpr literal_value parse_literal(const char (&str)[L], size_t fractional_bits, uint64_t limit){
+		literal_value result{0, true, false};
+
+		// collect the digits, the position of the decimal point and the exponent
+		char digits[L + 1] = {};
+		int count = 0;
+		int point = -1;
+		int exponent = 0;
+		size_t i = 0;
+		for(; i < L && str[i] != 'e' && str[i] != 'E'; ++i){
+			const char c = str[i];
+			if('0' <= c && c <= '9'){
+				digits[count++] = static_cast<char>(c - '0');
+			}else if(c == '.' && point < 0){
+				point = count;
+			}else if(c != '\'' || count == 0){
+				// anything but a digit separator
+				result.valid = false;
+				return result;
+			}
+		}
+		if(i < L){
+			++i;
+			const bool negative_exponent = (i < L && str[i] == '-');
+			i += (i < L && (str[i] == '-' || str[i] == '+'));
+			if(i == L){
+				result.valid = false;
+				return result;
+			}
+			for(; i < L; ++i){
+				if(str[i] < '0' || '9' < str[i]){
+					result.valid = false;
+					return result;
+				}
+				exponent = (exponent < 10000) ? exponent * 10 + (str[i] - '0') : exponent;
+			}
+			exponent = negative_exponent ? -exponent : exponent;
+		}
+		if(count == 0){
+			result.valid = false;
+			return result;
+		}
+		point = ((point < 0) ? count : point) + exponent;
+
+		// integer part, digits beyond 'count' are zeros
+		const uint64_t integer_limit = limit >> fractional_bits;
+		uint64_t integer = 0;
+		for(int k = 0; k < point; ++k){
+			const uint64_t digit = (k < count) ? static_cast<uint64_t>(digits[k]) : 0;
+			if(integer > integer_limit / 10 || digit > integer_limit - integer * 10){
+				result.overflow = true;
+				return result;
+			}
+			integer = integer * 10 + digit;
+		}
+
+		// fraction part: below 10^-25 it rounds to 0 for any number of fractional bits up to 63
+		if(point < -25){
+			return result;
+		}
+		const int leading_zeros = (point < 0) ? -point : 0;
+		const int first = (point > 0) ? point : 0;
+		char fraction[L + 26] = {};
+		int fraction_count = 0;
+		for(int k = 0; k < leading_zeros; ++k){
+			fraction[fraction_count++] = 0;
+		}
+		for(int k = first; k < count; ++k){
+			fraction[fraction_count++] = digits[k];
+		}
+
+		// the binary digits of the fraction, by doubling it and taking the carry, and one more for rounding
+		uint64_t bits = 0;
+		bool half = false;
+		for(size_t b = 0; b <= fractional_bits; ++b){
+			int carry = 0;
+			for(int k = fraction_count - 1; k >= 0; --k){
+				const int doubled = fraction[k] * 2 + carry;
+				fraction[k] = static_cast<char>(doubled % 10);
+				carry = doubled / 10;
+			}
+			if(b < fractional_bits){
+				bits = (bits << 1) | static_cast<uint64_t>(carry);
+			}else{
+				half = carry != 0;
+			}
+		}
+		bool sticky = false;
+		for(int k = 0; k < fraction_count; ++k){
+			sticky |= fraction[k] != 0;
+		}
+
+		const uint64_t magnitude = (integer << fractional_bits) + bits;
+		const bool round_up = half && (sticky || (magnitude & 1));
+		if(magnitude > limit - round_up){
+			result.overflow = true;
+			return result;
+		}
+		result.magnitude = magnitude + round_up;
+		return result;
+	}
+
+	/*
+		A numeric literal, that converts to any fix32<N> and fix64<N>. The conversion is evaluated
+		at compile time, because its result is a constexpr variable.
+	*/
+	template<bool Negative, char... Chars>
+	struct decimal_literal{
+		static constexpr char str[sizeof...(Chars)] = {Chars...};
+
+		constexpr decimal_literal<!Negative, Chars...> operator-() const {return {};}
+		constexpr decimal_literal operator+() const {return *this;}
+
+		template<size_t N>
+		constexpr operator fix32<N>() const {
+			constexpr literal_value value = parse_literal(str, N, Negative ? 0x80000000ULL : 0x7FFFFFFFULL);
+			static_assert(value.valid, "fixed-point literal: only decimal literals are supported");
+			static_assert(!value.overflow, "fixed-point literal: the value is out of the range of the fix32");
+			return fix32<N>::reinterpret(static_cast<int32_t>(static_cast<uint32_t>(Negative ? 0 - value.magnitude : value.magnitude)));
+		}
+
+		template<size_t N>
+		constexpr operator fix64<N>() const {
+			constexpr literal_value value = parse_literal(str, N, Negative ? 0x8000000000000000ULL : 0x7FFFFFFFFFFFFFFFULL);
+			static_assert(value.valid, "fixed-point literal: only decimal literals are supported");
+			static_assert(!value.overflow, "fixed-point literal: the value is out of the range of the fix64");
+			return fix64<N>::reinterpret(static_cast<int64_t>(Negative ? 0 - value.magnitude : value.magnitude));
+		}
+	};
+
+	template<bool Negative, char... Chars>
+	constexpr char decimal_literal<Negative, Chars...>::str[sizeof...(Chars)];
+}
+
+namespace fixpoint_literals{
+	template<char... Chars>
+	constexpr fixpoint_detail::decimal_literal<false, Chars...> operator""_fix(){return {};}
+
+	template<char... Chars> constexpr fix32<8> operator""_q8(){return fixpoint_detail::decimal_literal<false, Chars...>();}
+	template<char... Chars> constexpr fix32<16> operator""_q16(){return fixpoint_detail::decimal_literal<false, Chars...>();}
+	template<char... Chars> constexpr fix32<24> operator""_q24(){return fixpoint_detail::decimal_literal<false, Chars...>();}
+	template<char... Chars> constexpr fix32<30> operator""_q30(){return fixpoint_detail::decimal_literal<false, Chars...>();}
+}
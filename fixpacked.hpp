@@ -0,0 +1,230 @@
+#pragma once
+/*
+
+	Author: Tobias Wallner
+	tobias.wallner1@gmx.net
+
+	Arrays of fixed-point numbers with a known range, stored with fewer bits per value.
+
+*/
+
+#include <cstddef>
+#include <cinttypes>
+#include <vector>
+
+#include "fix32.hpp"
+#include "fix64.hpp"
+
+namespace fixpoint_detail{
+	// raw integer access of fix32 and fix64 for packing
+	template<class Fix> struct packed_type;
+
+	template<size_t N> struct packed_type<fix32<N>>{
+		using raw_type = int32_t;
+		using unsigned_type = uint32_t;
+		static constexpr size_t raw_bits = 32;
+		static uint32_t raw(fix32<N> f){return static_cast<uint32_t>(f.reinterpret_as_int32());}
+		static fix32<N> make(uint32_t raw){return fix32<N>::reinterpret(static_cast<int32_t>(raw));}
+	};
+
+	template<size_t N> struct packed_type<fix64<N>>{
+		using raw_type = int64_t;
+		using unsigned_type = uint64_t;
+		static constexpr size_t raw_bits = 64;
+		static uint64_t raw(fix64<N> f){return static_cast<uint64_t>(f.reinterpret_as_int64());}
+		static fix64<N> make(uint64_t raw){return fix64<N>::reinterpret(static_cast<int64_t>(raw));}
+	};
+
+	// number of values in a block, that fills exactly Bits words of 64 bits
+	constexpr size_t packed_block_size = 64;
+
+	/*
+		Unpacks the 64 values of Bits bits from the Bits words at in. The position of every value is a
+		compile time constant, so that the loop is unrolled into shifts and masks and vectorized.
+	*/
+	template<size_t Bits, class Unsigned>
+	inline void unpack_block(const uint64_t* in, Unsigned* out){
+		constexpr uint64_t mask = (Bits == 64) ? ~0ULL : ((1ULL << (Bits % 64)) - 1);
+#if defined(__GNUC__) && !defined(__clang__)
+		#pragma GCC unroll 64
+#endif
+		for(size_t j = 0; j < packed_block_size; ++j){
+			const size_t bit = j * Bits;
+			const size_t word = bit / 64;
+			const size_t shift = bit % 64;
+			uint64_t value = in[word] >> shift;
+			if(shift + Bits > 64){
+				value |= in[word + 1] << ((64 - shift) % 64);
+			}
+			out[j] = static_cast<Unsigned>(value & mask);
+		}
+	}
+
+	// packs 64 values of Bits bits into the Bits words at out
+	template<size_t Bits, class Unsigned>
+	inline void pack_block(const Unsigned* in, uint64_t* out){
+		for(size_t w = 0; w < Bits; ++w){
+			out[w] = 0;
+		}
+#if defined(__GNUC__) && !defined(__clang__)
+		#pragma GCC unroll 64
+#endif
+		for(size_t j = 0; j < packed_block_size; ++j){
+			const size_t bit = j * Bits;
+			const size_t word = bit / 64;
+			const size_t shift = bit % 64;
+			const uint64_t value = static_cast<uint64_t>(in[j]);
+			out[word] |= value << shift;
+			if(shift + Bits > 64){
+				out[word + 1] |= value >> ((64 - shift) % 64);
+			}
+		}
+	}
+}
+
+/*
+	Array of fix32 or fix64 values that are stored with 'Bits' bits each, with O(1) random access.
+
+	A value is stored as (raw(value) - raw(offset)) >> scale_log2 in Bits unsigned bits, so the array
+	holds the values offset, offset + 2^scale_log2 * epsilon, ..., offset + (2^Bits - 1) * 2^scale_log2 * epsilon.
+	set() asserts that a value lies in this range and drops the lowest scale_log2 bits of its distance to offset.
+	For signed signals set offset to the smallest value.
+
+	unpack() and pack() convert whole spans and handle 64 values at a time with a kernel, in which
+	all bit positions are compile time constants.
+
+	Example:
+		// 12-bit ADC readings in fix32<8>, 1.5 bytes instead of 4 per value
+		packed_fix_array<fix32<8>, 12> history(100000);
+		history.set(0, fix32<8>::reinterpret(4095));
+		std::vector<fix32<8>> window(1024);
+		history.unpack(0, window.size(), window.data());
+*/
+template<class Fix, size_t Bits>
+class packed_fix_array{
+	using type = fixpoint_detail::packed_type<Fix>;
+	using unsigned_type = typename type::unsigned_type;
+	static_assert(Bits >= 1 && Bits <= type::raw_bits, "packed_fix_array: Bits has to be in [1, bits of the raw type]");
+
+	static constexpr uint64_t mask = (Bits == 64) ? ~0ULL : ((1ULL << (Bits % 64)) - 1);
+
+	// one word more than needed, so that a value can always be read from two neighbouring words
+	std::vector<uint64_t> words = std::vector<uint64_t>(1, 0);
+	size_t count = 0;
+	unsigned_type offset_raw = 0;
+	unsigned scale = 0;
+
+	static size_t words_for(size_t size){return (size * Bits + 63) / 64 + 1;}
+
+	uint64_t load(size_t index) const {
+		const size_t bit = index * Bits;
+		const size_t word = bit / 64;
+		const size_t shift = bit % 64;
+		uint64_t value = this->words[word] >> shift;
+		if(shift + Bits > 64){
+			value |= this->words[word + 1] << (64 - shift);
+		}
+		return value & mask;
+	}
+
+	void store(size_t index, uint64_t value){
+		const size_t bit = index * Bits;
+		const size_t word = bit / 64;
+		const size_t shift = bit % 64;
+		this->words[word] = (this->words[word] & ~(mask << shift)) | (value << shift);
+		if(shift + Bits > 64){
+			const size_t upper = 64 - shift;
+			this->words[word + 1] = (this->words[word + 1] & ~(mask >> upper)) | (value >> upper);
+		}
+	}
+
+	Fix decode(uint64_t value) const {
+		return type::make(static_cast<unsigned_type>((static_cast<unsigned_type>(value) << this->scale) + this->offset_raw));
+	}
+
+	uint64_t encode(Fix value) const {
+		const unsigned_type distance = static_cast<unsigned_type>(type::raw(value) - this->offset_raw);
+		fixpoint_assert((static_cast<uint64_t>(distance >> this->scale) & ~mask) == 0,
+			"Error: the value " << value << " is outside of the range [" << this->lowest() << ", " << this->highest() << "] of packed_fix_array<" << Bits << ">");
+		return static_cast<uint64_t>(distance >> this->scale);
+	}
+
+public:
+	static constexpr size_t bits = Bits;
+
+	packed_fix_array() = default;
+
+	// size values equal to offset, the smallest value the array can hold
+	explicit packed_fix_array(size_t size, Fix offset = Fix(0), unsigned scale_log2 = 0)
+		: words(words_for(size), 0), count(size), offset_raw(type::raw(offset)), scale(scale_log2){
+		fixpoint_assert(scale_log2 + Bits <= type::raw_bits, "Error: packed_fix_array<" << Bits << "> with scale_log2=" << scale_log2 << " exceeds the raw type");
+	}
+
+	Fix get(size_t index) const {return this->decode(this->load(index));}
+	Fix operator[](size_t index) const {return this->get(index);}
+	void set(size_t index, Fix value){this->store(index, this->encode(value));}
+
+	void push_back(Fix value){
+		this->words.resize(words_for(this->count + 1), 0);
+		this->store(this->count++, this->encode(value));
+	}
+
+	// new values are equal to offset
+	void resize(size_t size){
+		// clear the bits of removed values, so that they do not reappear when the array grows again
+		for(size_t i = size; i < this->count; ++i){
+			this->store(i, 0);
+		}
+		this->words.resize(words_for(size), 0);
+		this->count = size;
+	}
+
+	size_t size() const {return this->count;}
+	bool empty() const {return this->count == 0;}
+	Fix offset() const {return type::make(this->offset_raw);}
+	unsigned scale_log2() const {return this->scale;}
+	Fix lowest() const {return this->decode(0);}
+	Fix highest() const {return this->decode(mask);}
+
+	// the packed words and their size in bytes
+	const uint64_t* data() const {return this->words.data();}
+	size_t bytes() const {return this->words.size() * sizeof(uint64_t);}
+
+	// writes the values [first, first + n) to out
+	void unpack(size_t first, size_t n, Fix* out) const {
+		const size_t last = first + n;
+		size_t i = first;
+		for(; i < last && i % fixpoint_detail::packed_block_size != 0; ++i){
+			*out++ = this->get(i);
+		}
+		unsigned_type block[fixpoint_detail::packed_block_size];
+		for(; last - i >= fixpoint_detail::packed_block_size; i += fixpoint_detail::packed_block_size){
+			fixpoint_detail::unpack_block<Bits>(this->words.data() + i / fixpoint_detail::packed_block_size * Bits, block);
+			for(size_t j = 0; j < fixpoint_detail::packed_block_size; ++j){
+				*out++ = type::make(static_cast<unsigned_type>((block[j] << this->scale) + this->offset_raw));
+			}
+		}
+		for(; i < last; ++i){
+			*out++ = this->get(i);
+		}
+	}
+
+	// sets the values [first, first + n) from in
+	void pack(size_t first, const Fix* in, size_t n){
+		const size_t last = first + n;
+		size_t i = first;
+		for(; i < last && i % fixpoint_detail::packed_block_size != 0; ++i){
+			this->set(i, *in++);
+		}
+		unsigned_type block[fixpoint_detail::packed_block_size];
+		for(; last - i >= fixpoint_detail::packed_block_size; i += fixpoint_detail::packed_block_size){
+			for(size_t j = 0; j < fixpoint_detail::packed_block_size; ++j){
+				block[j] = static_cast<unsigned_type>(this->encode(*in++));
+			}
+			fixpoint_detail::pack_block<Bits>(block, this->words.data() + i / fixpoint_detail::packed_block_size * Bits);
+		}
+		for(; i < last; ++i){
+			this->set(i, *in++);
+		}
+	}
+};
@@ -0,0 +1,49 @@
+/*
+
+	Author: Tobias Wallner
+	tobias.wallner1@gmx.net
+
+	C++20 module interface unit of fix32, fix64, fixmath and the literals.
+
+		import fixpoint;
+
+	The headers are exported as a whole and stay attached to the global module, so the module
+	can be mixed with translation units, that include them. The standard headers they need are
+	included in the global module fragment first. The module also holds the explicit instantiations
+	of fixinstances.hpp, so importers do not instantiate the common formats again.
+
+	Macros are not exported: code that needs DISABLE_FIXPOINT_ASSERTIONS, FIXPOINT_SHADOW or
+	fixpoint_profile() includes the headers instead. The error handler is chosen when the module is
+	built. The module support of GCC 12 is incomplete: it fails to instantiate the std::stringstream
+	of the default handler in an importer (build the module with FIXPOINT_LOG_ERROR or
+	FIXPOINT_EXIT_ERROR) and does not emit the integer constructors of fix64.
+*/
+
+module;
+
+#include <cinttypes>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <iosfwd>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+
+export module fixpoint;
+
+export extern "C++" {
+	#include "fix32.hpp"
+	#include "fix64.hpp"
+	#include "fixliterals.hpp"
+	#include "fixmath.hpp"
+}
+
+extern "C++" {
+	#include "fixinstances.hpp"
+
+	FIXPOINT_INSTANCES_ALL(template)
+}
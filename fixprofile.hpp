@@ -0,0 +1,259 @@
+#pragma once
+/*
+
+	Author: Tobias Wallner
+	tobias.wallner1@gmx.net
+
+	Value-range profiler, that recommends the fractional bits and the storage width of fix32 and fix64 values.
+
+	Tag a value with fixpoint_profile(name, value). The macro returns the value, so that it can wrap
+	any expression. With FIXPOINT_PROFILE defined, it records the value at the named site into a
+	histogram of the thread, without locks. Otherwise it compiles to the value itself.
+
+	At exit a report of all sites is written to std::cerr (see set_report_stream()). For every site it lists the
+	range of the values, the headroom of the integer bits, the fractional bits with the highest precision that
+	do not overflow, and the smallest storage width of 16, 32 or 64 bits, that keeps the current fractional bits.
+
+	Example:
+		fix32<16> y = fixpoint_profile("filter.y", c0 * x[i] + c1 * x[i-1]);
+
+		fixed-point value ranges:
+		site                    format     count       min           max           |min|>0       int bits  headroom  recommended  width
+		filter.y                fix32<16>  2001        -3.90625      3.90625       0.00390625    2 (2)     13        fix32<29>    32
+
+	'int bits' are the integer bits of all values, and in brackets of 99.9% of the values.
+*/
+
+#include <cstddef>
+#include <cinttypes>
+#include <vector>
+#include <mutex>
+#include <ostream>
+#include <iomanip>
+#include <string>
+#include <cmath>
+
+#include "fix32.hpp"
+#include "fix64.hpp"
+#include "fixsites.hpp"
+
+namespace fixpoint_profiler{
+
+	// the summary of one site, see collect()
+	struct site_report{
+		const char* name;
+		unsigned width;							// of the format, 32 or 64
+		unsigned fractional_bits;				// of the format
+		uint64_t count;
+		uint64_t zeros;
+		double min;
+		double max;
+		double abs_min;							// smallest magnitude larger than 0, or 0 if all values are 0
+		int integer_bits;						// all values are in [-2^integer_bits, 2^integer_bits), may be negative
+		int integer_bits_999;					// the same for 99.9% of the values
+		int headroom;							// integer bits of the format that are never used
+		unsigned recommended_fractional_bits;	// most precise fractional bits of the same width without overflows
+		unsigned smallest_width;				// smallest width of 16, 32 or 64 bits, that holds the values with fractional_bits
+	};
+}
+
+namespace fixpoint_detail{
+
+	// statistics of the raw values of a site
+	struct range_stats{
+		uint64_t count = 0;
+		uint64_t zeros = 0;
+		int64_t min = INT64_MAX;
+		int64_t max = INT64_MIN;
+		uint64_t abs_min = UINT64_MAX;
+		uint64_t histogram[65] = {};	// by the number of magnitude bits, that a raw value needs besides the sign
+
+		void add(const range_stats& other){
+			this->count += other.count;
+			this->zeros += other.zeros;
+			this->min = (other.min < this->min) ? other.min : this->min;
+			this->max = (other.max > this->max) ? other.max : this->max;
+			this->abs_min = (other.abs_min < this->abs_min) ? other.abs_min : this->abs_min;
+			for(size_t b = 0; b < 65; ++b){
+				this->histogram[b] += other.histogram[b];
+			}
+		}
+	};
+
+	struct thread_profile;
+
+	/*
+		The sites and the statistics of the threads. Threads that exit during the destruction of static objects
+		still merge their statistics into it, because the registry is never destroyed (see registry_of()).
+	*/
+	struct profile_registry : site_registry{
+		std::vector<range_stats> retired;		// of threads that have exited
+		std::vector<const thread_profile*> threads;
+
+		static void report(std::ostream& stream);
+	};
+
+	// the statistics of all sites, recorded by one thread
+	struct thread_profile{
+		std::vector<range_stats> stats;
+		thread_profile();
+		~thread_profile();
+	};
+
+	inline profile_registry& profiles(){
+		return registry_of<profile_registry>();
+	}
+
+	inline thread_profile::thread_profile(){
+		profile_registry& r = profiles();
+		std::lock_guard<std::mutex> lock(r.mutex);
+		r.threads.push_back(this);
+	}
+
+	inline thread_profile::~thread_profile(){
+		profile_registry& r = profiles();
+		std::lock_guard<std::mutex> lock(r.mutex);
+		if(r.retired.size() < this->stats.size()){
+			r.retired.resize(this->stats.size());
+		}
+		for(size_t i = 0; i < this->stats.size(); ++i){
+			r.retired[i].add(this->stats[i]);
+		}
+		for(size_t i = 0; i < r.threads.size(); ++i){
+			if(r.threads[i] == this){
+				r.threads.erase(r.threads.begin() + i);
+				break;
+			}
+		}
+	}
+
+	inline thread_profile& local_profile(){
+		thread_local thread_profile profile;
+		return profile;
+	}
+
+	// the number of magnitude bits b of a raw value, so that it is in [-2^b, 2^b)
+	inline int magnitude_bits(int64_t raw){
+		return 1 + bit_scan_reverse((raw < 0) ? ~static_cast<uint64_t>(raw) : static_cast<uint64_t>(raw));
+	}
+
+	inline void record_raw(size_t site, int64_t raw){
+		thread_profile& local = local_profile();
+		if(site >= local.stats.size()){
+			local.stats.resize(site + 1);
+		}
+		range_stats& s = local.stats[site];
+		++s.count;
+		s.min = (raw < s.min) ? raw : s.min;
+		s.max = (raw > s.max) ? raw : s.max;
+		const uint64_t magnitude = (raw < 0) ? 0 - static_cast<uint64_t>(raw) : static_cast<uint64_t>(raw);
+		s.zeros += magnitude == 0;
+		s.abs_min = (magnitude != 0 && magnitude < s.abs_min) ? magnitude : s.abs_min;
+		++s.histogram[magnitude_bits(raw)];
+	}
+
+	inline fixpoint_profiler::site_report make_report(const site_format& site, const range_stats& s){
+		fixpoint_profiler::site_report report;
+		const int fractional_bits = static_cast<int>(site.fractional_bits);
+		report.name = site.name;
+		report.width = site.width;
+		report.fractional_bits = site.fractional_bits;
+		report.count = s.count;
+		report.zeros = s.zeros;
+		report.min = (s.count == 0) ? 0 : std::ldexp(static_cast<double>(s.min), -fractional_bits);
+		report.max = (s.count == 0) ? 0 : std::ldexp(static_cast<double>(s.max), -fractional_bits);
+		report.abs_min = (s.abs_min == UINT64_MAX) ? 0 : std::ldexp(static_cast<double>(s.abs_min), -fractional_bits);
+
+		int bits = 0;
+		int bits_999 = 0;
+		uint64_t cumulative = 0;
+		for(int b = 0; b < 65; ++b){
+			bits = (s.histogram[b] != 0) ? b : bits;
+			if(cumulative * 1000 < s.count * 999){
+				bits_999 = b;
+			}
+			cumulative += s.histogram[b];
+		}
+		report.integer_bits = bits - fractional_bits;
+		report.integer_bits_999 = bits_999 - fractional_bits;
+		report.headroom = static_cast<int>(site.width) - 1 - bits;
+		// at least one integer bit besides the sign, like the largest formats fix32<30> and fix64<62> that fixmath uses
+		const int integer_bits = (report.integer_bits > 1) ? report.integer_bits : 1;
+		report.recommended_fractional_bits = static_cast<unsigned>(static_cast<int>(site.width) - 1 - integer_bits);
+		report.smallest_width = (bits < 16) ? 16 : (bits < 32) ? 32 : 64;
+		return report;
+	}
+}
+
+namespace fixpoint_profiler{
+
+	// a named site, at which values of one format are recorded
+	class site : public fixpoint_detail::registered_site<fixpoint_detail::profile_registry>{
+	public:
+		site(const char* name, unsigned width, unsigned fractional_bits) : registered_site(name, width, fractional_bits){}
+
+		template<size_t N> site(const char* name, fix32<N>) : site(name, 32, N){}
+		template<size_t N> site(const char* name, fix64<N>) : site(name, 64, N){}
+
+		// records value in the statistics of the calling thread, without locking
+		template<size_t N> void record(fix32<N> value) const {fixpoint_detail::record_raw(this->id, value.reinterpret_as_int32());}
+		template<size_t N> void record(fix64<N> value) const {fixpoint_detail::record_raw(this->id, value.reinterpret_as_int64());}
+	};
+
+	/*
+		Returns the reports of all sites, merged over all threads. The statistics of threads that are still
+		recording are read without synchronisation, so call it when the other threads are idle or have exited.
+	*/
+	inline std::vector<site_report> collect(){
+		fixpoint_detail::profile_registry& r = fixpoint_detail::profiles();
+		std::lock_guard<std::mutex> lock(r.mutex);
+		std::vector<fixpoint_detail::range_stats> totals(r.sites.size());
+		for(size_t i = 0; i < r.retired.size(); ++i){
+			totals[i].add(r.retired[i]);
+		}
+		for(const fixpoint_detail::thread_profile* t : r.threads){
+			for(size_t i = 0; i < t->stats.size(); ++i){
+				totals[i].add(t->stats[i]);
+			}
+		}
+		std::vector<site_report> reports;
+		for(size_t i = 0; i < r.sites.size(); ++i){
+			reports.push_back(fixpoint_detail::make_report(r.sites[i], totals[i]));
+		}
+		return reports;
+	}
+
+	// writes the reports of all sites as a table to stream
+	inline std::ostream& report(std::ostream& stream){
+		stream << "fixed-point value ranges:\n";
+		stream << std::left << std::setw(24) << "site" << std::setw(11) << "format" << std::setw(12) << "count"
+			<< std::setw(14) << "min" << std::setw(14) << "max" << std::setw(14) << "|min|>0"
+			<< std::setw(10) << "int bits" << std::setw(10) << "headroom" << std::setw(13) << "recommended" << "width\n";
+		for(const site_report& s : collect()){
+			const char* type = (s.width == 32) ? "fix32<" : "fix64<";
+			stream << std::left << std::setw(24) << s.name
+				<< type << std::setw(5) << (std::to_string(s.fractional_bits) + ">")
+				<< std::setw(12) << s.count << std::setw(14) << s.min << std::setw(14) << s.max << std::setw(14) << s.abs_min
+				<< std::setw(10) << (std::to_string(s.integer_bits) + " (" + std::to_string(s.integer_bits_999) + ")")
+				<< std::setw(10) << s.headroom
+				<< type << std::setw(7) << (std::to_string(s.recommended_fractional_bits) + ">")
+				<< s.smallest_width << '\n';
+		}
+		return stream;
+	}
+
+	// the stream of the report at exit, nullptr disables it
+	inline void set_report_stream(std::ostream* stream){
+		fixpoint_detail::set_report_stream<fixpoint_detail::profile_registry>(stream);
+	}
+}
+
+inline void fixpoint_detail::profile_registry::report(std::ostream& stream){
+	fixpoint_profiler::report(stream);
+}
+
+#if defined(FIXPOINT_PROFILE)
+	#define fixpoint_profile(name, value) FIXPOINT_RECORD_AT_SITE(fixpoint_profiler::site, name, value)
+#else
+	#define fixpoint_profile(name, value) (value)
+#endif
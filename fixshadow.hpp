@@ -0,0 +1,307 @@
+#pragma once
+/*
+
+	Author: Tobias Wallner
+	tobias.wallner1@gmx.net
+
+	Shadow-precision error tracking for pipelines of fix32 and fix64 operations.
+
+	fix_shadow<fix32<N>> behaves like fix32<N>, but carries a long double shadow value along, that is
+	computed with the ideal real-valued operation at every operator and fixmath function. The shadow
+	follows the real-valued pipeline from the inputs on, so the difference between the value and the
+	shadow is the error, that the fixed-point pipeline has built up.
+
+	Enable it by defining FIXPOINT_SHADOW before including this header. Otherwise fix_shadow<Fix> is
+	an alias of Fix and fixpoint_track_error(name, value) compiles to the value itself, so release
+	builds are not affected.
+
+	Tag a value with fixpoint_track_error(name, value), that returns the value. Every tagged site
+	accumulates the maximum and mean of the absolute error, and of the error in units of the last place
+	(ulp) 2^-N. At exit a report of all sites is written to std::cerr (see set_report_stream()).
+
+	Example:
+		fix_shadow<fix32<16>> y = gain * x;
+		y = fixpoint_track_error("filter.y", lerp(y, exp2(y), t));	// y itself in release builds
+
+		fixed-point errors against the ideal result:
+		site                    format     count       max abs       mean abs      max ulp     mean ulp    at value
+		filter.y                fix32<16>  1000        3.0518e-05    1.2207e-05    2           0.8         3.14159
+
+	The functions of the fast, balanced and precise tiers of fixmath are shadowed as well, so that
+	the tiers can be compared with the same pipeline.
+*/
+
+#include <cstddef>
+#include <cinttypes>
+#include <cmath>
+#include <mutex>
+#include <vector>
+#include <ostream>
+#include <iomanip>
+#include <string>
+#include <type_traits>
+
+#include "fix32.hpp"
+#include "fix64.hpp"
+#include "fixmath.hpp"
+#include "fixsites.hpp"
+
+namespace fixpoint_error_tracker{
+
+	// the errors of one site, see collect()
+	struct site_report{
+		const char* name;
+		unsigned width;					// of the format, 32 or 64
+		unsigned fractional_bits;		// of the format
+		uint64_t count;
+		double max_abs_error;
+		double mean_abs_error;
+		double max_ulp_error;			// in units of 2^-fractional_bits
+		double mean_ulp_error;
+		double worst_shadow;			// the shadow value with the largest error
+	};
+}
+
+namespace fixpoint_detail{
+
+	template<size_t N> long double exact_value(fix32<N> f){return std::ldexp(static_cast<long double>(f.reinterpret_as_int32()), -static_cast<int>(N));}
+	template<size_t N> long double exact_value(fix64<N> f){return std::ldexp(static_cast<long double>(f.reinterpret_as_int64()), -static_cast<int>(N));}
+
+	/*
+		A fixed-point value together with its shadow, the result of the same operations with real numbers.
+		Comparisons and conversions use the fixed-point value, so that the program takes the same paths.
+	*/
+	template<class Fix>
+	class shadowed{
+	private:
+		Fix fixed = Fix();
+		long double exact = 0;
+
+	public:
+		using value_type = Fix;
+
+		shadowed() = default;
+		shadowed(const shadowed&) = default;
+		shadowed& operator= (const shadowed&) = default;
+
+		// from a fixed-point value, that is taken as exact
+		shadowed(Fix value) : fixed(value), exact(exact_value(value)){}
+
+		// from a number, the shadow keeps the number without rounding
+		template<class Number, std::enable_if_t<std::is_arithmetic<Number>::value, bool> = true>
+		shadowed(Number num) : fixed(num), exact(static_cast<long double>(num)){}
+
+		shadowed(Fix value, long double shadow) : fixed(value), exact(shadow){}
+
+		Fix value() const {return this->fixed;}
+		long double shadow() const {return this->exact;}
+		long double error() const {return exact_value(this->fixed) - this->exact;}
+
+		explicit operator Fix () const {return this->fixed;}
+		explicit operator float () const {Fix f = this->fixed; return static_cast<float>(f);}
+		explicit operator double () const {Fix f = this->fixed; return static_cast<double>(f);}
+
+		// Arithmetic operators
+
+		friend shadowed operator+ (shadowed lhs, shadowed rhs){return shadowed(lhs.fixed + rhs.fixed, lhs.exact + rhs.exact);}
+		friend shadowed operator- (shadowed a){return shadowed(-a.fixed, -a.exact);}
+		friend shadowed operator- (shadowed lhs, shadowed rhs){return shadowed(lhs.fixed - rhs.fixed, lhs.exact - rhs.exact);}
+		friend shadowed operator* (shadowed lhs, shadowed rhs){return shadowed(lhs.fixed * rhs.fixed, lhs.exact * rhs.exact);}
+		friend shadowed operator/ (shadowed lhs, shadowed rhs){return shadowed(lhs.fixed / rhs.fixed, lhs.exact / rhs.exact);}
+
+		template<typename Integer, std::enable_if_t<std::is_integral<Integer>::value, bool> = true>
+		friend shadowed operator* (shadowed lhs, Integer rhs){return shadowed(lhs.fixed * rhs, lhs.exact * rhs);}
+
+		template<typename Integer, std::enable_if_t<std::is_integral<Integer>::value, bool> = true>
+		friend shadowed operator* (Integer lhs, shadowed rhs){return shadowed(lhs * rhs.fixed, lhs * rhs.exact);}
+
+		template<typename Integer, std::enable_if_t<std::is_integral<Integer>::value, bool> = true>
+		friend shadowed operator/ (shadowed lhs, Integer rhs){return shadowed(lhs.fixed / rhs, lhs.exact / rhs);}
+
+		shadowed& operator+= (shadowed rhs){return *this = *this + rhs;}
+		shadowed& operator-= (shadowed rhs){return *this = *this - rhs;}
+		shadowed& operator*= (shadowed rhs){return *this = *this * rhs;}
+		shadowed& operator/= (shadowed rhs){return *this = *this / rhs;}
+
+		// Comparison operators
+
+		friend bool operator== (shadowed lhs, shadowed rhs){return lhs.fixed == rhs.fixed;}
+		friend bool operator!= (shadowed lhs, shadowed rhs){return lhs.fixed != rhs.fixed;}
+		friend bool operator< (shadowed lhs, shadowed rhs){return lhs.fixed < rhs.fixed;}
+		friend bool operator<= (shadowed lhs, shadowed rhs){return lhs.fixed <= rhs.fixed;}
+		friend bool operator> (shadowed lhs, shadowed rhs){return lhs.fixed > rhs.fixed;}
+		friend bool operator>= (shadowed lhs, shadowed rhs){return lhs.fixed >= rhs.fixed;}
+
+		template<class Stream>
+		friend Stream& operator<<(Stream& stream, shadowed f){return stream << f.fixed;}
+	};
+
+	struct error_stats{
+		uint64_t count = 0;
+		long double sum_abs_error = 0;
+		long double max_abs_error = 0;
+		long double worst_shadow = 0;
+	};
+
+	/*
+		The sites and their errors. Unlike the profiler, the errors are not kept per thread: every record()
+		updates the statistics of its site under the mutex, because the shadow is only used in debug builds.
+	*/
+	struct error_registry : site_registry{
+		std::vector<error_stats> stats;		// indexed like sites, grows on the first record() of a site
+
+		static void report(std::ostream& stream);
+	};
+
+	inline error_registry& error_sites(){
+		return registry_of<error_registry>();
+	}
+
+	inline fixpoint_error_tracker::site_report make_error_report(const site_format& site, const error_stats& s){
+		fixpoint_error_tracker::site_report report;
+		const long double ulp = std::ldexp(1.0L, -static_cast<int>(site.fractional_bits));
+		report.name = site.name;
+		report.width = site.width;
+		report.fractional_bits = site.fractional_bits;
+		report.count = s.count;
+		report.max_abs_error = static_cast<double>(s.max_abs_error);
+		report.mean_abs_error = (s.count == 0) ? 0 : static_cast<double>(s.sum_abs_error / s.count);
+		report.max_ulp_error = static_cast<double>(s.max_abs_error / ulp);
+		report.mean_ulp_error = (s.count == 0) ? 0 : static_cast<double>(s.sum_abs_error / s.count / ulp);
+		report.worst_shadow = static_cast<double>(s.worst_shadow);
+		return report;
+	}
+}
+
+namespace fixpoint_error_tracker{
+
+	// a named site, at which the errors of values of one format are accumulated
+	class site : public fixpoint_detail::registered_site<fixpoint_detail::error_registry>{
+	public:
+		site(const char* name, unsigned width, unsigned fractional_bits) : registered_site(name, width, fractional_bits){}
+
+		template<class Fix>
+		site(const char* name, fixpoint_detail::shadowed<Fix>)
+			: site(name, fixpoint_detail::fix_format<Fix>::width, fixpoint_detail::fix_format<Fix>::fractional_bits){}
+
+		template<class Fix>
+		void record(fixpoint_detail::shadowed<Fix> value) const {
+			const long double error = std::fabs(value.error());
+			fixpoint_detail::error_registry& r = fixpoint_detail::error_sites();
+			std::lock_guard<std::mutex> lock(r.mutex);
+			if(this->id >= r.stats.size()){
+				r.stats.resize(this->id + 1);
+			}
+			fixpoint_detail::error_stats& s = r.stats[this->id];
+			++s.count;
+			s.sum_abs_error += error;
+			if(error > s.max_abs_error || s.count == 1){
+				s.max_abs_error = error;
+				s.worst_shadow = value.shadow();
+			}
+		}
+	};
+
+	// returns the errors of all sites
+	inline std::vector<site_report> collect(){
+		fixpoint_detail::error_registry& r = fixpoint_detail::error_sites();
+		std::lock_guard<std::mutex> lock(r.mutex);
+		std::vector<site_report> reports;
+		for(size_t i = 0; i < r.sites.size(); ++i){
+			const fixpoint_detail::error_stats s = (i < r.stats.size()) ? r.stats[i] : fixpoint_detail::error_stats();
+			reports.push_back(fixpoint_detail::make_error_report(r.sites[i], s));
+		}
+		return reports;
+	}
+
+	// writes the errors of all sites as a table to stream
+	inline std::ostream& report(std::ostream& stream){
+		stream << "fixed-point errors against the ideal result:\n";
+		stream << std::left << std::setw(24) << "site" << std::setw(11) << "format" << std::setw(12) << "count"
+			<< std::setw(14) << "max abs" << std::setw(14) << "mean abs" << std::setw(12) << "max ulp"
+			<< std::setw(12) << "mean ulp" << "at value\n";
+		for(const site_report& s : collect()){
+			stream << std::left << std::setw(24) << s.name
+				<< ((s.width == 32) ? "fix32<" : "fix64<") << std::setw(5) << (std::to_string(s.fractional_bits) + ">")
+				<< std::setw(12) << s.count << std::setw(14) << s.max_abs_error << std::setw(14) << s.mean_abs_error
+				<< std::setw(12) << s.max_ulp_error << std::setw(12) << s.mean_ulp_error << s.worst_shadow << '\n';
+		}
+		return stream;
+	}
+
+	// the stream of the report at exit, nullptr disables it
+	inline void set_report_stream(std::ostream* stream){
+		fixpoint_detail::set_report_stream<fixpoint_detail::error_registry>(stream);
+	}
+}
+
+inline void fixpoint_detail::error_registry::report(std::ostream& stream){
+	fixpoint_error_tracker::report(stream);
+}
+
+// fixmath functions, the shadow is computed with the functions of <cmath> in long double
+
+#define FIXPOINT_SHADOW_UNARY(function, fixed_function, exact)										\
+	template<class Fix>																					\
+	fixpoint_detail::shadowed<Fix> function(fixpoint_detail::shadowed<Fix> a){							\
+		const long double x = a.shadow();																\
+		return fixpoint_detail::shadowed<Fix>(fixed_function(a.value()), exact);						\
+	}
+
+#define FIXPOINT_SHADOW_TIER(tier)																		\
+	FIXPOINT_SHADOW_UNARY(exp2, tier::exp2, std::exp2(x))												\
+	FIXPOINT_SHADOW_UNARY(exp, tier::exp, std::exp(x))													\
+	FIXPOINT_SHADOW_UNARY(exp10, tier::exp10, std::pow(10.0L, x))										\
+	FIXPOINT_SHADOW_UNARY(log2, tier::log2, std::log2(x))												\
+	FIXPOINT_SHADOW_UNARY(atan, tier::atan, std::atan(x))												\
+	template<class Fix>																					\
+	fixpoint_detail::shadowed<Fix> atan2(fixpoint_detail::shadowed<Fix> y, fixpoint_detail::shadowed<Fix> x){	\
+		return fixpoint_detail::shadowed<Fix>(tier::atan2(y.value(), x.value()), std::atan2(y.shadow(), x.shadow()));	\
+	}
+
+namespace fixmath{ namespace fast{ FIXPOINT_SHADOW_TIER(fixmath::fast) }}
+namespace fixmath{ namespace balanced{ FIXPOINT_SHADOW_TIER(fixmath::balanced) }}
+namespace fixmath{ namespace precise{ FIXPOINT_SHADOW_TIER(fixmath::precise) }}
+FIXPOINT_SHADOW_TIER(fixmath::balanced)
+
+FIXPOINT_SHADOW_UNARY(expm1, ::expm1, std::expm1(x))
+FIXPOINT_SHADOW_UNARY(abs, ::abs, std::fabs(x))
+FIXPOINT_SHADOW_UNARY(floor, ::floor, std::floor(x))
+FIXPOINT_SHADOW_UNARY(round_down, ::round_down, std::floor(x))
+FIXPOINT_SHADOW_UNARY(ceil, ::ceil, std::ceil(x))
+FIXPOINT_SHADOW_UNARY(round_up, ::round_up, std::ceil(x))
+FIXPOINT_SHADOW_UNARY(tanh, ::tanh, std::tanh(x))
+FIXPOINT_SHADOW_UNARY(sigmoid, ::sigmoid, 1 / (1 + std::exp(-x)))
+FIXPOINT_SHADOW_UNARY(gelu, ::gelu, x / 2 * (1 + std::erf(x / std::sqrt(2.0L))))
+FIXPOINT_SHADOW_UNARY(relu6, ::relu6, (x < 0) ? 0 : (x > 6) ? 6 : x)
+
+#undef FIXPOINT_SHADOW_TIER
+#undef FIXPOINT_SHADOW_UNARY
+
+template<class Fix>
+fixpoint_detail::shadowed<Fix> min(fixpoint_detail::shadowed<Fix> l, fixpoint_detail::shadowed<Fix> r){return (l < r) ? l : r;}
+
+template<class Fix>
+fixpoint_detail::shadowed<Fix> max(fixpoint_detail::shadowed<Fix> l, fixpoint_detail::shadowed<Fix> r){return (l > r) ? l : r;}
+
+template<class Fix>
+fixpoint_detail::shadowed<Fix> lerp(fixpoint_detail::shadowed<Fix> a, fixpoint_detail::shadowed<Fix> b, fixpoint_detail::shadowed<Fix> t){
+	return fixpoint_detail::shadowed<Fix>(::lerp(a.value(), b.value(), t.value()), a.shadow() + (b.shadow() - a.shadow()) * t.shadow());
+}
+
+template<class Fix>
+fixpoint_detail::shadowed<Fix> lerp(fixpoint_detail::shadowed<Fix> x0, fixpoint_detail::shadowed<Fix> x1,
+		fixpoint_detail::shadowed<Fix> y0, fixpoint_detail::shadowed<Fix> y1, fixpoint_detail::shadowed<Fix> x){
+	const long double exact = (x.shadow() - x0.shadow()) * (y1.shadow() - y0.shadow()) / (x1.shadow() - x0.shadow()) + y0.shadow();
+	return fixpoint_detail::shadowed<Fix>(::lerp(x0.value(), x1.value(), y0.value(), y1.value(), x.value()), exact);
+}
+
+#if defined(FIXPOINT_SHADOW)
+	template<class Fix> using fix_shadow = fixpoint_detail::shadowed<Fix>;
+
+	#define fixpoint_track_error(name, value) FIXPOINT_RECORD_AT_SITE(fixpoint_error_tracker::site, name, value)
+#else
+	template<class Fix> using fix_shadow = Fix;
+
+	#define fixpoint_track_error(name, value) (value)
+#endif
@@ -0,0 +1,107 @@
+#pragma once
+/*
+
+	Author: Tobias Wallner
+	tobias.wallner1@gmx.net
+
+	The named sites of the value-range profiler (fixprofile.hpp) and of the error tracker (fixshadow.hpp).
+
+	Both tag values with a macro, that creates a site on its first use and records the value at it.
+	A site has a name and the format of its values and gets the index of its statistics from a registry.
+	The registry of each tool writes the report of all sites to a stream when the program exits.
+
+	A tool derives its registry from site_registry, adds its statistics and declares
+		static void report(std::ostream& stream);
+	which writes the report at exit. The registry is locked with its mutex.
+*/
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+#include <ostream>
+#include <iostream>
+
+template<size_t fractional_bits> class fix32;
+template<size_t fractional_bits> class fix64;
+
+namespace fixpoint_detail{
+
+	template<class Fix> struct fix_format;
+	template<size_t N> struct fix_format<fix32<N>>{static constexpr unsigned width = 32; static constexpr unsigned fractional_bits = N;};
+	template<size_t N> struct fix_format<fix64<N>>{static constexpr unsigned width = 64; static constexpr unsigned fractional_bits = N;};
+
+	struct site_format{
+		const char* name;
+		unsigned width;					// of the format, 32 or 64
+		unsigned fractional_bits;		// of the format
+	};
+
+	struct site_registry{
+		std::mutex mutex;
+		std::vector<site_format> sites;	// indexed by the id of the site
+		std::ostream* stream = &std::cerr;
+	};
+
+	// writes the report of Registry at exit
+	template<class Registry>
+	struct site_reporter{
+		~site_reporter();
+	};
+
+	/*
+		The registry of a tool. It is created on the first use and never destroyed, so that it is still valid
+		for the reporter and for everything else that runs during the destruction of static objects.
+	*/
+	template<class Registry>
+	Registry& registry_of(){
+		static Registry* r = new Registry();
+		static site_reporter<Registry> reporter;
+		return *r;
+	}
+
+	template<class Registry>
+	site_reporter<Registry>::~site_reporter(){
+		Registry& r = registry_of<Registry>();
+		std::ostream* stream = nullptr;
+		{
+			std::lock_guard<std::mutex> lock(r.mutex);
+			stream = r.stream;
+		}
+		if(stream != nullptr && !r.sites.empty()){
+			Registry::report(*stream);
+		}
+	}
+
+	// a site of the registry of a tool, the tool adds the recording
+	template<class Registry>
+	class registered_site{
+	protected:
+		size_t id;
+
+	public:
+		registered_site(const char* name, unsigned width, unsigned fractional_bits){
+			Registry& r = registry_of<Registry>();
+			std::lock_guard<std::mutex> lock(r.mutex);
+			this->id = r.sites.size();
+			r.sites.push_back(site_format{name, width, fractional_bits});
+		}
+	};
+
+	template<class Registry>
+	void set_report_stream(std::ostream* stream){
+		Registry& r = registry_of<Registry>();
+		std::lock_guard<std::mutex> lock(r.mutex);
+		r.stream = stream;
+	}
+}
+
+/*
+	Records value at the site of type Site named name and returns the value. The site is a static of the
+	lambda, so it is created once per use of the macro. The lambda is generic, so that value may be any
+	expression, whose type Site accepts.
+*/
+#define FIXPOINT_RECORD_AT_SITE(Site, name, value) ([](auto fixpoint_site_value){				\
+		static const Site fixpoint_site(name, fixpoint_site_value);							\
+		fixpoint_site.record(fixpoint_site_value);											\
+		return fixpoint_site_value;															\
+	}(value))
@@ -0,0 +1,961 @@
+#pragma once
+/*
+
+	Author: Tobias Wallner
+	tobias.wallner1@gmx.net
+
+*/
+
+#include <cstddef>
+#include <cinttypes>
+#include <vector>
+#include <cmath>
+#include <utility>
+
+#include "fixmath.hpp"
+
+namespace fixpoint_detail{
+	// returns the number of bits needed to represent value, 0 for 0
+	inline int bit_width(uint64_t value){
+#if defined(__GNUC__)
+		return (value == 0) ? 0 : 64 - __builtin_clzll(value);
+#else
+		int width = 0;
+		while(value != 0){
+			value >>= 1;
+			++width;
+		}
+		return width;
+#endif
+	}
+
+	// returns (a * 2^shift) / b rounded towards zero, with a 128-bit intermediate dividend. shift has to be in the range [0, 63)
+	inline int64_t div_shift(int64_t a, int64_t b, int shift){
+#if defined(__SIZEOF_INT128__)
+		return static_cast<int64_t>((static_cast<__int128>(a) * (static_cast<__int128>(1) << shift)) / b);
+#else
+		const bool sign = (a < 0) != (b < 0);
+		const uint64_t abs_a = (a < 0) ? -static_cast<uint64_t>(a) : static_cast<uint64_t>(a);
+		const uint64_t abs_b = (b < 0) ? -static_cast<uint64_t>(b) : static_cast<uint64_t>(b);
+
+		// long division of the dividend abs_a * 2^shift, one bit at a time
+		uint64_t quotient = 0;
+		uint64_t remainder = 0;
+		for(int bit = 63 + shift; bit >= 0; --bit){
+			const bool carry = (remainder >> 63) != 0;
+			const uint64_t next = (bit >= shift) ? ((abs_a >> (bit - shift)) & 1) : 0;
+			remainder = (remainder << 1) | next;
+			if(carry || remainder >= abs_b){
+				remainder -= abs_b;
+				quotient |= (bit < 64) ? (static_cast<uint64_t>(1) << bit) : 0;
+			}
+		}
+		return sign ? -static_cast<int64_t>(quotient) : static_cast<int64_t>(quotient);
+#endif
+	}
+
+	// common access to the raw integer of fix32 and fix64, so that tables can be written once for both
+	template<class Fix> struct fix_traits;
+
+	template<size_t N> struct fix_traits<fix32<N>>{
+		using raw_type = int32_t;
+		static constexpr size_t fractional_bits = N;
+		static constexpr int64_t raw(fix32<N> f){return f.reinterpret_as_int32();}
+		static constexpr fix32<N> make(int64_t raw){return fix32<N>::reinterpret(static_cast<int32_t>(raw));}
+
+		// returns (a * b) / 2^shift rounded to the nearest, with a 128-bit intermediate product, so that
+		// extrapolating far outside of a table wraps around instead of overflowing
+		static constexpr int64_t mul_shift(int64_t a, int64_t b, int shift){
+			return (shift == 0) ? static_cast<int64_t>(static_cast<uint64_t>(a) * static_cast<uint64_t>(b)) : mul_shift_round(a, b, shift);
+		}
+
+		// slopes dy/dx of raw differences are stored with slope_shift = 30 fractional bits,
+		// which always fits, because dy has at most 33 bits
+		static int slope_shift(int64_t, int64_t){return 30;}
+		static int64_t slope(int64_t dy, int64_t dx, int shift){return (dy * (static_cast<int64_t>(1) << shift)) / dx;}
+		static int64_t mul_slope(int64_t slope, int64_t dx, int shift){return mul_shift_round(slope, dx, shift);}
+
+		// spline coefficients carry 16 guard bits below the raw value
+		static constexpr int guard_bits = 16;
+		static constexpr int64_t drop_guard(int64_t w){return (w + (static_cast<int64_t>(1) << (guard_bits - 1))) >> guard_bits;}
+	};
+
+	template<size_t N> struct fix_traits<fix64<N>>{
+		using raw_type = int64_t;
+		static constexpr size_t fractional_bits = N;
+		static constexpr int64_t raw(fix64<N> f){return f.reinterpret_as_int64();}
+		static constexpr fix64<N> make(int64_t raw){return fix64<N>::reinterpret(raw);}
+
+		// returns (a * b) / 2^shift rounded to the nearest, with a 128-bit intermediate product
+		static constexpr int64_t mul_shift(int64_t a, int64_t b, int shift){
+			return (shift == 0) ? static_cast<int64_t>(static_cast<uint64_t>(a) * static_cast<uint64_t>(b)) : mul_shift_round(a, b, shift);
+		}
+
+		// slopes dy/dx of raw differences are stored with 'shift' fractional bits. slope_shift() returns
+		// the largest shift up to 62 for which |dy/dx| * 2^shift < 2^62, a table stores it for each segment
+		static int slope_shift(int64_t dy, int64_t dx){
+			const int dy_bits = bit_width((dy < 0) ? -static_cast<uint64_t>(dy) : static_cast<uint64_t>(dy));
+			const int dx_bits = bit_width((dx < 0) ? -static_cast<uint64_t>(dx) : static_cast<uint64_t>(dx));
+			const int shift = 61 - dy_bits + dx_bits;
+			return (shift < 0) ? 0 : (shift > 62) ? 62 : shift;
+		}
+		static int64_t slope(int64_t dy, int64_t dx, int shift){return div_shift(dy, dx, shift);}
+		static int64_t mul_slope(int64_t slope, int64_t dx, int shift){return mul_shift(slope, dx, shift);}
+
+		// spline coefficients have no room for guard bits
+		static constexpr int guard_bits = 0;
+		static constexpr int64_t drop_guard(int64_t w){return w;}
+	};
+
+	// returns the number of trailing zero bits of value. value has to be non-zero
+	inline int count_trailing_zeros(uint64_t value){
+#if defined(__GNUC__)
+		return __builtin_ctzll(value);
+#else
+		int count = 0;
+		while((value & 1) == 0){
+			value >>= 1;
+			++count;
+		}
+		return count;
+#endif
+	}
+
+	// returns the segment i in [0, size-2] with x_i <= value < x_i+1, clamped to the first and last segment
+	template<class Fix>
+	size_t find_segment(const Fix* x, size_t size, Fix value){
+		size_t first = 1;
+		size_t count = size - 2;
+		while(count > 0){
+			const size_t step = count / 2;
+			if(x[first + step] <= value){
+				first += step + 1;
+				count -= step + 1;
+			}else{
+				count = step;
+			}
+		}
+		return first - 1;
+	}
+}
+
+// ================ Uniform Lookup Tables ================
+
+// ---------------- uniform_lut ----------------
+
+/*
+	Lookup table with linear interpolation between uniformly spaced breakpoints:
+		x_i = x_first + i * 2^step_log2		for i in [0, Size)
+
+	Because the step is a power of two, the segment index is a shift of (x - x_first) and
+	the interpolation weight are its lower bits. An evaluation needs neither a search nor a division.
+	Outside of [x_first, x_last] the first and the last segment are extrapolated, like lerp() does.
+
+	Example: 17 values of sin(x) in [0, 1] with a step of 1/16:
+		constexpr uniform_lut<fix32<16>, 17> sin_lut(0, -4, {...});
+		fix32<16> y = sin_lut(x);
+
+	Preconditions: the step 2^step_log2 has to be representable by Fix, so that 0 <= fractional_bits + step_log2,
+	and x_last has to be representable by Fix.
+*/
+template<class Fix, size_t Size>
+class uniform_lut{
+	static_assert(Size >= 2, "uniform_lut needs at least 2 breakpoints");
+	using traits = fixpoint_detail::fix_traits<Fix>;
+
+private:
+	Fix x0;
+	int shift;
+	Fix y[Size];
+
+public:
+	constexpr uniform_lut(Fix x_first, int step_log2, const Fix (&y_values)[Size])
+		: x0(x_first)
+		, shift(static_cast<int>(traits::fractional_bits) + step_log2)
+		, y{}
+	{
+		fixpoint_assert(0 <= this->shift && this->shift < 63, "Error: the step 2^" << step_log2 << " of uniform_lut is not representable");
+		for(size_t i = 0; i < Size; ++i){
+			y[i] = y_values[i];
+		}
+	}
+
+	constexpr Fix operator()(Fix x) const {return this->eval(x);}
+
+	constexpr Fix eval(Fix x) const {
+		// the distance to x_first as magnitude, which does not overflow for fix64 tables that span more than half of the range
+		const bool below = x < this->x0;
+		const uint64_t distance = below ? static_cast<uint64_t>(traits::raw(this->x0)) - static_cast<uint64_t>(traits::raw(x))
+			: static_cast<uint64_t>(traits::raw(x)) - static_cast<uint64_t>(traits::raw(this->x0));
+		const uint64_t i_unclamped = distance >> this->shift;
+		const uint64_t i = below ? 0 : (i_unclamped > static_cast<uint64_t>(Size - 2)) ? static_cast<uint64_t>(Size - 2) : i_unclamped;
+		// the weight saturates more than 2^63 ulp outside of the table
+		const uint64_t w_abs = distance - (i << this->shift);
+		const int64_t w_saturated = (w_abs > static_cast<uint64_t>(INT64_MAX)) ? INT64_MAX : static_cast<int64_t>(w_abs);
+		const int64_t w = below ? -w_saturated : w_saturated;
+		const int64_t y0 = traits::raw(this->y[i]);
+		const int64_t dy = traits::raw(this->y[i+1]) - y0;
+		return traits::make(y0 + traits::mul_shift(dy, w, this->shift));
+	}
+
+	// evaluates every element in [first, last) and writes the results to out.
+	// the loop has no data dependent branches, so that the table reads can be vectorized into gathers.
+	Fix* eval(const Fix* first, const Fix* last, Fix* out) const {
+		for(; first != last; ++first, ++out){
+			*out = this->eval(*first);
+		}
+		return out;
+	}
+
+	constexpr Fix x_first() const {return this->x0;}
+	constexpr Fix x_last() const {return traits::make(traits::raw(this->x0) + static_cast<int64_t>(Size - 1) * (static_cast<int64_t>(1) << this->shift));}
+	constexpr Fix step() const {return traits::make(static_cast<int64_t>(1) << this->shift);}
+	constexpr Fix operator[](size_t i) const {return this->y[i];}
+	static constexpr size_t size(){return Size;}
+};
+
+// ================ Piecewise Linear Tables ================
+
+// ---------------- pwl_table ----------------
+
+/*
+	Lookup table with linear interpolation between arbitrary, strictly increasing breakpoints.
+
+	The slopes of all segments are calculated once on construction, so that an evaluation is a
+	search plus a single multiplication:
+		y = y_i + slope_i * (x - x_i)
+	Outside of [x_first, x_last] the first and the last segment are extrapolated, like lerp() does.
+
+	For queries that move slowly, like time series, pass a hint (or use a cursor) that remembers the
+	last segment. The search then starts there and gallops outwards, which is O(1) when x stays
+	in the same or a neighbouring segment and O(log(distance)) otherwise.
+
+	Example:
+		const pwl_table<fix32<16>, 4> table(x_values, y_values);
+		fix32<16> y = table(x);
+
+		auto c = table.make_cursor();
+		for(fix32<16> x : samples) process(c(x));
+*/
+template<class Fix, size_t Size>
+class pwl_table{
+	static_assert(Size >= 2, "pwl_table needs at least 2 breakpoints");
+	using traits = fixpoint_detail::fix_traits<Fix>;
+
+private:
+	Fix x[Size];
+	Fix y[Size];
+	int64_t slope[Size-1]; // (y_i+1 - y_i) / (x_i+1 - x_i) with slope_shift[i] fractional bits, see fix_traits::slope()
+	int8_t slope_shift[Size-1];
+
+	Fix eval_segment(size_t i, Fix xv) const {
+		const int64_t d = traits::raw(xv) - traits::raw(this->x[i]);
+		return traits::make(traits::raw(this->y[i]) + traits::mul_slope(this->slope[i], d, this->slope_shift[i]));
+	}
+
+public:
+
+	pwl_table(const Fix (&x_values)[Size], const Fix (&y_values)[Size]){
+		for(size_t i = 0; i < Size; ++i){
+			this->x[i] = x_values[i];
+			this->y[i] = y_values[i];
+		}
+		for(size_t i = 0; i < Size - 1; ++i){
+			fixpoint_assert(this->x[i] < this->x[i+1], "Error: the breakpoints of pwl_table have to be strictly increasing. x[" << i << "] >= x[" << i+1 << "]");
+			const int64_t dx = traits::raw(this->x[i+1]) - traits::raw(this->x[i]);
+			const int64_t dy = traits::raw(this->y[i+1]) - traits::raw(this->y[i]);
+			this->slope_shift[i] = static_cast<int8_t>(traits::slope_shift(dy, dx));
+			this->slope[i] = traits::slope(dy, dx, this->slope_shift[i]);
+		}
+	}
+
+	// returns the segment i in [0, Size-2] with x_i <= x < x_i+1, clamped to the first and last segment
+	size_t segment(Fix xv) const {return fixpoint_detail::find_segment(this->x, Size, xv);}
+
+	// returns the segment of x by searching outwards from the segment 'hint'
+	size_t segment(Fix xv, size_t hint) const {
+		size_t lower = (hint < Size - 1) ? hint : Size - 2;
+		size_t upper = lower + 1;
+
+		if(this->x[upper] <= xv){
+			// gallop forward until x[upper] > xv
+			size_t step = 1;
+			while(upper < Size - 1 && this->x[upper] <= xv){
+				lower = upper;
+				upper = (upper + step < Size - 1) ? upper + step : Size - 1;
+				step *= 2;
+			}
+			if(this->x[upper] <= xv) return Size - 2;
+		}else if(xv < this->x[lower]){
+			// gallop backward until x[lower] <= xv
+			size_t step = 1;
+			while(lower > 0 && xv < this->x[lower]){
+				upper = lower;
+				lower = (lower > step) ? lower - step : 0;
+				step *= 2;
+			}
+			if(xv < this->x[lower]) return 0;
+		}
+
+		// binary search in [lower, upper) for the last x_i <= xv
+		while(upper - lower > 1){
+			const size_t middle = lower + (upper - lower) / 2;
+			if(this->x[middle] <= xv){
+				lower = middle;
+			}else{
+				upper = middle;
+			}
+		}
+		return lower;
+	}
+
+	Fix operator()(Fix xv) const {return this->eval(xv);}
+
+	Fix eval(Fix xv) const {return this->eval_segment(this->segment(xv), xv);}
+
+	// evaluates x and updates 'hint' to the segment of x, for queries with locality
+	Fix eval(Fix xv, size_t& hint) const {
+		hint = this->segment(xv, hint);
+		return this->eval_segment(hint, xv);
+	}
+
+	// evaluates every element in the sorted range [first, last) and writes the results to out.
+	// walks the queries and the breakpoints together like a merge, so each breakpoint is visited once.
+	Fix* eval_sorted(const Fix* first, const Fix* last, Fix* out) const {
+		size_t i = 0;
+		for(; first != last; ++first, ++out){
+			while(i < Size - 2 && this->x[i+1] <= *first){
+				++i;
+			}
+			*out = this->eval_segment(i, *first);
+		}
+		return out;
+	}
+
+	// remembers the segment of the last query
+	class cursor{
+	private:
+		const pwl_table* table;
+		size_t hint;
+
+	public:
+		cursor(const pwl_table& table, size_t hint = 0) : table(&table), hint(hint){}
+		Fix operator()(Fix xv){return this->table->eval(xv, this->hint);}
+		size_t segment() const {return this->hint;}
+	};
+
+	cursor make_cursor(size_t hint = 0) const {return cursor(*this, hint);}
+
+	Fix x_first() const {return this->x[0];}
+	Fix x_last() const {return this->x[Size-1];}
+	static constexpr size_t size(){return Size;}
+};
+
+// ---------------- eytzinger_pwl_table ----------------
+
+/*
+	Lookup table with linear interpolation for large numbers of breakpoints (thousands to millions),
+	which are set at runtime.
+
+	The binary search of lerp() and pwl_table jumps across the whole array, so on tables that do not
+	fit into the cache every level is a cache miss and, because the direction is random, a branch mispredict.
+	This table stores the breakpoints in Eytzinger (breadth first) order instead:
+		node k has its children at 2k and 2k+1
+	The search descends with 'k = 2k + (x_k <= x)', which compiles to a conditional move. At node k it
+	prefetches the cache line at node 16k (fix32) or 8k (fix64), which holds the 16 descendants four levels
+	down or the 8 descendants three levels down, so that the memory latency overlaps with the comparisons.
+
+	The segment values (x_i, y_i, slope_i, shift_i) are kept in parallel arrays in the same order as the
+	search tree, so that the result of the search indexes them directly.
+	Outside of [x_first, x_last] the first and the last segment are extrapolated, like lerp() does.
+
+	Example:
+		eytzinger_pwl_table<fix32<16>> table(x.data(), x.data() + x.size(), y.data());
+		fix32<16> v = table(x);
+*/
+template<class Fix>
+class eytzinger_pwl_table{
+	using traits = fixpoint_detail::fix_traits<Fix>;
+
+private:
+	static constexpr size_t prefetch_stride = 64 / sizeof(Fix);
+
+	size_t n;
+	std::vector<Fix> keys;           // breakpoints in Eytzinger order, index 0 is unused
+	std::vector<Fix> segment_x;      // start of the segment that node k selects
+	std::vector<Fix> segment_y;
+	std::vector<int64_t> segment_slope;  // with segment_shift fractional bits, see fix_traits::slope()
+	std::vector<int8_t> segment_shift;
+
+	// fills the nodes in order, so that an in-order traversal yields the sorted breakpoints.
+	// rank[k] is the index of the breakpoint that is stored in node k.
+	size_t build(const Fix* x_first, std::vector<size_t>& rank, size_t i, size_t k){
+		if(k <= this->n){
+			i = this->build(x_first, rank, i, 2 * k);
+			this->keys[k] = x_first[i];
+			rank[k] = i;
+			i = this->build(x_first, rank, i + 1, 2 * k + 1);
+		}
+		return i;
+	}
+
+	void set_segment(size_t k, const Fix* x_first, const Fix* y_first, size_t i){
+		const int64_t dx = traits::raw(x_first[i+1]) - traits::raw(x_first[i]);
+		const int64_t dy = traits::raw(y_first[i+1]) - traits::raw(y_first[i]);
+		this->segment_x[k] = x_first[i];
+		this->segment_y[k] = y_first[i];
+		this->segment_shift[k] = static_cast<int8_t>(traits::slope_shift(dy, dx));
+		this->segment_slope[k] = traits::slope(dy, dx, this->segment_shift[k]);
+	}
+
+public:
+	eytzinger_pwl_table(const Fix* x_first, const Fix* x_last, const Fix* y_first)
+		: n(static_cast<size_t>(x_last - x_first))
+		, keys(n + 1)
+		, segment_x(n + 1)
+		, segment_y(n + 1)
+		, segment_slope(n + 1)
+		, segment_shift(n + 1)
+	{
+		fixpoint_assert(this->n >= 2, "Error: eytzinger_pwl_table needs at least 2 breakpoints, but got " << this->n);
+		for(size_t i = 0; i + 1 < this->n; ++i){
+			fixpoint_assert(x_first[i] < x_first[i+1], "Error: the breakpoints of eytzinger_pwl_table have to be strictly increasing. x[" << i << "] >= x[" << i+1 << "]");
+		}
+
+		std::vector<size_t> rank(this->n + 1);
+		this->build(x_first, rank, 0, 1);
+
+		// node 0 is the result of the search for x < x_first
+		this->set_segment(0, x_first, y_first, 0);
+		for(size_t k = 1; k <= this->n; ++k){
+			const size_t i = rank[k];
+			this->set_segment(k, x_first, y_first, (i < this->n - 1) ? i : this->n - 2);
+		}
+	}
+
+	// returns the node of the last breakpoint x_i <= x, or 0 if x < x_first
+	size_t search(Fix x) const {
+		const Fix* tree = this->keys.data();
+		size_t k = 1;
+		while(k <= this->n){
+#if defined(__GNUC__)
+			__builtin_prefetch(tree + prefetch_stride * k);
+#endif
+			k = 2 * k + static_cast<size_t>(tree[k] <= x);
+		}
+		// k encodes the path from the root: the last node where the search went right (1 bit) is the result
+		return k >> (fixpoint_detail::count_trailing_zeros(k) + 1);
+	}
+
+	Fix operator()(Fix x) const {return this->eval(x);}
+
+	Fix eval(Fix x) const {
+		const size_t k = this->search(x);
+		const int64_t d = traits::raw(x) - traits::raw(this->segment_x[k]);
+		return traits::make(traits::raw(this->segment_y[k]) + traits::mul_slope(this->segment_slope[k], d, this->segment_shift[k]));
+	}
+
+	// evaluates every element in [first, last) and writes the results to out.
+	Fix* eval(const Fix* first, const Fix* last, Fix* out) const {
+		for(; first != last; ++first, ++out){
+			*out = this->eval(*first);
+		}
+		return out;
+	}
+
+	size_t size() const {return this->n;}
+};
+
+// ================ Spline Tables ================
+
+/*
+	Selects how the derivatives at the breakpoints of a spline table are chosen:
+		natural:     cubic spline with a continuous second derivative that is zero at both ends.
+		             Smoothest curve, but may overshoot between breakpoints.
+		monotone:    Fritsch-Carlson monotone cubic Hermite spline. Does not overshoot, so monotone
+		             data stays monotone.
+		catmull_rom: Catmull-Rom spline, the derivative is the slope between the neighbouring breakpoints.
+		             Local: a breakpoint only changes the 4 segments around it.
+*/
+enum class spline_kind{
+	natural,
+	monotone,
+	catmull_rom
+};
+
+namespace fixpoint_detail{
+	// the position u in [0, 1] within a segment of a table has 60 fractional bits
+	constexpr int position_bits = 60;
+
+	// calculates the derivatives at the breakpoints (x, y) with n >= 2 points
+	inline std::vector<long double> spline_derivatives(spline_kind kind, const long double* x, const long double* y, size_t n){
+		std::vector<long double> h(n - 1);
+		std::vector<long double> delta(n - 1);
+		for(size_t i = 0; i < n - 1; ++i){
+			h[i] = x[i+1] - x[i];
+			delta[i] = (y[i+1] - y[i]) / h[i];
+		}
+
+		std::vector<long double> m(n);
+		m[0] = delta[0];
+		m[n-1] = delta[n-2];
+		switch(kind){
+			case spline_kind::natural: {
+				// solve the tridiagonal system for the second derivatives M with M_0 = M_n-1 = 0
+				std::vector<long double> M(n, 0.0L);
+				std::vector<long double> diagonal(n, 1.0L);
+				std::vector<long double> rhs(n, 0.0L);
+				for(size_t i = 1; i < n - 1; ++i){
+					diagonal[i] = 2 * (h[i-1] + h[i]);
+					rhs[i] = 6 * (delta[i] - delta[i-1]);
+				}
+				for(size_t i = 2; i < n - 1; ++i){
+					const long double factor = h[i-1] / diagonal[i-1];
+					diagonal[i] -= factor * h[i-1];
+					rhs[i] -= factor * rhs[i-1];
+				}
+				for(size_t i = n - 2; i >= 1; --i){
+					M[i] = (rhs[i] - h[i] * M[i+1]) / diagonal[i];
+				}
+				for(size_t i = 0; i < n - 1; ++i){
+					m[i] = delta[i] - h[i] * (2 * M[i] + M[i+1]) / 6;
+				}
+				m[n-1] = delta[n-2] + h[n-2] * (M[n-2] + 2 * M[n-1]) / 6;
+			} break;
+			case spline_kind::monotone: {
+				for(size_t i = 1; i < n - 1; ++i){
+					m[i] = (delta[i-1] * delta[i] > 0) ? (delta[i-1] + delta[i]) / 2 : 0.0L;
+				}
+				for(size_t i = 0; i < n - 1; ++i){
+					if(delta[i] == 0){
+						m[i] = 0;
+						m[i+1] = 0;
+					}else{
+						const long double alpha = m[i] / delta[i];
+						const long double beta = m[i+1] / delta[i];
+						const long double r = alpha * alpha + beta * beta;
+						if(r > 9){
+							const long double tau = 3 / std::sqrt(r);
+							m[i] = tau * alpha * delta[i];
+							m[i+1] = tau * beta * delta[i];
+						}
+					}
+				}
+			} break;
+			case spline_kind::catmull_rom: {
+				for(size_t i = 1; i < n - 1; ++i){
+					m[i] = (y[i+1] - y[i-1]) / (x[i+1] - x[i-1]);
+				}
+			} break;
+		}
+		return m;
+	}
+
+	// calculates the coefficients of y = c0 + c1*u + c2*u^2 + c3*u^3 of every segment, with u in [0, 1]
+	// and c in raw units of Fix with fix_traits<Fix>::guard_bits additional fractional bits
+	template<class Fix>
+	void spline_coefficients(spline_kind kind, const long double* x, const Fix* y_values, size_t n, int64_t (*coefficient)[4]){
+		using traits = fix_traits<Fix>;
+		std::vector<long double> y(n);
+		for(size_t i = 0; i < n; ++i) y[i] = static_cast<long double>(traits::raw(y_values[i]));
+
+		const std::vector<long double> m = spline_derivatives(kind, x, y.data(), n);
+		for(size_t i = 0; i < n - 1; ++i){
+			const long double h = x[i+1] - x[i];
+			const long double c[4] = {
+				y[i],
+				h * m[i],
+				3 * (y[i+1] - y[i]) - h * (2 * m[i] + m[i+1]),
+				2 * (y[i] - y[i+1]) + h * (m[i] + m[i+1])
+			};
+			for(int k = 0; k < 4; ++k){
+				coefficient[i][k] = static_cast<int64_t>(std::llround(std::ldexp(c[k], traits::guard_bits)));
+			}
+		}
+	}
+
+	// evaluates the segment polynomial with Horner's scheme at u with position_bits fractional bits
+	template<class Fix>
+	Fix spline_horner(const int64_t (&c)[4], int64_t u){
+		using traits = fix_traits<Fix>;
+		int64_t acc = c[3];
+		acc = c[2] + mul_shift_round(acc, u, position_bits);
+		acc = c[1] + mul_shift_round(acc, u, position_bits);
+		acc = c[0] + mul_shift_round(acc, u, position_bits);
+		return traits::make(traits::drop_guard(acc));
+	}
+}
+
+// ---------------- spline_table ----------------
+
+/*
+	Lookup table with cubic interpolation between arbitrary, strictly increasing breakpoints.
+
+	A smooth curve needs far fewer breakpoints with cubic than with linear interpolation, so the
+	table stays small enough for the cache. The cubic of every segment is calculated once on
+	construction and evaluated with Horner's scheme in a 64-bit format with guard bits:
+		y = c0 + u*(c1 + u*(c2 + u*c3)),	u = (x - x_i) / (x_i+1 - x_i)
+	where the division is a multiplication with the precalculated reciprocal of the segment width.
+	Outside of [x_first, x_last] the result is clamped to the first and last value, because cubics
+	extrapolate poorly.
+
+	Example:
+		const spline_table<fix32<16>, 9> table(x_values, y_values, spline_kind::monotone);
+		fix32<16> y = table(x);
+
+	Preconditions: the width of a segment has to be smaller than 2^62 raw steps.
+*/
+template<class Fix, size_t Size>
+class spline_table{
+	static_assert(Size >= 2, "spline_table needs at least 2 breakpoints");
+	using traits = fixpoint_detail::fix_traits<Fix>;
+
+private:
+	Fix x[Size];
+	int64_t coefficient[Size-1][4];
+	int64_t inv_width[Size-1]; // 2^(position_bits + inv_shift) / (x_i+1 - x_i)
+	int inv_shift[Size-1];
+
+public:
+	spline_table(const Fix (&x_values)[Size], const Fix (&y_values)[Size], spline_kind kind = spline_kind::natural){
+		long double xl[Size];
+		for(size_t i = 0; i < Size; ++i){
+			this->x[i] = x_values[i];
+			xl[i] = static_cast<long double>(traits::raw(x_values[i]));
+		}
+		for(size_t i = 0; i < Size - 1; ++i){
+			fixpoint_assert(this->x[i] < this->x[i+1], "Error: the breakpoints of spline_table have to be strictly increasing. x[" << i << "] >= x[" << i+1 << "]");
+			const uint64_t width = static_cast<uint64_t>(traits::raw(this->x[i+1]) - traits::raw(this->x[i]));
+			fixpoint_assert(width < (static_cast<uint64_t>(1) << 62), "Error: the segment x[" << i << "] to x[" << i+1 << "] of spline_table is too wide");
+			this->inv_shift[i] = fixpoint_detail::bit_scan_reverse(width) + 1;
+			this->inv_width[i] = static_cast<int64_t>(std::ldexp(1.0L, fixpoint_detail::position_bits + this->inv_shift[i]) / static_cast<long double>(width));
+		}
+		fixpoint_detail::spline_coefficients(kind, xl, y_values, Size, this->coefficient);
+	}
+
+	Fix operator()(Fix xv) const {return this->eval(xv);}
+
+	Fix eval(Fix xv) const {
+		const Fix xc = (xv < this->x[0]) ? this->x[0] : (this->x[Size-1] < xv) ? this->x[Size-1] : xv;
+		const size_t i = fixpoint_detail::find_segment(this->x, Size, xc);
+		const int64_t d = traits::raw(xc) - traits::raw(this->x[i]);
+		const int64_t u = fixpoint_detail::mul_shift_round(d, this->inv_width[i], this->inv_shift[i]);
+		return fixpoint_detail::spline_horner<Fix>(this->coefficient[i], u);
+	}
+
+	// evaluates every element in [first, last) and writes the results to out.
+	Fix* eval(const Fix* first, const Fix* last, Fix* out) const {
+		for(; first != last; ++first, ++out){
+			*out = this->eval(*first);
+		}
+		return out;
+	}
+
+	Fix x_first() const {return this->x[0];}
+	Fix x_last() const {return this->x[Size-1];}
+	static constexpr size_t size(){return Size;}
+};
+
+// ---------------- uniform_spline_table ----------------
+
+/*
+	Lookup table with cubic interpolation between uniformly spaced breakpoints:
+		x_i = x_first + i * 2^step_log2		for i in [0, Size)
+
+	Like uniform_lut the segment index and the position within the segment are the upper and lower
+	bits of (x - x_first), so an evaluation needs neither a search nor a division.
+	Outside of [x_first, x_last] the result is clamped to the first and last value.
+
+	Example: 9 values of sin(x) in [0, 2] with a step of 1/4:
+		const uniform_spline_table<fix32<16>, 9> sin_table(0, -2, {...});
+
+	Preconditions: the step 2^step_log2 has to be representable by Fix, so that 0 <= fractional_bits + step_log2,
+	and x_last has to be representable by Fix.
+*/
+template<class Fix, size_t Size>
+class uniform_spline_table{
+	static_assert(Size >= 2, "uniform_spline_table needs at least 2 breakpoints");
+	using traits = fixpoint_detail::fix_traits<Fix>;
+
+private:
+	Fix x0;
+	int shift;
+	int64_t coefficient[Size-1][4];
+
+public:
+	uniform_spline_table(Fix x_first, int step_log2, const Fix (&y_values)[Size], spline_kind kind = spline_kind::natural)
+		: x0(x_first)
+		, shift(static_cast<int>(traits::fractional_bits) + step_log2)
+	{
+		fixpoint_assert(0 <= this->shift && this->shift < 63, "Error: the step 2^" << step_log2 << " of uniform_spline_table is not representable");
+		long double xl[Size];
+		for(size_t i = 0; i < Size; ++i){
+			xl[i] = std::ldexp(static_cast<long double>(i), this->shift);
+		}
+		fixpoint_detail::spline_coefficients(kind, xl, y_values, Size, this->coefficient);
+	}
+
+	Fix operator()(Fix x) const {return this->eval(x);}
+
+	Fix eval(Fix x) const {
+		const int64_t d_max = static_cast<int64_t>(Size - 1) << this->shift;
+		const int64_t d_unclamped = traits::raw(x) - traits::raw(this->x0);
+		const int64_t d = (d_unclamped < 0) ? 0 : (d_unclamped > d_max) ? d_max : d_unclamped;
+		const int64_t i_unclamped = d >> this->shift;
+		const int64_t i = (i_unclamped > static_cast<int64_t>(Size - 2)) ? static_cast<int64_t>(Size - 2) : i_unclamped;
+		const int64_t r = d - (i << this->shift);
+		const int64_t u = (this->shift <= fixpoint_detail::position_bits) ? (r << (fixpoint_detail::position_bits - this->shift)) : (r >> (this->shift - fixpoint_detail::position_bits));
+		return fixpoint_detail::spline_horner<Fix>(this->coefficient[i], u);
+	}
+
+	// evaluates every element in [first, last) and writes the results to out.
+	Fix* eval(const Fix* first, const Fix* last, Fix* out) const {
+		for(; first != last; ++first, ++out){
+			*out = this->eval(*first);
+		}
+		return out;
+	}
+
+	Fix x_first() const {return this->x0;}
+	Fix x_last() const {return traits::make(traits::raw(this->x0) + (static_cast<int64_t>(Size - 1) << this->shift));}
+	Fix step() const {return traits::make(static_cast<int64_t>(1) << this->shift);}
+	static constexpr size_t size(){return Size;}
+};
+
+// ================ 2D Tables ================
+
+// ---------------- table_axis ----------------
+
+/*
+	Breakpoints of one axis of a table2d, either uniformly spaced with an arbitrary step or
+	arbitrary and strictly increasing.
+
+	locate() returns the segment of a value and the position within it. On a uniform axis the segment
+	is found with a multiplication by the reciprocal of the step, on a nonuniform axis with a binary search.
+	Either way the position is calculated with a multiplication by the precalculated reciprocal of the
+	segment width, so there are no divisions.
+
+	Example:
+		const auto temperature = table_axis<fix32<16>>::uniform(-40, 10, 14);	// -40, -30, ..., 90
+		const fix32<16> p[5] = {fix32<16>(0.5f), 1, 2, 4, 8};
+		const table_axis<fix32<16>> pressure(p, p+5);
+
+	Preconditions: at least 2 breakpoints, fewer than 2^30, and segments smaller than 2^62 raw steps.
+*/
+template<class Fix>
+class table_axis{
+	using traits = fixpoint_detail::fix_traits<Fix>;
+
+private:
+	std::vector<Fix> x;
+	bool is_uniform;
+	int64_t inv_step;                   // uniform axes: 2^(32 + inv_step_shift) / step
+	int inv_step_shift;
+	std::vector<int64_t> inv_width;     // 2^(position_bits + inv_shift) / (x_i+1 - x_i)
+	std::vector<int> inv_shift;
+	std::vector<int64_t> left_weight;   // (x_i+1 - x_i) / (x_i+1 - x_i-1) with 30 fractional bits
+	std::vector<int64_t> right_weight;  // (x_i+1 - x_i) / (x_i+2 - x_i) with 30 fractional bits
+
+	table_axis(std::vector<Fix> breakpoints, bool uniform)
+		: x(std::move(breakpoints))
+		, is_uniform(uniform)
+		, inv_step(0)
+		, inv_step_shift(0)
+		, inv_width(x.size() - 1)
+		, inv_shift(x.size() - 1)
+		, left_weight(x.size() - 1)
+		, right_weight(x.size() - 1)
+	{
+		const size_t n = this->x.size();
+		fixpoint_assert(n >= 2, "Error: a table_axis needs at least 2 breakpoints, but got " << n);
+		for(size_t i = 0; i < n - 1; ++i){
+			fixpoint_assert(this->x[i] < this->x[i+1], "Error: the breakpoints of table_axis have to be strictly increasing. x[" << i << "] >= x[" << i+1 << "]");
+			const uint64_t width = static_cast<uint64_t>(traits::raw(this->x[i+1]) - traits::raw(this->x[i]));
+			fixpoint_assert(width < (static_cast<uint64_t>(1) << 62), "Error: the segment x[" << i << "] to x[" << i+1 << "] of table_axis is too wide");
+			this->inv_shift[i] = fixpoint_detail::bit_scan_reverse(width) + 1;
+			this->inv_width[i] = static_cast<int64_t>(std::ldexp(1.0L, fixpoint_detail::position_bits + this->inv_shift[i]) / static_cast<long double>(width));
+
+			const long double left_span = static_cast<long double>(traits::raw(this->x[i+1]) - traits::raw(this->x[(i > 0) ? i - 1 : 0]));
+			const long double right_span = static_cast<long double>(traits::raw(this->x[(i + 2 < n) ? i + 2 : n - 1]) - traits::raw(this->x[i]));
+			this->left_weight[i] = std::llround(std::ldexp(static_cast<long double>(width) / left_span, 30));
+			this->right_weight[i] = std::llround(std::ldexp(static_cast<long double>(width) / right_span, 30));
+		}
+		if(this->is_uniform){
+			const uint64_t step = static_cast<uint64_t>(traits::raw(this->x[1]) - traits::raw(this->x[0]));
+			this->inv_step_shift = fixpoint_detail::bit_scan_reverse(step) + 1;
+			this->inv_step = static_cast<int64_t>(std::ldexp(1.0L, 32 + this->inv_step_shift) / static_cast<long double>(step));
+		}
+	}
+
+public:
+	// nonuniform axis with the breakpoints [first, last)
+	table_axis(const Fix* first, const Fix* last) : table_axis(std::vector<Fix>(first, last), false){}
+
+	// uniform axis with n breakpoints: first, first + step, ..., first + (n-1) * step
+	static table_axis uniform(Fix first, Fix step, size_t n){
+		std::vector<Fix> breakpoints(n);
+		for(size_t i = 0; i < n; ++i){
+			breakpoints[i] = traits::make(traits::raw(first) + static_cast<int64_t>(i) * traits::raw(step));
+		}
+		return table_axis(std::move(breakpoints), true);
+	}
+
+	// returns the segment i in [0, size-2] of the value clamped to [x_first, x_last] and
+	// the position u in [0, 1] within the segment with position_bits fractional bits
+	size_t locate(Fix value, int64_t& u) const {
+		const size_t n = this->x.size();
+		const Fix v = (value < this->x[0]) ? this->x[0] : (this->x[n-1] < value) ? this->x[n-1] : value;
+		const int64_t d = traits::raw(v) - traits::raw(this->x[0]);
+		size_t i;
+		int64_t r;
+		if(this->is_uniform){
+			// estimate the index with the reciprocal of the step and correct the rounding with the exact remainder
+			const int64_t step = traits::raw(this->x[1]) - traits::raw(this->x[0]);
+			int64_t index = fixpoint_detail::mul_shift_round(d, this->inv_step, this->inv_step_shift) >> 32;
+			r = d - index * step;
+			if(r < 0){
+				--index;
+				r += step;
+			}else if(r >= step){
+				++index;
+				r -= step;
+			}
+			if(index > static_cast<int64_t>(n - 2)){
+				index = static_cast<int64_t>(n - 2);
+				r = d - index * step;
+			}
+			i = static_cast<size_t>(index);
+		}else{
+			i = fixpoint_detail::find_segment(this->x.data(), n, v);
+			r = traits::raw(v) - traits::raw(this->x[i]);
+		}
+		u = fixpoint_detail::mul_shift_round(r, this->inv_width[i], this->inv_shift[i]);
+		return i;
+	}
+
+	int64_t left_derivative_weight(size_t i) const {return this->left_weight[i];}
+	int64_t right_derivative_weight(size_t i) const {return this->right_weight[i];}
+
+	bool uniform() const {return this->is_uniform;}
+	Fix operator[](size_t i) const {return this->x[i];}
+	size_t size() const {return this->x.size();}
+};
+
+// ---------------- table2d ----------------
+
+namespace fixpoint_detail{
+	// cubic Hermite interpolation between p0 and p1 at u with position_bits fractional bits.
+	// the derivatives are the differences of the neighbours p_1 and p2, scaled by the axis weights with 30 fractional bits.
+	inline int64_t hermite(int64_t p_1, int64_t p0, int64_t p1, int64_t p2, int64_t left_weight, int64_t right_weight, int64_t u){
+		const int64_t m0 = mul_shift_round(p1 - p_1, left_weight, 30);
+		const int64_t m1 = mul_shift_round(p2 - p0, right_weight, 30);
+		int64_t acc = 2 * (p0 - p1) + m0 + m1;
+		acc = 3 * (p1 - p0) - 2 * m0 - m1 + mul_shift_round(acc, u, position_bits);
+		acc = m0 + mul_shift_round(acc, u, position_bits);
+		return p0 + mul_shift_round(acc, u, position_bits);
+	}
+}
+
+/*
+	2D lookup table, for example a calibration map z(x, y) over temperature and pressure,
+	with bilinear or bicubic (Catmull-Rom) interpolation. Each axis can be uniform or nonuniform,
+	see table_axis. Outside of the axes the coordinates are clamped.
+
+	The values are stored in tiles of 4 x 4, so that the 2 x 2 and 4 x 4 neighbourhoods that an
+	interpolation reads are mostly within one or two cache lines, instead of spread over 2 or 4 rows.
+	A query locates each axis once and then needs 3 (bilinear) or 15 (bicubic) multiplications,
+	calculated in 64 bits with the guard bits of the spline tables.
+
+	Example:
+		const table2d<fix32<16>> map(temperature, pressure, values); // values[ix * pressure.size() + iy]
+		fix32<16> z = map(t, p);
+		map.bilinear(t_first, t_last, p_first, z_out);
+*/
+template<class Fix>
+class table2d{
+	using traits = fixpoint_detail::fix_traits<Fix>;
+
+private:
+	static constexpr size_t tile = 4;
+
+	table_axis<Fix> x_axis;
+	table_axis<Fix> y_axis;
+	size_t y_tiles;
+	std::vector<int64_t> tiles; // values with traits::guard_bits additional fractional bits
+
+	size_t index(size_t ix, size_t iy) const {
+		return ((ix / tile) * this->y_tiles + iy / tile) * (tile * tile) + (ix % tile) * tile + iy % tile;
+	}
+
+	int64_t at(size_t ix, size_t iy) const {return this->tiles[this->index(ix, iy)];}
+
+public:
+	// values are given in row major order: z(x_i, y_j) = values[i * y.size() + j]
+	table2d(const table_axis<Fix>& x, const table_axis<Fix>& y, const Fix* values)
+		: x_axis(x)
+		, y_axis(y)
+		, y_tiles((y.size() + tile - 1) / tile)
+		, tiles(((x.size() + tile - 1) / tile) * y_tiles * tile * tile, 0)
+	{
+		for(size_t i = 0; i < x.size(); ++i){
+			for(size_t j = 0; j < y.size(); ++j){
+				this->tiles[this->index(i, j)] = traits::raw(values[i * y.size() + j]) * (static_cast<int64_t>(1) << traits::guard_bits);
+			}
+		}
+	}
+
+	Fix operator()(Fix x, Fix y) const {return this->bilinear(x, y);}
+
+	Fix bilinear(Fix x, Fix y) const {
+		int64_t u, v;
+		const size_t i = this->x_axis.locate(x, u);
+		const size_t j = this->y_axis.locate(y, v);
+		const int64_t z00 = this->at(i, j);
+		const int64_t z01 = this->at(i, j+1);
+		const int64_t z10 = this->at(i+1, j);
+		const int64_t z11 = this->at(i+1, j+1);
+		const int64_t z0 = z00 + fixpoint_detail::mul_shift_round(z01 - z00, v, fixpoint_detail::position_bits);
+		const int64_t z1 = z10 + fixpoint_detail::mul_shift_round(z11 - z10, v, fixpoint_detail::position_bits);
+		return traits::make(traits::drop_guard(z0 + fixpoint_detail::mul_shift_round(z1 - z0, u, fixpoint_detail::position_bits)));
+	}
+
+	Fix bicubic(Fix x, Fix y) const {
+		int64_t u, v;
+		const size_t i = this->x_axis.locate(x, u);
+		const size_t j = this->y_axis.locate(y, v);
+		const size_t nx = this->x_axis.size();
+		const size_t ny = this->y_axis.size();
+		const size_t is[4] = {(i > 0) ? i - 1 : 0, i, i + 1, (i + 2 < nx) ? i + 2 : nx - 1};
+		const size_t js[4] = {(j > 0) ? j - 1 : 0, j, j + 1, (j + 2 < ny) ? j + 2 : ny - 1};
+		const int64_t wy0 = this->y_axis.left_derivative_weight(j);
+		const int64_t wy1 = this->y_axis.right_derivative_weight(j);
+
+		int64_t column[4];
+		for(int k = 0; k < 4; ++k){
+			column[k] = fixpoint_detail::hermite(
+				this->at(is[k], js[0]), this->at(is[k], js[1]), this->at(is[k], js[2]), this->at(is[k], js[3]), wy0, wy1, v);
+		}
+		const int64_t z = fixpoint_detail::hermite(column[0], column[1], column[2], column[3],
+			this->x_axis.left_derivative_weight(i), this->x_axis.right_derivative_weight(i), u);
+		return traits::make(traits::drop_guard(z));
+	}
+
+	// evaluates the points (x, y) with x in [x_first, x_last) and y starting at y_first, and writes the results to out.
+	Fix* bilinear(const Fix* x_first, const Fix* x_last, const Fix* y_first, Fix* out) const {
+		for(; x_first != x_last; ++x_first, ++y_first, ++out){
+			*out = this->bilinear(*x_first, *y_first);
+		}
+		return out;
+	}
+
+	Fix* bicubic(const Fix* x_first, const Fix* x_last, const Fix* y_first, Fix* out) const {
+		for(; x_first != x_last; ++x_first, ++y_first, ++out){
+			*out = this->bicubic(*x_first, *y_first);
+		}
+		return out;
+	}
+
+	Fix value(size_t ix, size_t iy) const {return traits::make(traits::drop_guard(this->at(ix, iy)));}
+	const table_axis<Fix>& x() const {return this->x_axis;}
+	const table_axis<Fix>& y() const {return this->y_axis;}
+};
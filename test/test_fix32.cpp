@@ -27,6 +27,9 @@
 
 #include <iostream>
 #include <sstream>
+#include <string>
+#include <cstring>
+#include <algorithm>
 #include "fix32.hpp"
 
 #define TEST_CASE(function)										\
@@ -293,6 +296,222 @@ bool construct_from_hex_stringstream() {
 	return test1 && test2;
 }
 
+bool to_chars_shortest(){
+	char buffer[64];
+	auto str = [&](fix32<16> f){
+		const fix_to_chars_result r = to_chars(buffer, buffer + sizeof(buffer), f);
+		return std::string(buffer, r.ptr);
+	};
+	bool result = true;
+	result &= str(fix32<16>(1)) == "1";
+	result &= str(fix32<16>(0)) == "0";
+	result &= str(fix32<16>::reinterpret(0x8000)) == "0.5";
+	result &= str(fix32<16>(-2) - fix32<16>::reinterpret(0x4000)) == "-2.25";
+	result &= str(fix32<16>::reinterpret(1)) == "0.00002";
+	result &= str(fix32<16>::reinterpret(-0x7FFFFFFF - 1)) == "-32768";
+
+	// reads back as the same number, and one digit less would not
+	for(int32_t raw = -2000000; raw < 2000000; raw += 97){
+		const fix32<16> f = fix32<16>::reinterpret(raw);
+		const fix_to_chars_result r = to_chars(buffer, buffer + sizeof(buffer), f);
+		fix32<16> g;
+		result &= from_chars(buffer, r.ptr, g).ec == std::errc() && g == f;
+
+		const char* dot = std::find(buffer, r.ptr, '.');
+		if(dot != r.ptr){
+			const int digits = static_cast<int>(r.ptr - dot) - 1;
+			const fix_to_chars_result shorter = to_chars(buffer, buffer + sizeof(buffer), f, digits - 1);
+			result &= from_chars(buffer, shorter.ptr, g).ec == std::errc() && g != f;
+		}
+	}
+	return result;
+}
+
+bool to_chars_precision(){
+	char buffer[64];
+	auto str = [&](fix32<16> f, int precision){
+		const fix_to_chars_result r = to_chars(buffer, buffer + sizeof(buffer), f, precision);
+		return std::string(buffer, r.ptr);
+	};
+	bool result = true;
+	result &= str(fix32<16>(2.5f), 0) == "2";
+	result &= str(fix32<16>(3.5f), 0) == "4";
+	result &= str(fix32<16>(0.125f), 2) == "0.12";
+	result &= str(fix32<16>(0.375f), 2) == "0.38";
+	result &= str(fix32<16>(-1.99999f), 2) == "-2.00";
+	result &= str(fix32<16>(0.5f), 10) == "0.5000000000";
+	result &= str(fix32<16>::reinterpret(1), 16) == "0.0000152587890625";
+	result &= str(fix32<16>::reinterpret(1), 20) == "0.00001525878906250000";
+	result &= str(fix32<16>(9.999f), 1) == "10.0";
+
+	// too small buffers leave the output untouched
+	char small[4] = {'x', 'x', 'x', 'x'};
+	const fix_to_chars_result r = to_chars(small, small + 4, fix32<16>(12.25f));
+	result &= r.ec == std::errc::value_too_large && r.ptr == small + 4 && small[0] == 'x';
+	result &= to_chars(small, small + 4, fix32<16>(12.25f), 1).ec == std::errc() && std::string(small, 4) == "12.2";
+	return result;
+}
+
+bool from_chars_rounding(){
+	auto parse = [](const char* str, fix32<16>& f){return from_chars(str, str + std::strlen(str), f);};
+	bool result = true;
+	fix32<16> f;
+	result &= parse("3.1415", f).ec == std::errc() && f == fix32<16>::reinterpret(205881); // 205881.344
+	result &= parse("-3.1415", f).ec == std::errc() && f == fix32<16>::reinterpret(-205881);
+	result &= parse("17", f).ec == std::errc() && f == 17;
+	result &= parse(".5", f).ec == std::errc() && f == fix32<16>(0.5f);
+	result &= parse("-0", f).ec == std::errc() && f == 0;
+	result &= parse("-32768", f).ec == std::errc() && f == fix32<16>::reinterpret(-0x7FFFFFFF - 1);
+
+	// ties to even
+	fix32<1> h;
+	result &= from_chars("0.25", "0.25" + 4, h).ec == std::errc() && h == 0;
+	result &= from_chars("0.75", "0.75" + 4, h).ec == std::errc() && h == 1;
+	result &= from_chars("0.2500000000000000000000001", "0.2500000000000000000000001" + 27, h).ec == std::errc() && h == fix32<1>::reinterpret(1);
+	result &= from_chars("1.25", "1.25" + 4, h).ec == std::errc() && h == 1;
+
+	// exactly halfway between two raw values of fix32<16>: 1 + 2^-17
+	result &= parse("1.00000762939453125", f).ec == std::errc() && f == 1;
+	result &= parse("1.000007629394531250001", f).ec == std::errc() && f == fix32<16>::reinterpret(65537);
+
+	// errors and end pointers
+	const char* text = "1.5x";
+	fix_from_chars_result r = from_chars(text, text + 4, f);
+	result &= r.ec == std::errc() && r.ptr == text + 3 && f == fix32<16>(1.5f);
+	result &= parse("-", f).ec == std::errc::invalid_argument && f == fix32<16>(1.5f);
+	result &= parse("abc", f).ec == std::errc::invalid_argument;
+	result &= parse(".", f).ec == std::errc::invalid_argument;
+	result &= parse("32768", f).ec == std::errc::result_out_of_range;
+	result &= parse("32767.999995", f).ec == std::errc::result_out_of_range;
+	result &= parse("123456789012345678901234567890", f).ec == std::errc::result_out_of_range;
+	result &= f == fix32<16>(1.5f);
+	return result;
+}
+
+// streambuf that hands out 'chunk' characters per refill, or none with chunk = 0
+struct chunked_streambuf : std::streambuf{
+	std::string text;
+	size_t position = 0;
+	size_t chunk;
+
+	chunked_streambuf(const std::string& text, size_t chunk) : text(text), chunk(chunk){}
+
+	int_type underflow() override {
+		if(position == text.size()) return traits_type::eof();
+		if(chunk == 0) return traits_type::to_int_type(text[position]);
+		const size_t count = std::min(chunk, text.size() - position);
+		setg(&text[position], &text[position], &text[position] + count);
+		position += count;
+		return traits_type::to_int_type(*gptr());
+	}
+
+	int_type uflow() override {
+		if(chunk != 0) return std::streambuf::uflow();
+		if(position == text.size()) return traits_type::eof();
+		return traits_type::to_int_type(text[position++]);
+	}
+};
+
+bool stream_partial_consumption(){
+	const std::string text = "12.25,-0x1F.8;0b101.1x-0";
+	const auto read_all = [](std::istream& stream, int32_t* values, int& states){
+		for(int i = 0; i < 4; ++i){
+			fix32<16> f;
+			stream >> f;
+			values[i] = reinterpret_as_int32(f);
+			states = states * 8 + stream.rdstate();
+			stream.get();
+		}
+	};
+	const int32_t expected[4] = {0xC3FFF, -0x1F8000, 0x58000, 0}; // 12.25 is read as 12.25 - 2^-16
+
+	bool result = true;
+	for(size_t chunk : {0, 1, 2, 3, 64}){
+		chunked_streambuf buffer(text, chunk);
+		std::istream stream(&buffer);
+		int32_t values[4];
+		int states = 0;
+		read_all(stream, values, states);
+		result &= std::equal(values, values + 4, expected);
+		// the last number ends at the end of the stream, which sets eofbit and failbit like peek() does
+		result &= states == (std::ios::eofbit | std::ios::failbit);
+	}
+
+	// the stream stays at the first character that does not belong to the number
+	std::istringstream stream("3.5 rest");
+	fix32<16> f;
+	stream >> f;
+	std::string rest;
+	std::getline(stream, rest);
+	result &= f == fix32<16>(3.5f) && rest == " rest";
+	return result;
+}
+
+bool checked_errors(){
+	bool result = true;
+	// the message is formatted by the error handler
+	try{
+		const fix32<16> a = 40000;
+		(void)a;
+		result = false;
+	}catch(const std::runtime_error& e){
+		result &= std::string(e.what()).find("num=40000") != std::string::npos;
+	}
+	try{
+		const fix32<16> a = -40000;
+		(void)a;
+		result = false;
+	}catch(const std::runtime_error& e){
+		result &= std::string(e.what()).find("num=-40000") != std::string::npos;
+	}
+	try{
+		const fix32<16> a = fix32<16>(1) / fix32<16>(0);
+		(void)a;
+		result = false;
+	}catch(const std::runtime_error& e){
+		result &= std::string(e.what()) == "Error: fixpoint division by zero";
+	}
+	fix32<16> b = -32768;
+	fix32<16> c = 32767.5f;
+	result &= b == fix32<16>::reinterpret(INT32_MIN);
+	result &= c == fix32<16>::reinterpret(0x7FFF8000);
+	return result;
+}
+
+bool unchecked_operations(){
+	bool result = true;
+	result &= fixpoint_unchecked::convert<fix32<16>>(5) == fix32<16>(5);
+	result &= fixpoint_unchecked::convert<fix32<16>>(-2.5f) == fix32<16>(-2.5f);
+	result &= fixpoint_unchecked::convert<fix32<16>>(0.75) == fix32<16>(0.75);
+	result &= fixpoint_unchecked::divide(fix32<20>(5), fix32<20>(11)) == fix32<20>(5) / fix32<20>(11);
+	result &= fixpoint_unchecked::divide(fix32<20>(5), 2) == fix32<20>(2.5);
+	// wraps around instead of raising an error
+	result &= fixpoint_unchecked::convert<fix32<16>>(32769) == fix32<16>::reinterpret(INT32_MIN + (1 << 16));
+	return result;
+}
+
+bool try_operations(){
+	bool result = true;
+	fix32<16> a = 7;
+	result &= try_convert(12, a) == std::errc() && a == 12;
+	result &= try_convert(-32768, a) == std::errc() && a == -32768;
+	result &= try_convert(32767.75, a) == std::errc() && a == fix32<16>(32767.75);
+	result &= try_convert(32768, a) == std::errc::result_out_of_range && a == fix32<16>(32767.75);
+	result &= try_convert(-32769, a) == std::errc::result_out_of_range;
+	result &= try_convert(32768.f, a) == std::errc::result_out_of_range;
+	result &= try_convert(-32768.5, a) == std::errc::result_out_of_range;
+	result &= try_convert(4000000000u, a) == std::errc::result_out_of_range;
+	result &= try_convert(0.0 / 0.0, a) == std::errc::result_out_of_range;
+
+	fix32<20> q;
+	result &= try_divide(fix32<20>(5), fix32<20>(11), q) == std::errc() && q == fix32<20>(5) / fix32<20>(11);
+	result &= try_divide(fix32<20>(5), fix32<20>(0), q) == std::errc::argument_out_of_domain;
+	result &= try_divide(fix32<20>(1000), fix32<20>(0.25), q) == std::errc::result_out_of_range;
+	result &= try_divide(fix32<20>(-1024), fix32<20>(1), q) == std::errc() && q == -1024;
+	result &= try_divide(fix32<20>(-2048), fix32<20>(-1), q) == std::errc::result_out_of_range;
+	return result;
+}
+
 int main(){
 	std::cout << "fix32 Tests:" << std::endl;
 	std::cout << "---------------" << std::endl;
@@ -324,6 +543,15 @@ int main(){
 	TEST_CASE(construct_from_signed_stringstream);
 	TEST_CASE(construct_from_binary_stringstream);
 	TEST_CASE(construct_from_hex_stringstream);
+	TEST_CASE(stream_partial_consumption);
+
+	TEST_CASE(to_chars_shortest);
+	TEST_CASE(to_chars_precision);
+	TEST_CASE(from_chars_rounding);
+
+	TEST_CASE(checked_errors);
+	TEST_CASE(unchecked_operations);
+	TEST_CASE(try_operations);
 	
 	return 0;
 }
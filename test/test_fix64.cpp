@@ -7,6 +7,8 @@
 
 #include <iostream>
 #include <sstream>
+#include <string>
+#include <cstring>
 #include "fix64.hpp"
 
 #define TEST_CASE(function)										\
@@ -217,6 +219,138 @@ bool construct_from_hex_stringstream() {
 	return test1 && test2;
 }
 
+bool to_chars_from_chars(){
+	char buffer[128];
+	auto str = [&](fix64<62> f, int precision){
+		const fix_to_chars_result r = to_chars(buffer, buffer + sizeof(buffer), f, precision);
+		return std::string(buffer, r.ptr);
+	};
+	bool result = true;
+	result &= str(fix64<62>::reinterpret(1), 62) == "0.00000000000000000021684043449710088680149056017398834228515625";
+	result &= str(fix64<62>::reinterpret(1), -1) == "0.0000000000000000002";
+	result &= str(fix64<62>::reinterpret(-0x7FFFFFFFFFFFFFFF - 1), -1) == "-2";
+
+	fix64<40> g = fix64<40>::reinterpret(12345678901234567LL);
+	fix_to_chars_result r = to_chars(buffer, buffer + sizeof(buffer), g, 40);
+	result &= std::string(buffer, r.ptr) == "11228.3295504626648835255764424800872802734375";
+
+	// round trip of the shortest representation for a spread of raw values
+	uint64_t state = 0x123456789ABCDEFULL;
+	for(int i = 0; i < 20000; ++i){
+		state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+		const fix64<62> f = fix64<62>::reinterpret(static_cast<int64_t>(state));
+		r = to_chars(buffer, buffer + sizeof(buffer), f);
+		fix64<62> f2;
+		result &= from_chars(buffer, r.ptr, f2).ec == std::errc() && f2 == f;
+
+		const fix64<20> h = fix64<20>::reinterpret(static_cast<int64_t>(state));
+		r = to_chars(buffer, buffer + sizeof(buffer), h);
+		fix64<20> h2;
+		result &= from_chars(buffer, r.ptr, h2).ec == std::errc() && h2 == h;
+	}
+
+	// ties to even between raw 0 and 1 of fix64<63>, which is 2^-64
+	fix64<63> t;
+	const char* tie = "0.0000000000000000000542101086242752217003726400434970855712890625";
+	result &= from_chars(tie, tie + std::strlen(tie), t).ec == std::errc() && t == fix64<63>::reinterpret(0);
+	const char* above = "0.00000000000000000005421010862427522170037264004349708557128906250001";
+	result &= from_chars(above, above + std::strlen(above), t).ec == std::errc() && t == fix64<63>::reinterpret(1);
+	const char* one = "1";
+	result &= from_chars(one, one + 1, t).ec == std::errc::result_out_of_range;
+	const char* minus_one = "-1";
+	result &= from_chars(minus_one, minus_one + 2, t).ec == std::errc() && t == fix64<63>::reinterpret(-0x7FFFFFFFFFFFFFFF - 1);
+	return result;
+}
+
+bool stream_partial_consumption(){
+	std::istringstream stream("-1.5;0x10.8 7");
+	fix64<32> a;
+	fix64<32> b;
+	fix64<32> c;
+	char delimiter;
+	stream >> a >> delimiter >> b;
+	bool result = a == fix64<32>::reinterpret(-(3LL << 31)) && delimiter == ';' && b == fix64<32>::reinterpret(0x108LL << 28);
+	result &= stream.rdstate() == std::ios::goodbit && stream.peek() == ' ';
+
+	// reading up to the end of the stream sets eofbit and failbit like peek() does
+	stream.get();
+	stream >> c;
+	result &= c == 7 && stream.rdstate() == (std::ios::eofbit | std::ios::failbit);
+	return result;
+}
+
+bool signed_division_small(){
+	bool result = true;
+	result &= fix64<16>(-1) / fix64<16>(2) == fix64<16>(-0.5);
+	result &= fix64<16>(3) / fix64<16>(-2) == fix64<16>(-1.5);
+	result &= fix64<16>(-3) / fix64<16>(-2) == fix64<16>(1.5);
+	return result;
+}
+
+bool signed_multiplication_small(){
+	bool result = true;
+	result &= fix64<16>(-1.5) * fix64<16>(2) == fix64<16>(-3);
+	result &= fix64<16>(-1.5) * fix64<16>(-2) == fix64<16>(3);
+	result &= fix64<32>(0.75) * fix64<32>(-0.5) == fix64<32>(-0.375);
+	result &= fix64<0>(-7) * fix64<0>(6) == fix64<0>(-42);
+	// rounded down, like the product of fix32
+	result &= (fix64<62>::reinterpret(33) * fix64<62>::reinterpret(-538)).reinterpret_as_int64() == -1;
+	result &= (fix64<62>::reinterpret(-33) * fix64<62>::reinterpret(-538)).reinterpret_as_int64() == 0;
+	result &= (fix64<1>::reinterpret(-3) * fix64<1>::reinterpret(1)).reinterpret_as_int64() == -2;
+	return result;
+}
+
+bool checked_errors(){
+	bool result = true;
+	try{
+		const fix64<32> a = 2147483648LL;
+		(void)a;
+		result = false;
+	}catch(const std::runtime_error& e){
+		result &= std::string(e.what()).find("number=2147483648") != std::string::npos;
+	}
+	try{
+		const fix64<32> a = -2147483649LL;
+		(void)a;
+		result = false;
+	}catch(const std::runtime_error& e){
+		result &= std::string(e.what()).find("number=-2147483649") != std::string::npos;
+	}
+	try{
+		const fix64<32> a = 5e9;
+		(void)a;
+		result = false;
+	}catch(const std::runtime_error& e){
+		result &= std::string(e.what()).find("(double num)") != std::string::npos;
+	}
+	const fix64<32> b = -2147483648LL;
+	const fix64<32> c = 2147483520.f;
+	result &= b == fix64<32>::reinterpret(INT64_MIN);
+	result &= c == fix64<32>(2147483520LL);
+	return result;
+}
+
+bool try_operations(){
+	bool result = true;
+	fix64<32> a = 7;
+	result &= try_convert(12, a) == std::errc() && a == 12;
+	result &= try_convert(INT32_MIN, a) == std::errc() && a == fix64<32>::reinterpret(INT64_MIN);
+	result &= try_convert(2147483648LL, a) == std::errc::result_out_of_range && a == fix64<32>::reinterpret(INT64_MIN);
+	result &= try_convert(-2.5, a) == std::errc() && a == fix64<32>(-2.5);
+	result &= try_convert(2147483648.0, a) == std::errc::result_out_of_range;
+	result &= try_convert(18446744073709551615ULL, a) == std::errc::result_out_of_range;
+
+	fix64<32> q;
+	result &= try_divide(fix64<32>(5), fix64<32>(0), q) == std::errc::argument_out_of_domain;
+	result &= try_divide(fix64<32>(-1), fix64<32>(4), q) == std::errc() && q == fix64<32>(-0.25);
+	result &= try_divide(fix64<32>(1000000), fix64<32>(3), q) == std::errc() && q == fix64<32>(1000000) / fix64<32>(3);
+	result &= try_divide(fix64<32>(1073741824), fix64<32>(0.5), q) == std::errc::result_out_of_range;
+	result &= try_divide(fix64<32>(-1073741824), fix64<32>(0.5), q) == std::errc() && q == fix64<32>::reinterpret(INT64_MIN);
+	result &= try_divide(fix64<32>(-1073741824), fix64<32>::reinterpret(0x7FFFFFFF), q) == std::errc::result_out_of_range;
+	result &= try_divide(fix64<32>(1073741824), fix64<32>(-1), q) == std::errc() && q == -1073741824;
+	return result;
+}
+
 int main(){
 	
 	std::cout << "fix64 tests:" << std::endl;
@@ -241,6 +375,14 @@ int main(){
 	TEST_CASE(construct_from_signed_stringstream);
 	TEST_CASE(construct_from_binary_stringstream);
 	TEST_CASE(construct_from_hex_stringstream);
+	TEST_CASE(stream_partial_consumption);
+
+	TEST_CASE(to_chars_from_chars);
+
+	TEST_CASE(signed_division_small);
+	TEST_CASE(signed_multiplication_small);
+	TEST_CASE(checked_errors);
+	TEST_CASE(try_operations);
 	
 	return 0;
 }
\ No newline at end of file
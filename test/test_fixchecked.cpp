@@ -0,0 +1,169 @@
+/*
+	Author: Tobias Wallner
+	tobias.wallner1@gmx.net
+
+*/
+
+
+#include <iostream>
+#include <random>
+#include <vector>
+#include "fixchecked.hpp"
+
+#define TEST_CASE(function)										\
+	if(function()){ 											\
+		std::cout << "[  Ok  ] - " << #function << std::endl;	\
+	}else{ 														\
+		std::cout << "[Failed] - " << #function << std::endl;	\
+	}
+
+// the checks are constant expressions
+constexpr bool constant_checks(){
+	fix32<16> a = fix32<16>::reinterpret(0);
+	fix64<32> b = fix64<32>::reinterpret(0);
+	return checked_add(fix32<16>::reinterpret(0x40000000), fix32<16>::reinterpret(0x3FFFFFFF), a)
+		&& !checked_mul(fix32<16>::reinterpret(0x01000000), fix32<16>::reinterpret(0x01000000), a)
+		&& checked_mul(fix64<32>::reinterpret(3LL << 32), fix64<32>::reinterpret(-(5LL << 31)), b) && b.reinterpret_as_int64() == -(15LL << 31)
+		&& !checked_div(fix32<16>::reinterpret(1), fix32<16>::reinterpret(0), a);
+}
+static_assert(constant_checks(), "checked arithmetic in constant expressions");
+
+// ------------- fix32 -------------
+
+bool test32_checked(){
+	bool result = true;
+	fix32<16> r;
+
+	result &= checked_add(fix32<16>(20000), fix32<16>(12767), r) && r == 32767;
+	result &= !checked_add(fix32<16>(20000), fix32<16>(12768), r) && r == -32768;
+	result &= checked_add(fix32<16>(-20000), fix32<16>(-12768), r) && r == -32768;
+	result &= !checked_add(fix32<16>(-20000), fix32<16>(-12769), r);
+
+	result &= checked_sub(fix32<16>(-20000), fix32<16>(12768), r) && r == -32768;
+	result &= !checked_sub(fix32<16>(-20000), fix32<16>(12769), r) && r == 32767;
+	result &= !checked_sub(fix32<16>(0), fix32<16>::reinterpret(INT32_MIN), r);
+
+	result &= checked_mul(fix32<16>(181), fix32<16>(181), r) && r == 32761;
+	result &= !checked_mul(fix32<16>(182), fix32<16>(181), r) && r == fix32<16>(182) * fix32<16>(181);
+	result &= checked_mul(fix32<16>(-256), fix32<16>(128), r) && r == -32768;
+	result &= !checked_mul(fix32<16>(256), fix32<16>(128), r);
+	result &= checked_mul(fix32<16>(-1.5), fix32<16>::reinterpret(1), r) && r == fix32<16>(-1.5) * fix32<16>::reinterpret(1);
+	fix32<0> n;
+	result &= checked_mul(fix32<0>::reinterpret(46340), fix32<0>::reinterpret(-46341), n) && n.reinterpret_as_int32() == -2147441940;
+	result &= !checked_mul(fix32<0>::reinterpret(46341), fix32<0>::reinterpret(46341), n);
+
+	result &= checked_div(fix32<16>(5), fix32<16>(11), r) && r == fix32<16>(5) / fix32<16>(11);
+	result &= !checked_div(fix32<16>(5), fix32<16>(0), r) && r == 0;
+	result &= !checked_div(fix32<16>(1000), fix32<16>(0.025), r);
+	result &= checked_div(fix32<16>(-16384), fix32<16>(0.5), r) && r == -32768;
+	result &= !checked_div(fix32<16>(16384), fix32<16>(0.5), r);
+	return result;
+}
+
+bool test32_overflowing(){
+	bool result = true;
+	bool overflow = false;
+
+	// the flag is sticky
+	fix32<16> y = overflowing_mul(fix32<16>(100), fix32<16>(3), overflow);
+	y = overflowing_add(y, fix32<16>(0.5), overflow);
+	y = overflowing_sub(y, fix32<16>(1000), overflow);
+	y = overflowing_div(y, fix32<16>(4), overflow);
+	result &= !overflow && y == fix32<16>(-174.875);
+
+	y = overflowing_mul(y, fix32<16>(1000), overflow);
+	result &= overflow;
+	y = overflowing_add(fix32<16>(1), fix32<16>(2), overflow);
+	result &= overflow && y == 3;
+	return result;
+}
+
+// ------------- fix64 -------------
+
+bool test64_checked(){
+	bool result = true;
+	fix64<32> r;
+	const fix64<32> largest = fix64<32>::reinterpret(INT64_MAX);
+	const fix64<32> smallest = fix64<32>::reinterpret(INT64_MIN);
+
+	result &= checked_add(largest, fix64<32>(0), r) && r == largest;
+	result &= !checked_add(largest, fix64<32>::reinterpret(1), r) && r == smallest;
+	result &= !checked_add(smallest, fix64<32>::reinterpret(-1), r) && r == largest;
+	result &= checked_sub(smallest, fix64<32>(-1), r) && r == smallest + fix64<32>(1);
+	result &= !checked_sub(fix64<32>(-1), largest, r);
+
+	result &= checked_mul(fix64<32>(46340), fix64<32>(46340), r) && r == 2147395600LL;
+	result &= checked_mul(fix64<32>(-65536), fix64<32>(32768), r) && r == smallest;
+	result &= !checked_mul(fix64<32>(65536), fix64<32>(32768), r);
+	result &= !checked_mul(fix64<32>(40000), fix64<32>(-100000), r);
+	result &= checked_mul(fix64<32>(1.5), fix64<32>(-2.25), r) && r == fix64<32>(-3.375);
+
+	result &= checked_div(fix64<32>(5), fix64<32>(-11), r) && r == fix64<32>(5) / fix64<32>(-11);
+	result &= !checked_div(fix64<32>(5), fix64<32>(0), r) && r == 0;
+	result &= !checked_div(fix64<32>(1000000000), fix64<32>(0.25), r);
+	result &= checked_div(fix64<32>(-1073741824), fix64<32>(0.5), r) && r == smallest;
+	return result;
+}
+
+// the portable product agrees with the 128-bit product
+bool test64_multiply_shift(){
+	bool result = true;
+	std::mt19937_64 random(5);
+	const int64_t special[] = {0, 1, -1, INT64_MAX, INT64_MIN, INT64_MAX >> 17, INT64_MIN >> 31, 3, -3, 1LL << 32};
+	for(int i = 0; i < 100000; ++i){
+		const int64_t a = (i < 100) ? special[i % 10] : static_cast<int64_t>(random()) >> (random() % 64);
+		const int64_t b = (i < 100) ? special[i / 10] : static_cast<int64_t>(random()) >> (random() % 64);
+		const size_t fractional_bits = random() % 64;
+		bool overflow = false;
+		bool expected_overflow = false;
+		const int64_t portable = fixpoint_detail::multiply_shift_portable(a, b, fractional_bits, overflow);
+		const int64_t expected = fixpoint_detail::multiply_shift(a, b, fractional_bits, expected_overflow);
+		result &= portable == expected && overflow == expected_overflow;
+	}
+	return result;
+}
+
+// ------------- arrays -------------
+
+bool test_checked_arrays(){
+	bool result = true;
+	const size_t count = 150;
+	std::vector<fix32<16>> a(count);
+	std::vector<fix32<16>> b(count);
+	std::vector<fix32<16>> out(count);
+	std::vector<uint64_t> mask((count + 63) / 64);
+	for(size_t i = 0; i < count; ++i){
+		a[i] = fix32<16>(static_cast<int32_t>(i) * 100);
+		b[i] = fix32<16>(-static_cast<int32_t>(i) * 200);
+	}
+
+	result &= checked_add(a.data(), b.data(), out.data(), count, mask.data());
+	result &= mask[0] == 0 && mask[1] == 0 && mask[2] == 0;
+	for(size_t i = 0; i < count; ++i){
+		result &= out[i] == a[i] + b[i];
+	}
+
+	// products below -32768 overflow, from i = 2 on
+	result &= !checked_mul(a.data(), b.data(), out.data(), count, mask.data());
+	result &= mask[0] == ~0ULL << 2 && mask[1] == ~0ULL && mask[2] == (1ULL << (count - 128)) - 1;
+
+	// in place, the differences 300 * i do not fit from i = 110 on
+	result &= !checked_sub(a.data(), b.data(), a.data(), count, mask.data());
+	result &= mask[0] == 0 && mask[1] == ~0ULL << (110 - 64) && mask[2] == (1ULL << (count - 128)) - 1;
+
+	std::vector<fix64<32>> c(3, fix64<32>(7));
+	std::vector<fix64<32>> d = {fix64<32>(2), fix64<32>(0), fix64<32>(0.5)};
+	std::vector<fix64<32>> quotient(3);
+	result &= !checked_div(c.data(), d.data(), quotient.data(), 3, mask.data());
+	result &= mask[0] == 2 && quotient[0] == fix64<32>(3.5) && quotient[2] == 14;
+	return result;
+}
+
+int main(){
+	TEST_CASE(test32_checked);
+	TEST_CASE(test32_overflowing);
+	TEST_CASE(test64_checked);
+	TEST_CASE(test64_multiply_shift);
+	TEST_CASE(test_checked_arrays);
+	return 0;
+}
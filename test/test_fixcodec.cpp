@@ -0,0 +1,150 @@
+/*
+	Author: Tobias Wallner
+	tobias.wallner1@gmx.net
+	
+*/
+
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <cmath>
+#include "fixcodec.hpp"
+
+#define TEST_CASE(function)										\
+	if(function()){ 											\
+		std::cout << "[  Ok  ] - " << #function << std::endl;	\
+	}else{ 														\
+		std::cout << "[Failed] - " << #function << std::endl;	\
+	}
+
+// ------------- delta_encoder / delta_decoder -------------
+
+bool test32_delta_codec(){
+	// a slowly varying signal with a ramp, noise and the extreme values
+	std::vector<fix32<16>> values;
+	for(int i = 0; i < 5000; ++i){
+		values.push_back(fix32<16>::reinterpret(static_cast<int32_t>(1000 * i + 300 * std::sin(i * 0.01) + (i % 7))));
+	}
+	values.push_back(fix32<16>::reinterpret(0x7FFFFFFF));
+	values.push_back(fix32<16>::reinterpret(-0x7FFFFFFF - 1));
+	values.push_back(fix32<16>::reinterpret(0));
+
+	delta_encoder<fix32<16>> encoder(256);
+	encoder.push(values.data(), 100);
+	for(size_t i = 100; i < values.size(); ++i){
+		encoder.push(values[i]);
+	}
+	encoder.flush();
+
+	delta_decoder<fix32<16>> decoder;
+	const std::vector<unsigned char>& data = encoder.data();
+	bool result = decoder.open(data.data(), data.data() + data.size()) == std::errc();
+	result &= decoder.size() == values.size() && decoder.blocks() == (values.size() + 255) / 256;
+	// about one byte per value instead of four
+	result &= data.size() < values.size() * 3 / 2;
+
+	std::vector<fix32<16>> decoded(values.size());
+	result &= decoder.decode(decoded.data()) == std::errc() && decoded == values;
+	return result;
+}
+
+bool test32_delta_codec_seek(){
+	std::vector<fix32<8>> values;
+	for(int i = 0; i < 1000; ++i){
+		values.push_back(fix32<8>::reinterpret(i * i - 5000));
+	}
+	delta_encoder<fix32<8>> encoder(64);
+	encoder.push(values.data(), values.size());
+	encoder.flush();
+	const std::vector<unsigned char>& data = encoder.data();
+	delta_decoder<fix32<8>> decoder;
+	bool result = decoder.open(data.data(), data.data() + data.size()) == std::errc();
+
+	// ranges inside one block, across blocks and up to the end
+	const size_t ranges[][2] = {{0, 1}, {10, 20}, {60, 10}, {63, 130}, {640, 360}, {999, 1}, {500, 0}};
+	for(const auto& range : ranges){
+		std::vector<fix32<8>> decoded(range[1]);
+		result &= decoder.decode(range[0], range[1], decoded.data()) == std::errc();
+		result &= std::equal(decoded.begin(), decoded.end(), values.begin() + range[0]);
+	}
+	return result;
+}
+
+bool test32_delta_codec_threads(){
+	std::vector<fix32<16>> values;
+	uint32_t state = 1;
+	for(int i = 0; i < 100000; ++i){
+		state = state * 1664525u + 1013904223u;
+		values.push_back(fix32<16>::reinterpret(static_cast<int32_t>(state >> 12) + i * 64));
+	}
+	delta_encoder<fix32<16>> encoder;
+	encoder.push(values.data(), values.size());
+	encoder.flush();
+	const std::vector<unsigned char>& data = encoder.data();
+	delta_decoder<fix32<16>> decoder;
+	std::vector<fix32<16>> decoded(values.size());
+	bool result = decoder.open(data.data(), data.data() + data.size()) == std::errc();
+	result &= decoder.decode(decoded.data(), 3) == std::errc() && decoded == values;
+	return result;
+}
+
+bool test32_delta_codec_errors(){
+	delta_encoder<fix32<16>> encoder(4);
+	for(int i = 0; i < 10; ++i){
+		encoder.push(fix32<16>(i));
+	}
+	encoder.flush();
+	std::vector<unsigned char> data = encoder.data();
+	delta_decoder<fix32<16>> decoder;
+	bool result = decoder.open(data.data(), data.data() + data.size() - 1) == std::errc::invalid_argument && decoder.size() == 0;
+
+	// a payload with a cut off varint
+	data[1] = 2;
+	data[3] |= 0x80;
+	result &= decoder.open(data.data(), data.data() + data.size()) == std::errc::invalid_argument;
+	const unsigned char block[] = {2, 2, 0x02, 0x80};
+	std::vector<fix32<16>> decoded(2);
+	result &= decoder.open(block, block + 4) == std::errc() && decoder.decode(decoded.data()) == std::errc::invalid_argument;
+
+	// streaming: the encoded blocks can be taken and cleared
+	encoder.clear();
+	encoder.push(fix32<16>(3));
+	encoder.flush();
+	result &= decoder.open(encoder.data().data(), encoder.data().data() + encoder.data().size()) == std::errc();
+	result &= decoder.size() == 1 && decoder.decode(decoded.data()) == std::errc() && decoded[0] == 3;
+	return result;
+}
+
+bool test64_delta_codec(){
+	std::vector<fix64<32>> values;
+	for(int64_t i = 0; i < 3000; ++i){
+		values.push_back(fix64<32>::reinterpret((i << 40) - i * 12345 + (i % 3)));
+	}
+	values.push_back(fix64<32>::reinterpret(INT64_MIN));
+	values.push_back(fix64<32>::reinterpret(INT64_MAX));
+	delta_encoder<fix64<32>> encoder(500);
+	encoder.push(values.data(), values.size());
+	encoder.flush();
+	const std::vector<unsigned char>& data = encoder.data();
+	delta_decoder<fix64<32>> decoder;
+	std::vector<fix64<32>> decoded(values.size());
+	bool result = decoder.open(data.data(), data.data() + data.size()) == std::errc();
+	result &= decoder.decode(decoded.data(), 2) == std::errc() && decoded == values;
+	result &= data.size() < values.size() * 2;
+	return result;
+}
+
+int main(){
+	
+	std::cout << "fixcodec tests:" << std::endl;
+	std::cout << "---------------" << std::endl;
+	
+	TEST_CASE(test32_delta_codec);
+	TEST_CASE(test32_delta_codec_seek);
+	TEST_CASE(test32_delta_codec_threads);
+	TEST_CASE(test32_delta_codec_errors);
+	TEST_CASE(test64_delta_codec);
+	
+	return 0;
+}
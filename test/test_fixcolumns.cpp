@@ -0,0 +1,171 @@
+/*
+	Author: Tobias Wallner
+	tobias.wallner1@gmx.net
+	
+*/
+
+
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <string>
+#include <cstring>
+#include <cstdio>
+#include "fixcolumns.hpp"
+
+#define TEST_CASE(function)										\
+	if(function()){ 											\
+		std::cout << "[  Ok  ] - " << #function << std::endl;	\
+	}else{ 														\
+		std::cout << "[Failed] - " << #function << std::endl;	\
+	}
+
+// ------------- binary columns -------------
+
+bool binary_columns_round_trip(){
+	std::vector<fix32<16>> time = {0, fix32<16>(0.5f), 1, fix32<16>(-1.25f), 3};
+	std::vector<fix64<40>> pressure = {fix64<40>::reinterpret(1), fix64<40>::reinterpret(-(1LL << 60))};
+	std::vector<fix32<8>> empty;
+
+	binary_columns_writer writer;
+	writer.add(time);
+	writer.add(pressure);
+	writer.add(empty);
+	std::vector<char> buffer(writer.size());
+	writer.write(buffer.data());
+
+	binary_columns reader;
+	bool result = reader.open(buffer.data(), buffer.size()) == std::errc();
+	result &= reader.columns() == 3 && !reader.byte_swapped();
+	result &= reader.rows(0) == 5 && reader.width(0) == 4 && reader.fractional_bits(0) == 16;
+	result &= reader.rows(1) == 2 && reader.width(1) == 8 && reader.fractional_bits(1) == 40;
+	result &= reader.rows(2) == 0;
+
+	column_view<fix32<16>> t;
+	column_view<fix64<40>> p;
+	column_view<fix32<8>> e;
+	result &= reader.column(0, t) == std::errc() && reader.column(1, p) == std::errc() && reader.column(2, e) == std::errc();
+	result &= std::vector<fix32<16>>(t.begin(), t.end()) == time;
+	result &= p.size() == 2 && p[0] == pressure[0] && p[1] == pressure[1];
+	result &= e.empty();
+
+	// column data is 64 byte aligned within the buffer
+	result &= (static_cast<const char*>(t.data()) - buffer.data()) % 64 == 0;
+	result &= (static_cast<const char*>(p.data()) - buffer.data()) % 64 == 0;
+
+	// direct access to the values of aligned columns
+	const bool aligned = reinterpret_cast<uintptr_t>(buffer.data()) % 8 == 0;
+	result &= !aligned || (t.values() == t.data() && p.values() == p.data());
+	result &= !aligned || (t.values()[3] == time[3] && p.values()[1] == pressure[1]);
+	const column_view<fix32<16>> shifted(buffer.data() + 2, 1, false);
+	result &= shifted.values() == nullptr;
+
+	// the type of the view has to match the column
+	column_view<fix32<15>> wrong_bits;
+	column_view<fix64<16>> wrong_width;
+	result &= reader.column(0, wrong_bits) == std::errc::invalid_argument;
+	result &= reader.column(0, wrong_width) == std::errc::invalid_argument;
+	result &= reader.column(3, t) == std::errc::result_out_of_range;
+	return result;
+}
+
+bool binary_columns_errors(){
+	std::vector<fix32<16>> values(100, fix32<16>(2));
+	binary_columns_writer writer;
+	writer.add(values);
+	std::vector<char> buffer(writer.size());
+	writer.write(buffer.data());
+
+	binary_columns reader;
+	bool result = true;
+	result &= reader.open(buffer.data(), 10) == std::errc::invalid_argument;
+	result &= reader.open(buffer.data(), buffer.size() - 1) == std::errc::result_out_of_range;
+
+	std::vector<char> copy = buffer;
+	copy[0] = 'X';
+	result &= reader.open(copy.data(), copy.size()) == std::errc::invalid_argument;
+	copy = buffer;
+	copy[12] = 2; // version
+	result &= reader.open(copy.data(), copy.size()) == std::errc::not_supported;
+
+	// the data of a column has to be 64 byte aligned and behind the descriptors
+	copy = buffer;
+	copy[64 + 8] = 96;
+	result &= reader.open(copy.data(), copy.size()) == std::errc::invalid_argument;
+	copy[64 + 8] = 0;
+	result &= reader.open(copy.data(), copy.size()) == std::errc::invalid_argument;
+	copy[64 + 8] = 64;
+	result &= reader.open(copy.data(), copy.size()) == std::errc::invalid_argument;
+	return result;
+}
+
+bool binary_columns_byte_swapped(){
+	// a big endian buffer with one column of two fix32<16> values, written byte by byte
+	std::vector<unsigned char> buffer(128 + 64, 0);
+	std::memcpy(buffer.data(), "FIXCOLS", 8);
+	const unsigned char header[] = {1, 2, 3, 4, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 1};
+	std::memcpy(buffer.data() + 8, header, sizeof(header));
+	buffer[64] = 4;
+	buffer[65] = 16;
+	buffer[64 + 8 + 7] = 128;	// offset
+	buffer[64 + 16 + 7] = 2;	// count
+	const unsigned char values[] = {0x00, 0x01, 0x80, 0x00, 0xFF, 0xFF, 0x80, 0x00};	// 1.5 and -0.5
+	std::memcpy(buffer.data() + 128, values, sizeof(values));
+
+	binary_columns reader;
+	column_view<fix32<16>> view;
+	bool result = reader.open(buffer.data(), buffer.size()) == std::errc();
+	result &= reader.column(0, view) == std::errc();
+	const uint32_t order = 1;
+	unsigned char first_byte;
+	std::memcpy(&first_byte, &order, 1);
+	result &= view.byte_swapped() == (first_byte == 1);
+	result &= view.size() == 2 && view[0] == fix32<16>(1.5f) && view[1] == fix32<16>(-0.5f);
+	result &= (view.values() == nullptr) == view.byte_swapped();
+	return result;
+}
+
+#if defined(FIXPOINT_MMAP)
+bool binary_columns_mapped_file(){
+	std::vector<fix64<32>> values;
+	for(int i = 0; i < 10000; ++i){
+		values.push_back(fix64<32>::reinterpret(static_cast<int64_t>(i) * 123456789));
+	}
+	binary_columns_writer writer;
+	writer.add(values);
+	const char* path = "test_fixcolumns.bin";
+	{
+		std::ofstream file(path, std::ios::binary);
+		writer.write(file);
+	}
+
+	mapped_file file;
+	binary_columns reader;
+	column_view<fix64<32>> view;
+	bool result = file.open(path) == std::errc() && file.size() == writer.size();
+	result &= reader.open(file.data(), file.size()) == std::errc();
+	result &= reader.column(0, view) == std::errc();
+	result &= std::vector<fix64<32>>(view.begin(), view.end()) == values;
+
+	mapped_file missing;
+	result &= missing.open("does/not/exist.bin") == std::errc::no_such_file_or_directory && missing.data() == nullptr;
+	file.close();
+	std::remove(path);
+	return result;
+}
+#endif
+
+int main(){
+	
+	std::cout << "fixcolumns tests:" << std::endl;
+	std::cout << "---------------" << std::endl;
+	
+	TEST_CASE(binary_columns_round_trip);
+	TEST_CASE(binary_columns_errors);
+	TEST_CASE(binary_columns_byte_swapped);
+#if defined(FIXPOINT_MMAP)
+	TEST_CASE(binary_columns_mapped_file);
+#endif
+	
+	return 0;
+}
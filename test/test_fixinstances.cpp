@@ -0,0 +1,66 @@
+/*
+	Author: Tobias Wallner
+	tobias.wallner1@gmx.net
+
+*/
+
+
+#include <iostream>
+#include <cmath>
+#include "fixinstances.hpp"
+
+#define TEST_CASE(function)										\
+	if(function()){ 											\
+		std::cout << "[  Ok  ] - " << #function << std::endl;	\
+	}else{ 														\
+		std::cout << "[Failed] - " << #function << std::endl;	\
+	}
+
+// the extern templates are still constant expressions
+static_assert(exp2(fix32<16>::reinterpret(3 << 16)) == 8, "exp2 in a constant expression");
+static_assert(floor(fix64<32>::reinterpret(-(3LL << 31))) == fix64<32>::reinterpret(-(2LL << 32)), "floor in a constant expression");
+static_assert(fix64<16>::max == (1LL << 47) - 1 && fix64<16>::min == -(1LL << 47), "limits of fix64<16>");
+
+bool test_instances32(){
+	bool result = true;
+
+	// taking the address uses the definition in the library
+	fix32<16> (*const exp2_16)(fix32<16>) = &exp2<16>;
+	fix32<24> (*const log2_24)(fix32<24>) = &fixmath::precise::log2<24>;
+	fix32<8> (*const atan_8)(fix32<8>) = &fixmath::fast::atan<8>;
+	fix32<30> (*const exp_30)(fix32<30>) = &exp<30>;
+
+	result &= exp2_16(fix32<16>(0.5)) == exp2(fix32<16>(0.5)) && std::fabs(static_cast<double>(exp2_16(fix32<16>(0.5))) - std::sqrt(2.0)) < 1e-4;
+	result &= log2_24(fix32<24>(8)) == 3;
+	result &= std::fabs(static_cast<double>(atan_8(fix32<8>(1))) - std::atan(1.0)) < 0.01;
+	result &= std::fabs(static_cast<double>(exp_30(fix32<30>(0.25))) - std::exp(0.25)) < 1e-6;
+
+	const fix32<16> x[4] = {fix32<16>(-2), fix32<16>(0), fix32<16>(1), fix32<16>(7)};
+	fix32<16> y[4];
+	result &= relu6(x, x+4, y) == y+4 && y[0] == 0 && y[2] == 1 && y[3] == 6;
+	result &= tanh(x, x+4, y) == y+4 && y[1] == 0 && y[2] == tanh(x[2]);
+	result &= softmax(x, x+4, y) == y+4 && y[3] > y[2];
+	return result;
+}
+
+bool test_instances64(){
+	bool result = true;
+
+	fix64<32> (*const exp10_32)(fix64<32>) = &fixmath::balanced::exp10<32>;
+	fix64<48> (*const atan2_48)(fix64<48>, fix64<48>) = &atan2<48>;
+	fix64<62> (*const lerp_62)(fix64<62>, fix64<62>, fix64<62>) = &lerp<62>;
+
+	result &= std::fabs(static_cast<double>(exp10_32(fix64<32>(1.5))) - std::pow(10.0, 1.5)) < 1e-5;
+	result &= std::fabs(static_cast<double>(atan2_48(fix64<48>(1), fix64<48>(-1))) - std::atan2(1.0, -1.0)) < 1e-9;
+	result &= lerp_62(fix64<62>(0.25), fix64<62>(0.75), fix64<62>(0.5)) == fix64<62>(0.5);
+
+	// the class members of fix64<16>
+	result &= static_cast<double>(fix64<16>::reinterpret(1LL << 56) / fix64<16>(4)) == std::ldexp(1.0, 38);
+	return result;
+}
+
+int main(){
+	TEST_CASE(test_instances32);
+	TEST_CASE(test_instances64);
+	return 0;
+}
@@ -0,0 +1,182 @@
+/*
+	Author: Tobias Wallner
+	tobias.wallner1@gmx.net
+
+*/
+
+#define FIXPOINT_INSTRUMENT_ARITHMETIC
+#define DISABLE_FIXPOINT_ASSERTIONS
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include "fix32.hpp"
+#include "fix64.hpp"
+#include "fixmath.hpp"
+
+#define TEST_CASE(function)										\
+	if(function()){ 											\
+		std::cout << "[  Ok  ] - " << #function << std::endl;	\
+	}else{ 														\
+		std::cout << "[Failed] - " << #function << std::endl;	\
+	}
+
+using fixpoint_instrument::event_kind;
+
+bool count_events(){
+	const fixpoint_instrument::counters before = fixpoint_instrument::thread_counters();
+	bool result = true;
+
+	volatile int32_t large = 40000;
+	const fix32<16> a = large;								// truncation
+	const fix32<16> b = fix32<16>(30000) + fix32<16>(30000);	// overflow
+	const fix32<16> c = fix32<16>(-30000) - fix32<16>(30000);	// overflow
+	const fix32<16> d = fix32<16>(300) * fix32<16>(300);		// overflow
+	const fix64<32> e = fix64<32>(2000000000) + fix64<32>(2000000000);	// overflow
+	const fix64<32> f = fix64<32>(100000) * fix64<32>(100000);	// overflow
+	const fix64<32> g = fix64<32>(-2000000000) - fix64<32>(2000000000);	// overflow
+	const fix32<16> h = exp2(fix32<16>(20));				// overflow
+	const fix32<16> i = log2(fix32<16>(-1));				// domain
+	const fix64<32> j = 5000000000LL;						// truncation
+
+	// no events
+	const fix32<16> k = fix32<16>(-30000) + fix32<16>(30000) + fix32<16>(100) * fix32<16>(-300) - fix32<16>(1);
+	const fix64<32> l = fix64<32>(-1000000000) + fix64<32>(-100000000) + fix64<32>(10000) * fix64<32>(-100000);
+	(void)a; (void)b; (void)c; (void)d; (void)e; (void)f; (void)g; (void)h; (void)i; (void)j; (void)k; (void)l;
+
+	const fixpoint_instrument::counters after = fixpoint_instrument::thread_counters();
+	result &= after[event_kind::truncation] - before[event_kind::truncation] == 2;
+	result &= after[event_kind::overflow] - before[event_kind::overflow] == 7;
+	result &= after[event_kind::domain] - before[event_kind::domain] == 1;
+	result &= after[event_kind::divide_by_zero] == before[event_kind::divide_by_zero];
+	result &= after.total() - before.total() == 10;
+	return result;
+}
+
+bool unchecked_conversions(){
+	// only the checked constructors report truncations
+	const fixpoint_instrument::counters before = fixpoint_instrument::thread_counters();
+	volatile int64_t large = 5000000000LL;
+	volatile float large_float = 5e9f;
+	volatile double large_double = 5e9;
+	const fix64<32> a = fixpoint_unchecked::convert<fix64<32>>(large);
+	const fix64<32> b = fixpoint_unchecked::convert<fix64<32>>(large_float);
+	const fix64<32> c = fixpoint_unchecked::convert<fix64<32>>(large_double);
+	const fix64<32> d = large_double;						// truncation
+	(void)a; (void)b; (void)c; (void)d;
+	const fixpoint_instrument::counters after = fixpoint_instrument::thread_counters();
+	return after[event_kind::truncation] - before[event_kind::truncation] == 1 && after.total() - before.total() == 1;
+}
+
+bool unchecked_exp2(){
+	// without assertions the results saturate instead of shifting out of range
+	bool result = true;
+	result &= exp2(fix32<16>(20)) == fix32<16>::reinterpret(INT32_MAX);
+	result &= exp2(fix32<16>(1000)) == fix32<16>::reinterpret(INT32_MAX);
+	result &= exp2(fix64<32>(40)) == fix64<32>::reinterpret(INT64_MAX);
+	result &= fixmath::precise::exp2(fix64<60>(3)) == fix64<60>::reinterpret(INT64_MAX);
+
+	// 2^x just below the largest power of two rounds up and is clamped without an overflow
+	const fixpoint_instrument::counters before = fixpoint_instrument::thread_counters();
+	result &= fixmath::precise::exp2(fix32<30>::reinterpret((1 << 30) - 1)) == fix32<30>::reinterpret(INT32_MAX);
+	result &= fixmath::precise::exp2(fix32<30>::reinterpret(1 << 29)) < fix32<30>::reinterpret(INT32_MAX);
+	const fixpoint_instrument::counters after = fixpoint_instrument::thread_counters();
+	result &= after[event_kind::saturation] - before[event_kind::saturation] == 1;
+	result &= after.total() - before.total() == 1;
+	return result;
+}
+
+bool recent_events(){
+	bool result = true;
+	const uint64_t first = fixpoint_instrument::events_recorded();
+	{
+		fixpoint_instrument::scoped_site site("recent_events");
+		volatile float large = -70000.5f;
+		const fix32<16> a = large;
+		const fix32<16> b = fix32<16>(-20000) - fix32<16>(20000);
+		(void)a; (void)b;
+	}
+	const fix32<16> c = fix32<16>(200) * fix32<16>(200);
+	(void)c;
+
+	fixpoint_instrument::event events[8];
+	const size_t n = fixpoint_instrument::recent_events(events, 8);
+	result &= fixpoint_instrument::events_recorded() == first + 3;
+	result &= n >= 3;
+	if(n < 3){
+		return false;
+	}
+	const fixpoint_instrument::event* e = events + n - 3;
+	result &= e[0].kind == event_kind::truncation && e[0].value == -70000.5 && e[0].sequence == first;
+	result &= std::strcmp(e[0].site, "recent_events") == 0;
+	result &= std::string(e[0].operation).find("fix32") != std::string::npos;
+	result &= e[1].kind == event_kind::overflow && e[1].value == -40000.0 && e[1].sequence == first + 1;
+	result &= std::strcmp(e[1].site, "recent_events") == 0;
+	result &= e[2].kind == event_kind::overflow && e[2].value == 40000.0 && e[2].site == nullptr;
+	result &= std::strcmp(fixpoint_instrument::to_string(e[2].kind), "overflow") == 0;
+
+	// only the most recent max_count events
+	result &= fixpoint_instrument::recent_events(events, 1) == 1 && events[0].sequence == first + 2;
+	return result;
+}
+
+bool threaded_events(){
+	bool result = true;
+	const fixpoint_instrument::counters before = fixpoint_instrument::total_counters();
+	const uint64_t first = fixpoint_instrument::events_recorded();
+	const int threads = 4;
+	const int events_per_thread = 10000;
+	std::atomic<int> running(threads);
+	std::atomic<bool> consistent(true);
+
+	// reads the ring while the workers write it
+	std::thread monitor([&](){
+		std::vector<fixpoint_instrument::event> events(FIXPOINT_EVENT_RING_SIZE);
+		while(running.load() > 0){
+			const size_t n = fixpoint_instrument::recent_events(events.data(), events.size());
+			for(size_t i = 0; i < n; ++i){
+				if(events[i].sequence < first){
+					continue;	// of the tests before
+				}
+				const bool valid = events[i].kind == event_kind::saturation && events[i].value == 1.5 && std::strcmp(events[i].site, "worker") == 0;
+				const bool increasing = i == 0 || events[i].sequence > events[i-1].sequence;
+				if(!valid || !increasing){
+					consistent = false;
+				}
+			}
+		}
+	});
+
+	std::vector<std::thread> workers;
+	for(int t = 0; t < threads; ++t){
+		workers.emplace_back([&](){
+			fixpoint_instrument::scoped_site site("worker");
+			for(int i = 0; i < events_per_thread; ++i){
+				fixpoint_instrument::record(event_kind::saturation, 1.5, "threaded_events");
+			}
+			running.fetch_sub(1);
+		});
+	}
+	for(std::thread& worker : workers){
+		worker.join();
+	}
+	monitor.join();
+
+	const fixpoint_instrument::counters after = fixpoint_instrument::total_counters();
+	result &= after[event_kind::saturation] - before[event_kind::saturation] == threads * events_per_thread;
+	result &= consistent.load();
+	return result;
+}
+
+int main(){
+	TEST_CASE(count_events);
+	TEST_CASE(unchecked_conversions);
+	TEST_CASE(unchecked_exp2);
+	TEST_CASE(recent_events);
+	TEST_CASE(threaded_events);
+	return 0;
+}
@@ -0,0 +1,246 @@
+/*
+	Author: Tobias Wallner
+	tobias.wallner1@gmx.net
+	
+*/
+
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <cstring>
+#include <limits>
+#include "fixio.hpp"
+
+#define TEST_CASE(function)										\
+	if(function()){ 											\
+		std::cout << "[  Ok  ] - " << #function << std::endl;	\
+	}else{ 														\
+		std::cout << "[Failed] - " << #function << std::endl;	\
+	}
+
+// ------------- parse_csv -------------
+
+bool test32_parse_csv(){
+	const std::string text = "time,temperature,pressure\r\n0,21.5,-1.25\r\n\r\n1,21.75,-1.5\r\n2.5,22,0.001";
+	std::vector<std::vector<fix32<16>>> columns;
+	csv_options options;
+	options.header_lines = 1;
+	const csv_result r = parse_csv(text.data(), text.data() + text.size(), columns, options);
+
+	bool result = true;
+	result &= r.ec == std::errc() && r.rows == 3 && columns.size() == 3;
+	result &= columns[0][0] == 0 && columns[0][1] == 1 && columns[0][2] == fix32<16>(2.5f);
+	result &= columns[1][0] == fix32<16>(21.5f) && columns[1][1] == fix32<16>(21.75f) && columns[1][2] == 22;
+	result &= columns[2][0] == fix32<16>(-1.25f) && columns[2][1] == fix32<16>(-1.5f) && columns[2][2] == fix32<16>::reinterpret(66); // 65.536
+
+	// other delimiters and a trailing line break
+	const std::string tabs = "1\t2\n3\t4\n";
+	options.delimiter = '\t';
+	options.header_lines = 0;
+	result &= parse_csv(tabs.data(), tabs.data() + tabs.size(), columns, options).rows == 2;
+	result &= columns.size() == 2 && columns[0][1] == 3 && columns[1][1] == 4;
+
+	// empty
+	result &= parse_csv(tabs.data(), tabs.data(), columns, options).ec == std::errc() && columns.empty();
+	return result;
+}
+
+bool test32_parse_csv_errors(){
+	std::vector<std::vector<fix32<16>>> columns;
+	auto parse = [&](const char* text){return parse_csv(text, text + std::strlen(text), columns);};
+	bool result = true;
+
+	csv_result r = parse("1,2\n3,x\n");
+	result &= r.ec == std::errc::invalid_argument && r.line == 2 && r.column == 3 && r.rows == 1;
+	result &= columns[0].size() == 1 && columns[0][0] == 1;
+
+	r = parse("1,2\n3,4.5x\n");
+	result &= r.ec == std::errc::invalid_argument && r.line == 2 && r.column == 6;
+
+	r = parse("1,2\n3\n");
+	result &= r.ec == std::errc::invalid_argument && r.line == 2 && r.column == 2;
+
+	r = parse("1,2\n\n3,4,5\n");
+	result &= r.ec == std::errc::invalid_argument && r.line == 3 && r.column == 4 && r.rows == 1;
+
+	r = parse("1,2\n3,40000\n");
+	result &= r.ec == std::errc::result_out_of_range && r.line == 2 && r.column == 3;
+	return result;
+}
+
+bool test32_parse_csv_threads(){
+	std::string text = "a;b\n";
+	for(int i = 0; i < 100000; ++i){
+		text += std::to_string(i % 30000) + "." + std::to_string(i % 997) + ";-" + std::to_string(i % 101) + ".0625\n";
+	}
+	std::vector<std::vector<fix32<16>>> single;
+	std::vector<std::vector<fix32<16>>> parallel;
+	csv_options options;
+	options.delimiter = ';';
+	options.header_lines = 1;
+	const csv_result r1 = parse_csv(text.data(), text.data() + text.size(), single, options);
+	options.threads = 4;
+	const csv_result r4 = parse_csv(text.data(), text.data() + text.size(), parallel, options);
+
+	bool result = true;
+	result &= r1.ec == std::errc() && r4.ec == std::errc() && r1.rows == 100000 && r4.rows == 100000;
+	result &= single == parallel;
+	result &= parallel[1][99999] == -(fix32<16>(99999 % 101) + fix32<16>(0.0625f));
+
+	// the line of an error is counted across the chunks
+	text += "1;2\n3;?\n";
+	const csv_result error = parse_csv(text.data(), text.data() + text.size(), parallel, options);
+	result &= error.ec == std::errc::invalid_argument && error.line == 100003 && error.column == 3 && error.rows == 100001;
+	return result;
+}
+
+bool test64_parse_csv(){
+	const std::string text = "0.000000000014551915228366851806640625,-123456789.5\n1e,2\n";
+	std::vector<std::vector<fix64<36>>> columns;
+	const csv_result r = parse_csv(text.data(), text.data() + text.size(), columns);
+
+	bool result = true;
+	result &= r.ec == std::errc::invalid_argument && r.line == 2 && r.column == 2 && r.rows == 1 && columns[0].size() == 1;
+	result &= columns[0][0] == fix64<36>::reinterpret(1) && columns[1][0] == fix64<36>::reinterpret(-(123456789LL << 36) - (1LL << 35));
+	return result;
+}
+
+// ------------- write_csv -------------
+
+// writes pseudo random raw values with write_csv() and compares them to print()
+template<class Fix, class Raw>
+bool check_write_matches_print(size_t precision){
+	std::vector<std::vector<Fix>> columns(3);
+	uint64_t state = 0x9E3779B97F4A7C15ULL;
+	for(int i = 0; i < 2000; ++i){
+		for(std::vector<Fix>& column : columns){
+			state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+			// small, large and mixed magnitudes
+			const int shift = static_cast<int>(state >> 58);
+			const Raw raw = static_cast<Raw>(static_cast<int64_t>(state) >> shift);
+			column.push_back(Fix::reinterpret((raw == std::numeric_limits<Raw>::min()) ? 0 : raw));
+		}
+	}
+	std::ostringstream expected;
+	for(size_t row = 0; row < columns[0].size(); ++row){
+		for(size_t c = 0; c < columns.size(); ++c){
+			print(expected, columns[c][row], precision);
+			expected << ((c + 1 < columns.size()) ? ';' : '\n');
+		}
+	}
+	std::string csv;
+	write_options options;
+	options.precision = precision;
+	options.delimiter = ';';
+	write_csv(csv, columns, options);
+	return csv == expected.str();
+}
+
+bool test32_write_csv(){
+	bool result = true;
+	for(size_t precision : {0, 1, 3, 6, 12}){
+		result &= check_write_matches_print<fix32<1>, int32_t>(precision);
+		result &= check_write_matches_print<fix32<8>, int32_t>(precision);
+		result &= check_write_matches_print<fix32<16>, int32_t>(precision);
+		result &= check_write_matches_print<fix32<25>, int32_t>(precision);
+		result &= check_write_matches_print<fix32<26>, int32_t>(precision);
+		result &= check_write_matches_print<fix32<30>, int32_t>(precision);
+	}
+
+	std::vector<std::vector<fix32<16>>> columns = {{fix32<16>(1.5f), 2, fix32<16>(-0.001f)}, {0, fix32<16>(-12.25f), 100}};
+	std::string csv = "x,y\n";
+	write_csv(csv, columns);
+	result &= csv == "x,y\n1.5,0.\n2.,-12.25\n-0.0009918,100.\n";
+
+	// written values are read back by parse_csv()
+	std::vector<std::vector<fix32<16>>> parsed;
+	write_options options;
+	options.precision = 20;
+	csv.clear();
+	write_csv(csv, columns, options);
+	result &= parse_csv(csv.data(), csv.data() + csv.size(), parsed).rows == 3 && parsed == columns;
+	return result;
+}
+
+bool test32_write_csv_buffer(){
+	std::vector<std::vector<fix32<16>>> columns = {{fix32<16>(1.5f), 2}, {fix32<16>(-0.25f), 3}};
+	const std::string expected = "1.5,-0.25\n2.,3.\n";
+	bool result = true;
+
+	char buffer[64];
+	fix_to_chars_result r = write_csv(buffer, buffer + sizeof(buffer), columns);
+	result &= r.ec == std::errc() && std::string(buffer, r.ptr) == expected;
+
+	// exactly fitting and one character too small
+	r = write_csv(buffer, buffer + expected.size(), columns);
+	result &= r.ec == std::errc() && std::string(buffer, r.ptr) == expected;
+	r = write_csv(buffer, buffer + expected.size() - 1, columns);
+	result &= r.ec == std::errc::value_too_large && r.ptr == buffer + expected.size() - 1;
+
+	write_options options;
+	options.threads = 2;
+	r = write_csv(buffer, buffer + expected.size() - 1, columns, options);
+	result &= r.ec == std::errc::value_too_large;
+	r = write_csv(buffer, buffer + sizeof(buffer), columns, options);
+	result &= r.ec == std::errc() && std::string(buffer, r.ptr) == expected;
+	return result;
+}
+
+bool test32_write_csv_threads(){
+	std::vector<std::vector<fix32<16>>> columns(2);
+	for(int i = 0; i < 100000; ++i){
+		columns[0].push_back(fix32<16>::reinterpret(i * 7919));
+		columns[1].push_back(fix32<16>::reinterpret(-i * 131));
+	}
+	std::string single;
+	std::string parallel = "header\n";
+	write_options options;
+	options.precision = 5;
+	write_csv(single, columns, options);
+	options.threads = 3;
+	write_csv(parallel, columns, options);
+	return parallel == "header\n" + single;
+}
+
+bool test64_write_csv(){
+	bool result = true;
+	for(size_t precision : {0, 3, 9, 18}){
+		result &= check_write_matches_print<fix64<1>, int64_t>(precision);
+		result &= check_write_matches_print<fix64<16>, int64_t>(precision);
+		result &= check_write_matches_print<fix64<32>, int64_t>(precision);
+		result &= check_write_matches_print<fix64<57>, int64_t>(precision);
+		result &= check_write_matches_print<fix64<58>, int64_t>(precision);
+		result &= check_write_matches_print<fix64<61>, int64_t>(precision);
+	}
+	return result;
+}
+
+bool test32_write_json(){
+	std::vector<std::vector<fix32<16>>> columns = {{fix32<16>(1.5f), 2}, {fix32<16>(-0.25f), 0}, {}};
+	std::string json;
+	write_json(json, columns);
+	bool result = json == "[[1.5,2.0],[-0.25,0.0],[]]";
+	json.clear();
+	write_json(json, columns[0]);
+	result &= json == "[1.5,2.0]";
+	return result;
+}
+
+int main(){
+	
+	std::cout << "fixio tests:" << std::endl;
+	std::cout << "---------------" << std::endl;
+	
+	TEST_CASE(test32_parse_csv);
+	TEST_CASE(test32_parse_csv_errors);
+	TEST_CASE(test32_parse_csv_threads);
+	TEST_CASE(test64_parse_csv);
+	TEST_CASE(test32_write_csv);
+	TEST_CASE(test32_write_csv_buffer);
+	TEST_CASE(test32_write_csv_threads);
+	TEST_CASE(test64_write_csv);
+	TEST_CASE(test32_write_json);
+	
+	return 0;
+}
@@ -0,0 +1,75 @@
+/*
+	Author: Tobias Wallner
+	tobias.wallner1@gmx.net
+	
+*/
+
+
+#include <iostream>
+#include <sstream>
+#include "fixliterals.hpp"
+
+#define TEST_CASE(function)										\
+	if(function()){ 											\
+		std::cout << "[  Ok  ] - " << #function << std::endl;	\
+	}else{ 														\
+		std::cout << "[Failed] - " << #function << std::endl;	\
+	}
+
+using namespace fixpoint_literals;
+
+// the literals are constant expressions
+static_assert((1.5_q16).reinterpret_as_int32() == 0x18000, "1.5_q16");
+static_assert(fix64<60>(1.4426950408889634074_fix).reinterpret_as_int64() == 1663314137230540312LL, "log2(e) in fix64<60>");
+
+// ------------- literals -------------
+
+bool test32_literals(){
+	bool result = true;
+	result &= 1.5_q16 == fix32<16>(1.5f) && 0.25_q8 == fix32<8>(0.25f) && 100_q24 == 100;
+	result &= fix32<16>(2_fix) == 2 && fix32<16>(-2_fix) == -2;
+
+	// correctly rounded: round(-0.0784753434979 * 2^30) = -84262258, the string constructor gives -84262240
+	constexpr fix32<30> a = -0.0784753434979_fix;
+	result &= a == fix32<30>::reinterpret(-84262258);
+
+	// ties to even: 2^-17 and 3 * 2^-17 are halfway between two raw values of fix32<16>
+	result &= fix32<16>(0.00000762939453125_fix) == fix32<16>::reinterpret(0);
+	result &= fix32<16>(0.00002288818359375_fix) == fix32<16>::reinterpret(2);
+	result &= fix32<16>(0.000007629394531250000001_fix) == fix32<16>::reinterpret(1);
+	result &= fix32<16>(-0.00002288818359375_fix) == fix32<16>::reinterpret(-2);
+
+	// exponents and digit separators
+	result &= fix32<16>(2.5e-3_fix) == fix32<16>::reinterpret(164);
+	result &= fix32<16>(1.25e2_fix) == fix32<16>(125) && fix32<16>(125E-2_fix) == fix32<16>(1.25f);
+	result &= fix32<16>(1'000.5_fix) == fix32<16>(1000.5f);
+	result &= fix32<16>(1e-30_fix) == 0;
+
+	// the limits
+	result &= fix32<16>(-32768_fix) == fix32<16>::reinterpret(-0x7FFFFFFF - 1);
+	result &= fix32<16>(32767.9999847412109375_fix) == fix32<16>::reinterpret(0x7FFFFFFF);
+	result &= fix32<31>(-1_fix) == fix32<31>::reinterpret(-0x7FFFFFFF - 1);
+	return result;
+}
+
+bool test64_literals(){
+	bool result = true;
+	result &= fix64<60>(1.4426950408889634074_fix) == fix64<60>::reinterpret(1663314137230540312LL);
+	result &= fix64<32>(-123456789.123456789_fix) == fix64<32>::reinterpret(-530242871754415415LL);
+	result &= fix64<1>(7_fix) == fix64<1>::reinterpret(14);
+	result &= fix64<16>(-140737488355328_fix) == fix64<16>::reinterpret(INT64_MIN);
+	result &= fix64<62>(-2_fix) == fix64<62>::reinterpret(INT64_MIN);
+	result &= fix64<62>(1.99999999999999999989157978275144955_fix) == fix64<62>::reinterpret(INT64_MAX);
+	return result;
+}
+
+int main(){
+	
+	std::cout << "fixliterals tests:" << std::endl;
+	std::cout << "---------------" << std::endl;
+	
+	TEST_CASE(test32_literals);
+	TEST_CASE(test64_literals);
+	
+	return 0;
+}
@@ -8,6 +8,7 @@
 #include <iostream>
 #include <sstream>
 #include <cmath>
+#include <limits>
 #include "fixmath.hpp"
 
 #define print_result(value) std::cout << #value << " = " << (value) << std::endl;
@@ -381,6 +382,317 @@ bool test64_mod_mm(){
 	return m == expected;
 }
 
+// ------------- atan, atan2, polar -------------
+
+template<size_t N> double to_double(fix32<N> f){return std::ldexp(static_cast<double>(f.reinterpret_as_int32()), -static_cast<int>(N));}
+template<size_t N> double to_double(fix64<N> f){return std::ldexp(static_cast<double>(f.reinterpret_as_int64()), -static_cast<int>(N));}
+
+bool test32_atan2(){
+	const float xs[] = {3.5f, -3.5f, 0.f, 0.f, -2.25f, 1.f, 0.001f};
+	const float ys[] = {1.25f, 1.25f, 2.f, -2.f, -7.75f, 0.f, -0.002f};
+	bool result = true;
+	for(int i = 0; i < 7; ++i){
+		const fix32<20> x(xs[i]);
+		const fix32<20> y(ys[i]);
+		const double expected = std::atan2(to_double(y), to_double(x));
+		result &= std::abs(to_double(atan2(y, x)) - expected) < 1e-5;
+	}
+	return result;
+}
+
+bool test64_atan2(){
+	const float xs[] = {3.5f, -3.5f, 0.f, 0.f, -2.25f, 1.f, 0.001f};
+	const float ys[] = {1.25f, 1.25f, 2.f, -2.f, -7.75f, 0.f, -0.002f};
+	bool result = true;
+	for(int i = 0; i < 7; ++i){
+		const fix64<40> x(xs[i]);
+		const fix64<40> y(ys[i]);
+		const double expected = std::atan2(to_double(y), to_double(x));
+		result &= std::abs(to_double(atan2(y, x)) - expected) < 1e-10;
+	}
+	return result;
+}
+
+// the largest error of precise::atan2 in ulp of fix64<N> on pseudo random inputs, measured with long double
+template<size_t N>
+long double atan2_error_ulp(int input_shift){
+	uint64_t state = 88172645463325252ULL;
+	long double worst = 0;
+	for(int i = 0; i < 20000; ++i){
+		state ^= state << 13; state ^= state >> 7; state ^= state << 17;
+		const int64_t x = static_cast<int64_t>(state) >> (input_shift + static_cast<int>(state % 24));
+		state ^= state << 13; state ^= state >> 7; state ^= state << 17;
+		const int64_t y = static_cast<int64_t>(state) >> input_shift;
+		const fix64<N> angle = fixmath::precise::atan2(fix64<N>::reinterpret(y), fix64<N>::reinterpret(x));
+		const long double ulp = std::ldexp(1.0L, -static_cast<int>(N));
+		const long double error = std::abs(static_cast<long double>(angle.reinterpret_as_int64()) * ulp - std::atan2(static_cast<long double>(y), static_cast<long double>(x))) / ulp;
+		worst = (error > worst) ? error : worst;
+	}
+	return worst;
+}
+
+bool test_precise_atan2_error(){
+	// long double needs more bits than the angle of fix64<60>
+	if(std::numeric_limits<long double>::digits < 64){
+		return true;
+	}
+	bool result = true;
+	// the angle is correctly rounded up to ~52 fractional bits, the CORDIC kernel has an error of ~2^-56.5
+	result &= atan2_error_ulp<40>(2) <= 0.51L;
+	result &= atan2_error_ulp<52>(2) <= 0.6L;
+	result &= atan2_error_ulp<60>(2) <= 16;
+	return result;
+}
+
+bool test32_atan(){
+	const float as[] = {0.f, 0.5f, -0.5f, 1.f, 100.f, -1000.f};
+	bool result = true;
+	for(float a : as){
+		const fix32<16> x(a);
+		result &= std::abs(to_double(atan(x)) - std::atan(to_double(x))) < 1e-4;
+	}
+	return result;
+}
+
+bool test64_atan(){
+	const float as[] = {0.f, 0.5f, -0.5f, 1.f, 100.f, -1000.f};
+	bool result = true;
+	for(float a : as){
+		const fix64<48> x(a);
+		result &= std::abs(to_double(atan(x)) - std::atan(to_double(x))) < 1e-12;
+	}
+	return result;
+}
+
+bool test32_polar(){
+	const fix32<16> x(-300);
+	const fix32<16> y(400);
+	const polar_coordinates<fix32<16>> p = polar(x, y);
+	return std::abs(to_double(p.magnitude) - 500.0) < 1e-4 
+		&& std::abs(to_double(p.angle) - std::atan2(400.0, -300.0)) < 1e-4
+		&& polar(fix32<16>(0), fix32<16>(0)).magnitude == 0;
+}
+
+bool test64_polar(){
+	const fix64<32> x(-300);
+	const fix64<32> y(-400);
+	const polar_coordinates<fix64<32>> p = polar(x, y);
+	return std::abs(to_double(p.magnitude) - 500.0) < 1e-8 
+		&& std::abs(to_double(p.angle) - std::atan2(-400.0, -300.0)) < 1e-8;
+}
+
+// ------------- poly_eval -------------
+
+bool test32_poly_eval(){
+	// 1 + x/2 + x^2/4 + x^3/8 + x^4/16 + x^5/32
+	using poly = poly_eval<fix32<30>, 1LL<<30, 1LL<<29, 1LL<<28, 1LL<<27, 1LL<<26, 1LL<<25>;
+	const fix32<30> x = fix32<30>::reinterpret(1<<29);
+	const fix32<30> expected = fix32<30>::reinterpret(1431306240);
+	
+	fix32<30> xs[3] = {x, x, x};
+	fix32<30> ys[3];
+	poly::eval(xs, xs+3, ys);
+	
+	return poly::horner(x) == expected && poly::estrin(x) == expected && ys[2] == expected;
+}
+
+bool test64_poly_eval(){
+	// 0.5 - 2*x + 1.5*x^2
+	using poly = poly_eval<fix64<40>, 1LL<<39, -(2LL<<40), 3LL<<39>;
+	const fix64<40> x = fix64<40>::reinterpret(-(5LL<<38));
+	const fix64<40> expected = fix64<40>::reinterpret((1LL<<39) + (5LL<<39) + (75LL<<35));
+	bool result = poly::horner(x) == expected && poly::estrin(x) == expected;
+
+	// integer format: no shift after the multiplications, 3 - x + 2*x^2 at x = -3
+	using integer_poly = poly_eval<fix64<0>, 3, -1, 2>;
+	const fix64<0> xi = fix64<0>::reinterpret(-3);
+	result &= integer_poly::horner(xi).reinterpret_as_int64() == 24 && integer_poly::estrin(xi).reinterpret_as_int64() == 24;
+
+#if defined(__SIZEOF_INT128__)
+	// rounded once: equal to the exact value rounded to the nearest, 3/256 - 100/256*x + ... - 19/256*x^4
+	using exact_poly = poly_eval<fix64<8>, 3, -100, 77, 45, -19>;
+	for(int64_t raw = -300; raw <= 300; ++raw){
+		const int64_t numerator = (((-19 * raw + (45LL << 8)) * raw + (77LL << 16)) * raw - (100LL << 24)) * raw + (3LL << 32);
+		const int64_t exact = (numerator + (1LL << 31)) >> 32;
+		const fix64<8> xr = fix64<8>::reinterpret(raw);
+		result &= exact_poly::horner(xr).reinterpret_as_int64() == exact && exact_poly::estrin(xr).reinterpret_as_int64() == exact;
+	}
+#endif
+
+	// ties round towards +infinity
+	result &= fixpoint_detail::mul_shift_round(3, 1, 1) == 2 && fixpoint_detail::mul_shift_round(-3, 1, 1) == -1;
+	result &= fixpoint_detail::mul_shift_round(-5, 3, 0) == -15;
+	return result;
+}
+
+// ------------- exp2, log2 -------------
+
+bool test32_exp2(){
+	const float as[] = {0.f, 1.f, -1.f, 3.25f, -2.75f, 7.5f};
+	bool result = true;
+	for(float a : as){
+		const double expected = std::exp2(a);
+		result &= std::abs(to_double(exp2(fix32<16>(a))) - expected) < expected * 4e-3;
+	}
+	return result;
+}
+
+bool test64_exp2(){
+	const float as[] = {0.f, 1.f, -1.f, 3.25f, -2.75f, 7.5f};
+	bool result = true;
+	for(float a : as){
+		const double expected = std::exp2(a);
+		result &= std::abs(to_double(exp2(fix64<40>(a))) - expected) < expected * 4e-3;
+	}
+	// just below the next integer, 2^fractions is close to 2 and saturates the largest formats
+	result &= std::abs(fixmath::precise::exp2(fix64<61>::reinterpret((1LL << 61) - 1)).reinterpret_as_int64() - (1LL << 62)) <= 1;
+	result &= fixmath::precise::exp2(fix64<62>::reinterpret((1LL << 62) - 1)) == fix64<62>::reinterpret(INT64_MAX);
+	result &= fixmath::precise::exp2(fix32<30>::reinterpret((1 << 30) - 1)) == fix32<30>::reinterpret(INT32_MAX);
+	return result;
+}
+
+bool test64_exp_exp10(){
+	// negative inputs multiply log2(e) and log2(10) by a negative fix64
+	const float as[] = {-1.f, -0.5f, -3.f, -7.25f, 0.75f, 2.5f};
+	bool result = true;
+	for(float a : as){
+		const fix64<32> x(a);
+		const double e = std::exp(static_cast<double>(a));
+		const double t = std::pow(10.0, static_cast<double>(a));
+		result &= std::abs(to_double(fixmath::fast::exp(x)) - e) < e * 4e-3;
+		result &= std::abs(to_double(fixmath::balanced::exp(x)) - e) < e * 4e-6;
+		result &= std::abs(to_double(fixmath::precise::exp(x)) - e) < e * 1e-7;
+		result &= std::abs(to_double(exp(x)) - e) < e * 4e-6;
+		result &= std::abs(to_double(fixmath::fast::exp10(x)) - t) < t * 4e-3 + 1e-9;
+		result &= std::abs(to_double(fixmath::balanced::exp10(x)) - t) < t * 4e-6 + 1e-9;
+		result &= std::abs(to_double(fixmath::precise::exp10(x)) - t) < t * 1e-7 + 1e-9;
+		result &= std::abs(to_double(exp10(x)) - t) < t * 4e-6 + 1e-9;
+	}
+	return result;
+}
+
+bool test32_log2(){
+	const float as[] = {1.f, 2.f, 0.125f, 3.25f, 1000.f, 0.001f};
+	bool result = true;
+	for(float a : as){
+		const fix32<16> x(a);
+		result &= std::abs(to_double(log2(x)) - std::log2(to_double(x))) < 3e-4;
+	}
+	return result;
+}
+
+bool test64_log2(){
+	const float as[] = {1.f, 2.f, 0.125f, 3.25f, 1000.f, 0.001f};
+	bool result = true;
+	for(float a : as){
+		const fix64<40> x(a);
+		result &= std::abs(to_double(log2(x)) - std::log2(to_double(x))) < 3e-4;
+	}
+	return result;
+}
+
+// ------------- accuracy tiers -------------
+
+bool test32_tiers(){
+	const float as[] = {0.1f, 0.7f, -1.3f, 2.9f};
+	bool result = true;
+	for(float a : as){
+		const fix32<24> x(a);
+		const double e = std::exp2(to_double(x));
+		const double l = std::log2(to_double(x + 2));
+		result &= std::abs(to_double(fixmath::fast::exp2(x)) - e) < e * 4e-3;
+		result &= std::abs(to_double(fixmath::balanced::exp2(x)) - e) < e * 4e-6;
+		result &= std::abs(to_double(fixmath::precise::exp2(x)) - e) < e * 2e-7;
+		result &= std::abs(to_double(fixmath::fast::log2(x + 2)) - l) < 2e-3;
+		result &= std::abs(to_double(fixmath::balanced::log2(x + 2)) - l) < 4e-6;
+		result &= std::abs(to_double(fixmath::precise::log2(x + 2)) - l) < 2e-7;
+		result &= std::abs(to_double(fixmath::fast::atan(x)) - std::atan(to_double(x))) < 1e-3;
+		result &= std::abs(to_double(fixmath::precise::atan(x)) - std::atan(to_double(x))) < 2e-7;
+	}
+	return result;
+}
+
+bool test64_tiers(){
+	const float as[] = {0.1f, 0.7f, -1.3f, 2.9f};
+	bool result = true;
+	for(float a : as){
+		const fix64<56> x(a);
+		const long double e = std::exp2(static_cast<long double>(to_double(x)));
+		const long double l = std::log2(static_cast<long double>(to_double(x + 2)));
+		result &= std::abs(to_double(fixmath::fast::exp2(x)) - e) < e * 4e-3;
+		result &= std::abs(to_double(fixmath::balanced::exp2(x)) - e) < e * 4e-6;
+		result &= std::abs(to_double(fixmath::precise::exp2(x)) - e) < e * 1e-15;
+		result &= std::abs(to_double(fixmath::fast::log2(x + 2)) - l) < 2e-3;
+		result &= std::abs(to_double(fixmath::balanced::log2(x + 2)) - l) < 4e-6;
+		result &= std::abs(to_double(fixmath::precise::log2(x + 2)) - l) < 1e-15;
+	}
+	return result;
+}
+
+// ------------- activation functions -------------
+
+bool test32_tanh_sigmoid(){
+	bool result = true;
+	for(int i = -400; i <= 400; ++i){
+		const fix32<24> x = fix32<24>::reinterpret(i * (1 << 21) + 12345);
+		const double xd = to_double(x);
+		result &= std::abs(to_double(tanh(x)) - std::tanh(xd)) < 1e-5;
+		result &= std::abs(to_double(sigmoid(x)) - 1.0 / (1.0 + std::exp(-xd))) < 1e-5;
+	}
+	return result;
+}
+
+bool test32_gelu_relu6(){
+	bool result = true;
+	for(int i = -400; i <= 400; ++i){
+		const fix32<16> x = fix32<16>::reinterpret(i * (1 << 13) + 123);
+		const double xd = to_double(x);
+		const double expected_gelu = 0.5 * xd * (1.0 + std::tanh(std::sqrt(2.0 / 3.14159265358979) * (xd + 0.044715 * xd * xd * xd)));
+		const double expected_relu6 = (xd < 0) ? 0.0 : (xd > 6) ? 6.0 : xd;
+		result &= std::abs(to_double(gelu(x)) - expected_gelu) < 1e-4;
+		result &= to_double(relu6(x)) == expected_relu6;
+	}
+	return result;
+}
+
+bool test32_batch_activations(){
+	fix32<20> x[5] = {fix32<20>(-3.5f), fix32<20>(-0.25f), fix32<20>(0), fix32<20>(1.75f), fix32<20>(7.f)};
+	fix32<20> y[5];
+	bool result = true;
+	result &= tanh(x, x+5, y) == y+5;
+	for(int i = 0; i < 5; ++i) result &= y[i] == tanh(x[i]);
+	sigmoid(x, x+5, y);
+	for(int i = 0; i < 5; ++i) result &= y[i] == sigmoid(x[i]);
+	gelu(x, x+5, y);
+	for(int i = 0; i < 5; ++i) result &= y[i] == gelu(x[i]);
+	relu6(x, x+5, y);
+	for(int i = 0; i < 5; ++i) result &= y[i] == relu6(x[i]);
+	return result;
+}
+
+bool test32_softmax(){
+	const float xs[6] = {1.5f, -2.f, 0.25f, 3.f, 3.f, -20.f};
+	fix32<24> x[6];
+	fix32<24> y[6];
+	for(int i = 0; i < 6; ++i) x[i] = fix32<24>(xs[i]);
+	
+	double sum = 0;
+	for(int i = 0; i < 6; ++i) sum += std::exp(static_cast<double>(xs[i]));
+	
+	bool result = softmax(x, x+6, y) == y+6;
+	double total = 0;
+	for(int i = 0; i < 6; ++i){
+		result &= std::abs(to_double(y[i]) - std::exp(static_cast<double>(xs[i])) / sum) < 1e-5;
+		total += to_double(y[i]);
+	}
+	
+	// in place
+	softmax(x, x+6, x);
+	for(int i = 0; i < 6; ++i) result &= x[i] == y[i];
+	
+	return result && std::abs(total - 1.0) < 1e-5;
+}
+
 int main(){
 	
 	std::cout << "fixmath tests:" << std::endl;
@@ -419,6 +731,31 @@ int main(){
 	TEST_CASE(test64_mod_pm);
 	TEST_CASE(test64_mod_mm);
 	
+	TEST_CASE(test32_atan2);
+	TEST_CASE(test64_atan2);
+	TEST_CASE(test_precise_atan2_error);
+	TEST_CASE(test32_atan);
+	TEST_CASE(test64_atan);
+	TEST_CASE(test32_polar);
+	TEST_CASE(test64_polar);
+	
+	TEST_CASE(test32_poly_eval);
+	TEST_CASE(test64_poly_eval);
+	
+	TEST_CASE(test32_exp2);
+	TEST_CASE(test64_exp2);
+	TEST_CASE(test64_exp_exp10);
+	TEST_CASE(test32_log2);
+	TEST_CASE(test64_log2);
+	
+	TEST_CASE(test32_tiers);
+	TEST_CASE(test64_tiers);
+	
+	TEST_CASE(test32_tanh_sigmoid);
+	TEST_CASE(test32_gelu_relu6);
+	TEST_CASE(test32_batch_activations);
+	TEST_CASE(test32_softmax);
+	
 	
 	
 	return 0;
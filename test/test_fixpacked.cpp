@@ -0,0 +1,102 @@
+/*
+	Author: Tobias Wallner
+	tobias.wallner1@gmx.net
+	
+*/
+
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include "fixpacked.hpp"
+
+#define TEST_CASE(function)										\
+	if(function()){ 											\
+		std::cout << "[  Ok  ] - " << #function << std::endl;	\
+	}else{ 														\
+		std::cout << "[Failed] - " << #function << std::endl;	\
+	}
+
+// ------------- packed_fix_array -------------
+
+// sets pseudo random values one by one and in bulk, and reads them back with get() and unpack()
+template<class Fix, size_t Bits>
+bool check_packed(Fix offset, unsigned scale_log2){
+	const size_t size = 1000;
+	packed_fix_array<Fix, Bits> single(size, offset, scale_log2);
+	packed_fix_array<Fix, Bits> bulk(size, offset, scale_log2);
+	std::vector<Fix> values;
+	uint64_t state = 12345;
+	for(size_t i = 0; i < size; ++i){
+		state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+		const uint64_t packed = (Bits == 64) ? state : (state >> (64 - Bits));
+		using type = fixpoint_detail::packed_type<Fix>;
+		values.push_back(type::make(static_cast<typename type::unsigned_type>((packed << scale_log2) + type::raw(offset))));
+	}
+
+	bool result = true;
+	for(size_t i = 0; i < size; ++i){
+		single.set(i, values[i]);
+	}
+	// unaligned start and end around the blocks of 64 values
+	bulk.pack(0, values.data(), 3);
+	bulk.pack(3, values.data() + 3, size - 3 - 70);
+	bulk.pack(size - 70, values.data() + size - 70, 70);
+	for(size_t i = 0; i < size; ++i){
+		result &= single.get(i) == values[i] && bulk[i] == values[i];
+	}
+
+	std::vector<Fix> unpacked(size - 5);
+	single.unpack(5, size - 5, unpacked.data());
+	result &= std::equal(unpacked.begin(), unpacked.end(), values.begin() + 5);
+	unpacked.resize(size);
+	bulk.unpack(0, size, unpacked.data());
+	result &= unpacked == values;
+	return result;
+}
+
+bool packed_fix_array_round_trip(){
+	bool result = true;
+	result &= check_packed<fix32<8>, 12>(fix32<8>(0), 0);
+	result &= check_packed<fix32<8>, 1>(fix32<8>(0), 0);
+	result &= check_packed<fix32<16>, 7>(fix32<16>(-3), 4);
+	result &= check_packed<fix32<16>, 31>(fix32<16>(-16384), 0);
+	result &= check_packed<fix32<16>, 32>(fix32<16>(0), 0);
+	result &= check_packed<fix64<32>, 20>(fix64<32>(-100), 12);
+	result &= check_packed<fix64<32>, 63>(fix64<32>(0), 0);
+	result &= check_packed<fix64<32>, 64>(fix64<32>(0), 0);
+	return result;
+}
+
+bool packed_fix_array_range(){
+	// 12-bit ADC readings around 0 with a resolution of 1/16
+	packed_fix_array<fix32<8>, 12> adc(4, fix32<8>(-128), 4);
+	bool result = adc.size() == 4 && adc.bytes() == 2 * sizeof(uint64_t);
+	result &= adc.lowest() == fix32<8>(-128) && adc.highest() == fix32<8>::reinterpret(-128 * 256 + 4095 * 16);
+	result &= adc[0] == fix32<8>(-128) && adc[3] == fix32<8>(-128);
+
+	adc.set(1, fix32<8>(1.5f));
+	adc.set(2, fix32<8>::reinterpret(100 * 256 + 17)); // the lowest 4 bits of the distance to the offset are dropped
+	result &= adc[1] == fix32<8>(1.5f) && adc[2] == fix32<8>::reinterpret(100 * 256 + 16);
+
+	adc.push_back(fix32<8>(-1));
+	result &= adc.size() == 5 && adc[4] == fix32<8>(-1) && adc[2] == fix32<8>::reinterpret(100 * 256 + 16);
+
+	// removed values do not come back
+	adc.resize(2);
+	adc.resize(5);
+	result &= adc[1] == fix32<8>(1.5f) && adc[2] == fix32<8>(-128) && adc[4] == fix32<8>(-128);
+	return result;
+}
+
+int main(){
+	
+	std::cout << "fixpacked tests:" << std::endl;
+	std::cout << "---------------" << std::endl;
+	
+	TEST_CASE(packed_fix_array_round_trip);
+	TEST_CASE(packed_fix_array_range);
+	
+	return 0;
+}
@@ -0,0 +1,121 @@
+/*
+	Author: Tobias Wallner
+	tobias.wallner1@gmx.net
+
+*/
+
+#define FIXPOINT_PROFILE
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "fix32.hpp"
+#include "fix64.hpp"
+#include "fixprofile.hpp"
+
+#define TEST_CASE(function)										\
+	if(function()){ 											\
+		std::cout << "[  Ok  ] - " << #function << std::endl;	\
+	}else{ 														\
+		std::cout << "[Failed] - " << #function << std::endl;	\
+	}
+
+const fixpoint_profiler::site_report* find_site(const std::vector<fixpoint_profiler::site_report>& reports, const std::string& name){
+	for(const fixpoint_profiler::site_report& report : reports){
+		if(name == report.name){
+			return &report;
+		}
+	}
+	return nullptr;
+}
+
+bool test32_profile(){
+	bool result = true;
+	fix32<16> sum = 0;
+	for(int i = -1000; i <= 1000; ++i){
+		// values in [-3.90625, 3.90625]
+		const fix32<16> y = fixpoint_profile("test32.y", fix32<16>(i) / 256);
+		sum += y;
+	}
+	result &= fixpoint_profile("test32.passthrough", fix32<16>(1.5)) == fix32<16>(1.5);
+
+	const std::vector<fixpoint_profiler::site_report> reports = fixpoint_profiler::collect();
+	const fixpoint_profiler::site_report* y = find_site(reports, "test32.y");
+	if(y == nullptr){
+		return false;
+	}
+	result &= y->width == 32 && y->fractional_bits == 16;
+	result &= y->count == 2001 && y->zeros == 1;
+	result &= y->min == -1000 / 256.0 && y->max == 1000 / 256.0;
+	result &= y->abs_min == 1 / 256.0;
+	result &= y->integer_bits == 2;
+	result &= y->headroom == 13;
+	result &= y->recommended_fractional_bits == 29;
+	result &= y->smallest_width == 32;
+	return result;
+}
+
+bool test32_profile_small_values(){
+	bool result = true;
+	for(int i = 0; i < 1000; ++i){
+		// one outlier in 1000
+		const fix32<20> value = (i == 500) ? fix32<20>(100) : fix32<20>::reinterpret(i * 7 - 3500);
+		fixpoint_profile("test32.small", value);
+	}
+	const std::vector<fixpoint_profiler::site_report> reports = fixpoint_profiler::collect();
+	const fixpoint_profiler::site_report* s = find_site(reports, "test32.small");
+	if(s == nullptr){
+		return false;
+	}
+	// |raw| <= 3500 needs 12 bits, 100.0 needs 27 bits
+	result &= s->integer_bits == 7;
+	result &= s->integer_bits_999 == 12 - 20;
+	result &= s->headroom == 31 - 27;
+	result &= s->recommended_fractional_bits == 24;
+	result &= s->smallest_width == 32;
+	return result;
+}
+
+bool test64_profile(){
+	bool result = true;
+	std::vector<std::thread> threads;
+	for(int t = 0; t < 4; ++t){
+		threads.emplace_back([t](){
+			for(int i = 0; i < 1000; ++i){
+				fixpoint_profile("test64.threads", fix64<32>::reinterpret((t * 1000 + i) - 2000));
+			}
+		});
+	}
+	for(std::thread& thread : threads){
+		thread.join();
+	}
+	const std::vector<fixpoint_profiler::site_report> reports = fixpoint_profiler::collect();
+	const fixpoint_profiler::site_report* s = find_site(reports, "test64.threads");
+	if(s == nullptr){
+		return false;
+	}
+	// raw values in [-2000, 1999], fit into 16 bits with 32 fractional bits
+	result &= s->width == 64 && s->fractional_bits == 32;
+	result &= s->count == 4000 && s->zeros == 1;
+	result &= s->integer_bits == 11 - 32;
+	result &= s->recommended_fractional_bits == 62;
+	result &= s->smallest_width == 16;
+
+	std::stringstream stream;
+	fixpoint_profiler::report(stream);
+	result &= stream.str().find("test64.threads") != std::string::npos;
+	result &= stream.str().find("fix64<32>") != std::string::npos;
+	return result;
+}
+
+int main(){
+	fixpoint_profiler::set_report_stream(nullptr);
+
+	TEST_CASE(test32_profile);
+	TEST_CASE(test32_profile_small_values);
+	TEST_CASE(test64_profile);
+
+	return 0;
+}
@@ -0,0 +1,124 @@
+/*
+	Author: Tobias Wallner
+	tobias.wallner1@gmx.net
+
+*/
+
+#define FIXPOINT_SHADOW
+
+#include <iostream>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "fixshadow.hpp"
+
+#define TEST_CASE(function)										\
+	if(function()){ 											\
+		std::cout << "[  Ok  ] - " << #function << std::endl;	\
+	}else{ 														\
+		std::cout << "[Failed] - " << #function << std::endl;	\
+	}
+
+using fixpoint_error_tracker::site_report;
+
+static site_report find_site(const char* name){
+	for(const site_report& s : fixpoint_error_tracker::collect()){
+		if(std::strcmp(s.name, name) == 0){
+			return s;
+		}
+	}
+	return site_report{name, 0, 0, 0, 0, 0, 0, 0, 0};
+}
+
+bool test_operators(){
+	bool result = true;
+	using real = fix_shadow<fix32<16>>;
+
+	const real third = real(1) / 3;
+	result &= third.value() == fix32<16>(1) / 3;
+	result &= third.shadow() == 1.0L / 3;
+	result &= std::fabs(third.error()) <= std::ldexp(1.0L, -16);
+
+	// comparisons and conversions use the fixed-point value
+	const real one = third * 3;
+	result &= one.shadow() == 1 && one != 1 && one < 1 && static_cast<double>(one) == 1 - std::ldexp(1.0, -16);
+
+	// the error builds up along the pipeline
+	real y = 1;
+	for(int i = 0; i < 40; ++i){
+		y = y * real(1.1) - real(0.05);
+	}
+	const long double exact = std::pow(1.1L, 40) * (1 - 0.5L) + 0.5L;
+	result &= std::fabs(y.shadow() - exact) < 1e-12L;
+	result &= std::fabs(y.error()) > std::ldexp(1.0L, -16) * 40;
+
+	real z = real(2.5) + fix32<16>(0.25);
+	z *= 4;
+	z -= 1;
+	z /= real(0.5);
+	result &= z == 20 && z.shadow() == 20;
+	return result;
+}
+
+bool test_sites(){
+	bool result = true;
+	using real = fix_shadow<fix32<16>>;
+
+	for(int i = 0; i < 100; ++i){
+		const real x = real::value_type::reinterpret(i * 1000);
+		fixpoint_track_error("test_sites.exact", x * 2);
+		fixpoint_track_error("test_sites.lerp", lerp(x, real(3), real(0.3)));
+	}
+
+	const site_report exact = find_site("test_sites.exact");
+	result &= exact.count == 100 && exact.max_abs_error == 0 && exact.width == 32 && exact.fractional_bits == 16;
+
+	const site_report rounded = find_site("test_sites.lerp");
+	result &= rounded.count == 100 && rounded.max_abs_error > 0 && rounded.mean_abs_error <= rounded.max_abs_error;
+	result &= rounded.max_ulp_error == rounded.max_abs_error * 65536 && rounded.max_ulp_error < 4;
+
+	// the tracked value is returned unchanged
+	const real v = fixpoint_track_error("test_sites.value", real(1) / 7);
+	result &= v.value() == fix32<16>(1) / 7 && v.shadow() == 1.0L / 7;
+	return result;
+}
+
+bool test_tiers(){
+	bool result = true;
+	using real = fix_shadow<fix32<24>>;
+
+	for(int i = -1000; i < 1000; ++i){
+		const real x = real::value_type::reinterpret(i * 65536);	// i / 256
+		fixpoint_track_error("exp2.fast", fixmath::fast::exp2(x));
+		fixpoint_track_error("exp2.precise", fixmath::precise::exp2(x));
+		fixpoint_track_error("exp2", exp2(x));
+		fixpoint_track_error("tanh", tanh(x));
+	}
+	const site_report fast = find_site("exp2.fast");
+	const site_report precise = find_site("exp2.precise");
+	const site_report balanced = find_site("exp2");
+	result &= fast.count == 2000 && precise.count == 2000 && balanced.count == 2000;
+	result &= precise.max_ulp_error < balanced.max_ulp_error && balanced.max_ulp_error < fast.max_ulp_error;
+	result &= precise.max_ulp_error < 16 && fast.max_abs_error < 0.05;
+	result &= find_site("tanh").max_abs_error < 1e-5;
+
+	// a second tier of the same shadow, the input of log2 is already off by a fraction of an ulp
+	const real a = real(3) / 7;
+	const real l = fixmath::precise::log2(a);
+	result &= std::fabs(l.shadow() - std::log2(3.0L / 7)) < 1e-15L && std::fabs(l.error()) < 1e-6L;
+
+	// the report lists every site
+	const std::string table = [](){std::ostringstream s; fixpoint_error_tracker::report(s); return s.str();}();
+	result &= table.find("exp2.precise") != std::string::npos && table.find("fix32<24>") != std::string::npos;
+	return result;
+}
+
+int main(){
+	fixpoint_error_tracker::set_report_stream(nullptr);
+	TEST_CASE(test_operators);
+	TEST_CASE(test_sites);
+	TEST_CASE(test_tiers);
+	return 0;
+}
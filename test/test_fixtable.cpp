@@ -0,0 +1,492 @@
+/*
+	Author: Tobias Wallner
+	tobias.wallner1@gmx.net
+	
+*/
+
+
+#include <iostream>
+#include <sstream>
+#include <cmath>
+#include <algorithm>
+#include "fixtable.hpp"
+
+#define TEST_CASE(function)										\
+	if(function()){ 											\
+		std::cout << "[  Ok  ] - " << #function << std::endl;	\
+	}else{ 														\
+		std::cout << "[Failed] - " << #function << std::endl;	\
+	}
+
+template<size_t N> double to_double(fix32<N> f){return std::ldexp(static_cast<double>(f.reinterpret_as_int32()), -static_cast<int>(N));}
+template<size_t N> double to_double(fix64<N> f){return std::ldexp(static_cast<double>(f.reinterpret_as_int64()), -static_cast<int>(N));}
+
+// ------------- uniform_lut -------------
+
+bool test32_uniform_lut(){
+	// y = x^2 at x = -2, -1.5, ..., 2
+	const fix32<16> y[9] = {4, fix32<16>(2.25f), 1, fix32<16>(0.25f), 0, fix32<16>(0.25f), 1, fix32<16>(2.25f), 4};
+	const uniform_lut<fix32<16>, 9> lut(-2, -1, y);
+	
+	bool result = true;
+	result &= lut.x_first() == -2 && lut.x_last() == 2 && lut.step() == fix32<16>(0.5f);
+	result &= lut(fix32<16>(-2)) == 4;
+	result &= lut(fix32<16>(0.25f)) == fix32<16>(0.125f);
+	result &= lut(fix32<16>(-1.75f)) == fix32<16>(3.125f);
+	result &= lut(fix32<16>(2)) == 4;
+	
+	// extrapolation with the first and last segment
+	result &= lut(fix32<16>(3)) == fix32<16>(7.5f);
+	result &= lut(fix32<16>(-3)) == fix32<16>(7.5f);
+	
+	// equivalent to the search based lerp inside of the table
+	fix32<16> xs[9];
+	fix32<16> ys[9];
+	for(int i = 0; i < 9; ++i) xs[i] = lut.x_first() + lut.step() * i;
+	for(int i = 0; i < 9; ++i) ys[i] = y[i];
+	for(int i = -300; i < 300; ++i){
+		const fix32<16> x = fix32<16>::reinterpret(i * 433);
+		result &= std::abs(to_double(lut(x)) - to_double(lerp(xs, xs+9, ys, ys+9, x))) < 1e-4;
+	}
+	
+	// batch
+	fix32<16> out[9];
+	result &= lut.eval(xs, xs+9, out) == out+9;
+	for(int i = 0; i < 9; ++i) result &= out[i] == y[i];
+	
+	return result;
+}
+
+bool test64_uniform_lut(){
+	const fix64<40> y[5] = {10, -10, 20, 0, 5};
+	const uniform_lut<fix64<40>, 5> lut(1, 2, y); // x = 1, 5, 9, 13, 17
+	
+	bool result = true;
+	result &= lut(fix64<40>(1)) == 10;
+	result &= lut(fix64<40>(3)) == 0;
+	result &= lut(fix64<40>(12)) == 5;
+	result &= lut(fix64<40>(21)) == 10;
+	result &= lut(fix64<40>(-3)) == 30;
+
+	// a table across most of the range, x - x_first does not fit into int64
+	const fix64<40> y_wide[4] = {0, 1, 2, 3};
+	const uniform_lut<fix64<40>, 4> wide(-8000000, 22, y_wide);
+	result &= std::abs(to_double(wide(fix64<40>(4000000))) - 12000000.0 / 4194304) < 1e-9;
+	result &= std::abs(to_double(wide(fix64<40>(8000000))) - 16000000.0 / 4194304) < 1e-9;
+	result &= std::abs(to_double(wide(fix64<40>(-8388608))) + 388608.0 / 4194304) < 1e-9;
+	return result;
+}
+
+// ------------- pwl_table -------------
+
+bool test32_pwl_table(){
+	// nonuniform breakpoints of y = x^2
+	fix32<16> x[6] = {-2, -1, 0, fix32<16>(0.5f), 3, 10};
+	fix32<16> y[6];
+	for(int i = 0; i < 6; ++i) y[i] = x[i] * x[i];
+	const pwl_table<fix32<16>, 6> table(x, y);
+
+	bool result = true;
+	result &= table.x_first() == -2 && table.x_last() == 10;
+	for(int i = 0; i < 6; ++i) result &= table(x[i]) == y[i];
+	result &= table(fix32<16>(-1.5f)) == fix32<16>(2.5f);
+	result &= table(fix32<16>(6.5f)) == fix32<16>(54.5f);
+	result &= table(fix32<16>(-3)) == 7;
+	result &= table(fix32<16>(11)) == 113;
+
+	// segment search
+	result &= table.segment(fix32<16>(-5)) == 0;
+	result &= table.segment(fix32<16>(0)) == 2;
+	result &= table.segment(fix32<16>(0.25f)) == 2;
+	result &= table.segment(fix32<16>(10)) == 4;
+	result &= table.segment(fix32<16>(100)) == 4;
+
+	// equivalent to the search based lerp, with and without a hint
+	auto c = table.make_cursor();
+	size_t hint = 4;
+	for(int i = -1000; i < 1000; ++i){
+		// jumps around to exercise the outward search in both directions
+		const fix32<16> q = fix32<16>::reinterpret(((i * 7919) % 1000) * 900);
+		const fix32<16> expected = lerp(x, x+6, y, y+6, q);
+		result &= std::abs(to_double(table(q)) - to_double(expected)) < 1e-3;
+		result &= table.eval(q, hint) == table(q);
+		result &= hint == table.segment(q);
+		result &= c(q) == table(q);
+		result &= c.segment() == table.segment(q);
+	}
+
+	// sorted batch
+	fix32<16> qs[100];
+	fix32<16> out[100];
+	for(int i = 0; i < 100; ++i) qs[i] = fix32<16>(-4) + fix32<16>(0.16f) * i;
+	result &= table.eval_sorted(qs, qs+100, out) == out+100;
+	for(int i = 0; i < 100; ++i) result &= out[i] == table(qs[i]);
+
+	return result;
+}
+
+bool test64_pwl_table(){
+	const fix64<40> x[4] = {-100, 0, 1, 1000};
+	const fix64<40> y[4] = {0, 50, -50, 949};
+	const pwl_table<fix64<40>, 4> table(x, y);
+
+	bool result = true;
+	result &= table(fix64<40>(-50)) == 25;
+	result &= table(fix64<40>(0.25)) == 25;
+	result &= table(fix64<40>(500)) == 449;
+	result &= table(fix64<40>(-200)) == -50;
+
+	size_t hint = 0;
+	result &= table.eval(fix64<40>(999), hint) == 948 && hint == 2;
+	result &= table.eval(fix64<40>(-99), hint) == fix64<40>(0.5) && hint == 0;
+	return result;
+}
+
+bool test64_pwl_table_slopes(){
+	bool result = true;
+
+	// few fractional bits and a small slope
+	const fix64<16> x16[3] = {0, 1000000, 2000000};
+	const fix64<16> y16[3] = {0, 1, 2};
+	const pwl_table<fix64<16>, 3> gentle(x16, y16);
+	result &= gentle(fix64<16>(500000)) == fix64<16>(0.5);
+	result &= gentle(fix64<16>(1500000)) == fix64<16>(1.5);
+	result &= gentle(fix64<16>(3000000)) == 3;
+
+	// many fractional bits and a steep segment next to a flat one
+	const fix64<40> x40[3] = {fix64<40>(0), fix64<40>::reinterpret(1LL << 20), fix64<40>(1)};
+	const fix64<40> y40[3] = {0, 1000, 1000};
+	const pwl_table<fix64<40>, 3> steep(x40, y40);
+	result &= steep(fix64<40>::reinterpret(1LL << 19)) == 500;
+	result &= steep(fix64<40>::reinterpret(3LL << 18)) == 750;
+	result &= steep(fix64<40>(0.5)) == 1000;
+	result &= steep(fix64<40>::reinterpret(-(1LL << 20))) == -1000;
+
+	// a steep segment does not round the slope of a gentle segment to 0
+	const fix64<32> xs[3] = {fix64<32>(0), fix64<32>(1000), fix64<32>::reinterpret((1000LL << 32) + 1)};
+	const fix64<32> ys[3] = {0, 1, 1 + (1 << 20)};
+	const pwl_table<fix64<32>, 3> mixed(xs, ys);
+	result &= mixed(fix64<32>(500)) == fix64<32>(0.5);
+	result &= mixed(fix64<32>(250)) == fix64<32>(0.25);
+	result &= mixed(xs[2]) == ys[2];
+	return result;
+}
+
+// ------------- eytzinger_pwl_table -------------
+
+bool test32_eytzinger_pwl_table(){
+	bool result = true;
+
+	// all tree shapes from 2 to 40 breakpoints, against the search based lerp
+	for(int n = 2; n <= 40; ++n){
+		fix32<16> x[40];
+		fix32<16> y[40];
+		for(int i = 0; i < n; ++i){
+			x[i] = fix32<16>::reinterpret(i * i * 5000 - 100000);
+			y[i] = fix32<16>::reinterpret((i * 7919) % 1000 * 300);
+		}
+		const eytzinger_pwl_table<fix32<16>> table(x, x+n, y);
+		result &= table.size() == static_cast<size_t>(n);
+		for(int i = 0; i < n; ++i) result &= table(x[i]) == y[i];
+		for(int q = -200000; q < 8000000; q += 1013){
+			const fix32<16> xq = fix32<16>::reinterpret(q);
+			result &= std::abs(to_double(table(xq)) - to_double(lerp(x, x+n, y, y+n, xq))) < 1e-3;
+		}
+	}
+
+	// batch
+	const fix32<16> x[3] = {0, 1, 2};
+	const fix32<16> y[3] = {0, 10, 0};
+	const eytzinger_pwl_table<fix32<16>> table(x, x+3, y);
+	const fix32<16> qs[4] = {-1, fix32<16>(0.5f), fix32<16>(1.5f), 3};
+	fix32<16> out[4];
+	result &= table.eval(qs, qs+4, out) == out+4;
+	result &= out[0] == -10 && out[1] == 5 && out[2] == 5 && out[3] == -10;
+	return result;
+}
+
+bool test64_eytzinger_pwl_table(){
+	const fix64<40> x[5] = {-100, 0, 1, 1000, 2000};
+	const fix64<40> y[5] = {0, 50, -50, 949, 949};
+	const eytzinger_pwl_table<fix64<40>> table(x, x+5, y);
+
+	bool result = true;
+	result &= table(fix64<40>(-50)) == 25;
+	result &= table(fix64<40>(0.25)) == 25;
+	result &= table(fix64<40>(500)) == 449;
+	result &= table(fix64<40>(-200)) == -50;
+	result &= table(fix64<40>(1500)) == 949;
+	result &= table(fix64<40>(3000)) == 949;
+	return result;
+}
+
+bool test64_eytzinger_pwl_table_slopes(){
+	bool result = true;
+
+	const fix64<16> x16[3] = {0, 1000000, 2000000};
+	const fix64<16> y16[3] = {0, 1, 2};
+	const eytzinger_pwl_table<fix64<16>> gentle(x16, x16+3, y16);
+	result &= gentle(fix64<16>(500000)) == fix64<16>(0.5);
+	result &= gentle(fix64<16>(1500000)) == fix64<16>(1.5);
+
+	const fix64<40> x40[3] = {fix64<40>(0), fix64<40>::reinterpret(1LL << 20), fix64<40>(1)};
+	const fix64<40> y40[3] = {0, 1000, 1000};
+	const eytzinger_pwl_table<fix64<40>> steep(x40, x40+3, y40);
+	result &= steep(fix64<40>::reinterpret(1LL << 19)) == 500;
+	result &= steep(fix64<40>::reinterpret(3LL << 18)) == 750;
+	result &= steep(fix64<40>(0.5)) == 1000;
+
+	const fix64<32> xs[3] = {fix64<32>(0), fix64<32>(1000), fix64<32>::reinterpret((1000LL << 32) + 1)};
+	const fix64<32> ys[3] = {0, 1, 1 + (1 << 20)};
+	const eytzinger_pwl_table<fix64<32>> mixed(xs, xs+3, ys);
+	result &= mixed(fix64<32>(500)) == fix64<32>(0.5);
+	result &= mixed(fix64<32>(250)) == fix64<32>(0.25);
+	result &= mixed(xs[2]) == ys[2];
+	return result;
+}
+
+// ------------- spline_table -------------
+
+bool test32_spline_table(){
+	bool result = true;
+	const spline_kind kinds[3] = {spline_kind::natural, spline_kind::monotone, spline_kind::catmull_rom};
+
+	// every kind goes through the breakpoints and reproduces a line
+	fix32<16> x[5] = {-3, -1, fix32<16>(0.5f), 2, 7};
+	fix32<16> y[5];
+	for(int i = 0; i < 5; ++i) y[i] = x[i] * 3 - 2;
+	for(spline_kind kind : kinds){
+		const spline_table<fix32<16>, 5> table(x, y, kind);
+		for(int i = 0; i < 5; ++i) result &= table(x[i]) == y[i];
+		for(int q = -3 * 65536; q < 7 * 65536; q += 977){
+			const fix32<16> xq = fix32<16>::reinterpret(q);
+			result &= std::abs(to_double(table(xq)) - (3 * to_double(xq) - 2)) < 1e-4;
+		}
+		// clamped outside of the breakpoints
+		result &= table(fix32<16>(-10)) == y[0] && table(fix32<16>(10)) == y[4];
+	}
+
+	// the natural spline matches sin(x) on [0, pi], whose second derivative is zero at both ends
+	const double pi = 3.14159265358979323846;
+	fix32<20> xs[9];
+	fix32<20> ys[9];
+	for(int i = 0; i < 9; ++i){
+		xs[i] = fix32<20>(static_cast<float>(pi * i / 8));
+		ys[i] = fix32<20>(static_cast<float>(std::sin(to_double(xs[i]))));
+	}
+	const spline_table<fix32<20>, 9> sin_table(xs, ys, spline_kind::natural);
+	for(int i = 0; i <= 1000; ++i){
+		const fix32<20> xq = fix32<20>(static_cast<float>(pi * i / 1000));
+		result &= std::abs(to_double(sin_table(xq)) - std::sin(to_double(xq))) < 5e-4;
+	}
+
+	// monotone data stays monotone and does not overshoot
+	const fix32<16> xm[6] = {0, 1, 2, 3, 4, 5};
+	const fix32<16> ym[6] = {0, 0, 0, 1, 1, 1};
+	const spline_table<fix32<16>, 6> step(xm, ym, spline_kind::monotone);
+	fix32<16> previous = 0;
+	for(int q = 0; q <= 5 * 65536; q += 331){
+		const fix32<16> v = step(fix32<16>::reinterpret(q));
+		result &= previous <= v && v <= 1 && 0 <= v;
+		previous = v;
+	}
+	return result;
+}
+
+bool test32_uniform_spline_table(){
+	bool result = true;
+	const spline_kind kinds[3] = {spline_kind::natural, spline_kind::monotone, spline_kind::catmull_rom};
+
+	// y = x^2 at x = 0, 0.5, ..., 4
+	fix32<16> x[9];
+	fix32<16> y[9];
+	for(int i = 0; i < 9; ++i){
+		x[i] = fix32<16>(0.5f) * i;
+		y[i] = x[i] * x[i];
+	}
+	for(spline_kind kind : kinds){
+		const uniform_spline_table<fix32<16>, 9> uniform(0, -1, y, kind);
+		const spline_table<fix32<16>, 9> nonuniform(x, y, kind);
+		result &= uniform.x_first() == 0 && uniform.x_last() == 4 && uniform.step() == fix32<16>(0.5f);
+		for(int i = 0; i < 9; ++i) result &= uniform(x[i]) == y[i];
+		for(int q = -65536; q < 5 * 65536; q += 701){
+			const fix32<16> xq = fix32<16>::reinterpret(q);
+			const int64_t diff = uniform(xq).reinterpret_as_int32() - nonuniform(xq).reinterpret_as_int32();
+			result &= -1 <= diff && diff <= 1;
+		}
+	}
+
+	// catmull-rom reproduces the quadratic in the inner segments
+	const uniform_spline_table<fix32<16>, 9> quadratic(0, -1, y, spline_kind::catmull_rom);
+	for(int q = 65536 / 2; q < 7 * 65536 / 2; q += 101){
+		const fix32<16> xq = fix32<16>::reinterpret(q);
+		result &= std::abs(to_double(quadratic(xq)) - to_double(xq) * to_double(xq)) < 1e-4;
+	}
+
+	// batch
+	fix32<16> out[9];
+	result &= quadratic.eval(x, x+9, out) == out+9;
+	for(int i = 0; i < 9; ++i) result &= out[i] == y[i];
+	return result;
+}
+
+bool test64_spline_table(){
+	bool result = true;
+	const double pi = 3.14159265358979323846;
+	fix64<40> xs[17];
+	fix64<40> ys[17];
+	for(int i = 0; i < 17; ++i){
+		xs[i] = fix64<40>(pi * i / 16);
+		ys[i] = fix64<40>(std::sin(to_double(xs[i])));
+	}
+	const spline_table<fix64<40>, 17> table(xs, ys, spline_kind::natural);
+	for(int i = 0; i < 17; ++i) result &= table(xs[i]) == ys[i];
+	for(int i = 0; i <= 1000; ++i){
+		const fix64<40> xq = fix64<40>(pi * i / 1000);
+		result &= std::abs(to_double(table(xq)) - std::sin(to_double(xq))) < 5e-5;
+	}
+
+	const uniform_spline_table<fix64<40>, 5> line(-2, 0, {fix64<40>(-4), fix64<40>(-2), fix64<40>(0), fix64<40>(2), fix64<40>(4)}, spline_kind::catmull_rom);
+	result &= line(fix64<40>(0.25)) == fix64<40>(0.5);
+	result &= line(fix64<40>(-1.75)) == fix64<40>(-3.5);
+	result &= line(fix64<40>(5)) == 4;
+	return result;
+}
+
+// ------------- table2d -------------
+
+bool test32_table_axis(){
+	bool result = true;
+	const auto uniform = table_axis<fix32<16>>::uniform(-40, 10, 14);
+	result &= uniform.uniform() && uniform.size() == 14 && uniform[13] == 90;
+	int64_t u;
+	result &= uniform.locate(fix32<16>(-40), u) == 0 && u == 0;
+	result &= uniform.locate(fix32<16>(-35), u) == 0 && u == (static_cast<int64_t>(1) << 59);
+	result &= uniform.locate(fix32<16>(20), u) == 6 && u == 0;
+	result &= uniform.locate(fix32<16>(90), u) == 12 && u == (static_cast<int64_t>(1) << 60);
+	result &= uniform.locate(fix32<16>(1000), u) == 12 && u == (static_cast<int64_t>(1) << 60);
+	result &= uniform.locate(fix32<16>(-1000), u) == 0 && u == 0;
+
+	// the reciprocal estimate of a uniform axis finds the same segments as the search
+	const auto odd = table_axis<fix32<16>>::uniform(fix32<16>::reinterpret(-12345), fix32<16>::reinterpret(777), 100);
+	fix32<16> breakpoints[100];
+	for(size_t i = 0; i < 100; ++i) breakpoints[i] = odd[i];
+	const table_axis<fix32<16>> searched(breakpoints, breakpoints + 100);
+	result &= !searched.uniform();
+	for(int q = -20000; q < 70000; q += 7){
+		int64_t u0, u1;
+		result &= odd.locate(fix32<16>::reinterpret(q), u0) == searched.locate(fix32<16>::reinterpret(q), u1) && u0 == u1;
+	}
+	return result;
+}
+
+bool test32_table2d(){
+	bool result = true;
+	const fix32<16> px[5] = {fix32<16>(0.5f), 1, 2, 4, 8};
+	const auto temperature = table_axis<fix32<16>>::uniform(-40, 10, 14);
+	const table_axis<fix32<16>> pressure(px, px+5);
+
+	// z = 1 + x/8 - y/2 + x*y/32 is reproduced by bilinear interpolation
+	fix32<16> values[14 * 5];
+	for(size_t i = 0; i < 14; ++i){
+		for(size_t j = 0; j < 5; ++j){
+			const double x = to_double(temperature[i]);
+			const double y = to_double(pressure[j]);
+			values[i * 5 + j] = fix32<16>(static_cast<float>(1 + x / 8 - y / 2 + x * y / 32));
+		}
+	}
+	const table2d<fix32<16>> map(temperature, pressure, values);
+	for(size_t i = 0; i < 14; ++i){
+		for(size_t j = 0; j < 5; ++j){
+			result &= map.value(i, j) == values[i * 5 + j];
+			result &= map(temperature[i], pressure[j]) == values[i * 5 + j];
+			result &= map.bicubic(temperature[i], pressure[j]) == values[i * 5 + j];
+		}
+	}
+	for(int a = -40; a <= 90; a += 3){
+		for(int b = 0; b < 40; ++b){
+			const fix32<16> x = fix32<16>(a) + fix32<16>(0.25f);
+			const fix32<16> y = fix32<16>(0.5f) + fix32<16>(0.1875f) * b;
+			const double expected = 1 + to_double(x) / 8 - to_double(y) / 2 + to_double(x) * to_double(y) / 32;
+			result &= std::abs(to_double(map(x, y)) - expected) < 1e-4;
+		}
+	}
+
+	// bicubic follows a smooth surface closer than bilinear
+	fix32<16> smooth[14 * 5];
+	for(size_t i = 0; i < 14; ++i){
+		for(size_t j = 0; j < 5; ++j){
+			smooth[i * 5 + j] = fix32<16>(static_cast<float>(std::sin(to_double(temperature[i]) / 20) * std::cos(to_double(pressure[j]) / 4)));
+		}
+	}
+	const table2d<fix32<16>> smooth_map(temperature, pressure, smooth);
+	double error_bilinear = 0;
+	double error_bicubic = 0;
+	for(int a = -30; a <= 80; a += 3){
+		for(int b = 0; b < 30; ++b){
+			const fix32<16> x = fix32<16>(a) + fix32<16>(0.25f);
+			const fix32<16> y = fix32<16>(1) + fix32<16>(0.1875f) * b;
+			const double expected = std::sin(to_double(x) / 20) * std::cos(to_double(y) / 4);
+			error_bilinear = std::max(error_bilinear, std::abs(to_double(smooth_map(x, y)) - expected));
+			error_bicubic = std::max(error_bicubic, std::abs(to_double(smooth_map.bicubic(x, y)) - expected));
+		}
+	}
+	result &= error_bicubic < error_bilinear && error_bicubic < 0.01;
+
+	// clamped outside and batch
+	result &= map(fix32<16>(-100), fix32<16>(100)) == values[4];
+	const fix32<16> xs[3] = {-40, 0, 90};
+	const fix32<16> ys[3] = {8, 2, fix32<16>(0.5f)};
+	fix32<16> out[3];
+	result &= map.bilinear(xs, xs+3, ys, out) == out+3;
+	result &= out[0] == values[4] && out[1] == values[4 * 5 + 2] && out[2] == values[13 * 5];
+	result &= map.bicubic(xs, xs+3, ys, out) == out+3;
+	result &= out[0] == values[4] && out[1] == values[4 * 5 + 2] && out[2] == values[13 * 5];
+	return result;
+}
+
+bool test64_table2d(){
+	const auto x = table_axis<fix64<40>>::uniform(0, fix64<40>(0.1), 11);
+	const fix64<40> py[3] = {-1, 0, 3};
+	const table_axis<fix64<40>> y(py, py+3);
+	fix64<40> values[11 * 3];
+	for(size_t i = 0; i < 11; ++i){
+		for(size_t j = 0; j < 3; ++j){
+			values[i * 3 + j] = x[i] * 4 + py[j] * 2;
+		}
+	}
+	const table2d<fix64<40>> map(x, y, values);
+
+	bool result = true;
+	for(int a = 0; a <= 100; ++a){
+		const fix64<40> xq = fix64<40>(a / 100.0);
+		const fix64<40> yq = fix64<40>(a / 25.0 - 1);
+		const double expected = to_double(xq) * 4 + to_double(yq) * 2;
+		result &= std::abs(to_double(map(xq, yq)) - expected) < 1e-9;
+		result &= std::abs(to_double(map.bicubic(xq, yq)) - expected) < 1e-9;
+	}
+	return result;
+}
+
+int main(){
+	
+	std::cout << "fixtable tests:" << std::endl;
+	std::cout << "---------------" << std::endl;
+	
+	TEST_CASE(test32_uniform_lut);
+	TEST_CASE(test64_uniform_lut);
+	TEST_CASE(test32_pwl_table);
+	TEST_CASE(test64_pwl_table);
+	TEST_CASE(test64_pwl_table_slopes);
+	TEST_CASE(test32_eytzinger_pwl_table);
+	TEST_CASE(test64_eytzinger_pwl_table);
+	TEST_CASE(test64_eytzinger_pwl_table_slopes);
+	TEST_CASE(test32_spline_table);
+	TEST_CASE(test32_uniform_spline_table);
+	TEST_CASE(test64_spline_table);
+	TEST_CASE(test32_table_axis);
+	TEST_CASE(test32_table2d);
+	TEST_CASE(test64_table2d);
+	
+	return 0;
+}